@@ -196,6 +196,18 @@ window.loadNetworkConfig = function loadNetworkConfig() {
                 document.getElementById('dhcp').checked = data.dhcpEnabled || false;
                 document.getElementById('hostname').value = data.hostname || 'modbus-io-module';
                 document.getElementById('modbus_port').value = data.modbusPort || 502;
+                document.getElementById('modbus_max_clients').value = data.modbusMaxClients || 8;
+                document.getElementById('modbus_idle_timeout').value = data.modbusIdleTimeout ?? 120;
+                document.getElementById('modbus_packed_enabled').checked = data.modbusPackedEnabled || false;
+                document.getElementById('modbus_packed_base').value = data.modbusPackedBase || 100;
+                document.getElementById('modbus_rtu_enabled').checked = data.modbusRtuEnabled || false;
+                document.getElementById('modbus_rtu_unit_id').value = data.modbusRtuUnitId || 1;
+                document.getElementById('modbus_rtu_baud').value = data.modbusRtuBaud || 19200;
+                document.getElementById('modbus_rtu_framing').value = data.modbusRtuFraming || '8E1';
+                document.getElementById('modbus_rtu_pins').value = (data.modbusRtuTxPin ?? 12) + ',' + (data.modbusRtuRxPin ?? 13);
+                document.getElementById('modbus_rtu_de_pin').value = data.modbusRtuDePin ?? 22;
+                document.getElementById('modbus_rtu_role').value = data.modbusRtuGateway ? 'gateway' : 'server';
+                document.getElementById('event_interval').value = data.eventInterval || 250;
                 
                 showToast('Network configuration loaded', 'success');
             })
@@ -228,6 +240,18 @@ window.saveConfig = function saveConfig() {
     const subnetStr = document.getElementById('subnet').value;
     const gatewayStr = document.getElementById('gateway').value;
     const modbusPort = parseInt(document.getElementById('modbus_port').value);
+    const modbusMaxClients = parseInt(document.getElementById('modbus_max_clients').value);
+    const modbusIdleTimeout = parseInt(document.getElementById('modbus_idle_timeout').value);
+    const modbusPackedEnabled = document.getElementById('modbus_packed_enabled').checked;
+    const modbusPackedBase = parseInt(document.getElementById('modbus_packed_base').value);
+    const modbusRtuEnabled = document.getElementById('modbus_rtu_enabled').checked;
+    const modbusRtuUnitId = parseInt(document.getElementById('modbus_rtu_unit_id').value);
+    const modbusRtuBaud = parseInt(document.getElementById('modbus_rtu_baud').value);
+    const modbusRtuFraming = document.getElementById('modbus_rtu_framing').value;
+    const [modbusRtuTxPin, modbusRtuRxPin] = document.getElementById('modbus_rtu_pins').value.split(',').map(Number);
+    const modbusRtuDePin = parseInt(document.getElementById('modbus_rtu_de_pin').value);
+    const modbusRtuGateway = document.getElementById('modbus_rtu_role').value === 'gateway';
+    const eventInterval = parseInt(document.getElementById('event_interval').value);
     
     // Validate IP addresses
     const ip = parseIPString(ipStr);
@@ -254,6 +278,30 @@ window.saveConfig = function saveConfig() {
         showToast('Modbus port must be between 1 and 65535', 'error');
         return;
     }
+    if (isNaN(modbusMaxClients) || modbusMaxClients < 1 || modbusMaxClients > 16) {
+        showToast('Modbus connections must be between 1 and 16', 'error');
+        return;
+    }
+    if (isNaN(modbusIdleTimeout) || modbusIdleTimeout < 0 || modbusIdleTimeout > 65535) {
+        showToast('Modbus idle timeout must be between 0 and 65535 seconds', 'error');
+        return;
+    }
+    if (isNaN(modbusPackedBase) || modbusPackedBase < 32 || modbusPackedBase > 8000) {
+        showToast('Packed block start register must be between 32 and 8000', 'error');
+        return;
+    }
+    if (isNaN(modbusRtuUnitId) || modbusRtuUnitId < 1 || modbusRtuUnitId > 247) {
+        showToast('RTU unit ID must be between 1 and 247', 'error');
+        return;
+    }
+    if (isNaN(modbusRtuDePin) || modbusRtuDePin < -1 || modbusRtuDePin > 29) {
+        showToast('RS485 DE pin must be -1 or a GPIO number', 'error');
+        return;
+    }
+    if (isNaN(eventInterval) || eventInterval < 50 || eventInterval > 10000) {
+        showToast('Live update interval must be between 50 and 10000 ms', 'error');
+        return;
+    }
     
     // Prepare configuration object
     const config = {
@@ -262,7 +310,20 @@ window.saveConfig = function saveConfig() {
         ip: ip,
         subnet: subnet,
         gateway: gateway,
-        modbusPort: modbusPort
+        modbusPort: modbusPort,
+        modbusMaxClients: modbusMaxClients,
+        modbusIdleTimeout: modbusIdleTimeout,
+        modbusPackedEnabled: modbusPackedEnabled,
+        modbusPackedBase: modbusPackedBase,
+        modbusRtuEnabled: modbusRtuEnabled,
+        modbusRtuUnitId: modbusRtuUnitId,
+        modbusRtuBaud: modbusRtuBaud,
+        modbusRtuFraming: modbusRtuFraming,
+        modbusRtuTxPin: modbusRtuTxPin,
+        modbusRtuRxPin: modbusRtuRxPin,
+        modbusRtuDePin: modbusRtuDePin,
+        modbusRtuGateway: modbusRtuGateway,
+        eventInterval: eventInterval
     };
     
     // Send to device
@@ -812,6 +873,12 @@ window.updateSensorFormFields = function updateSensorFormFields() {
     const i2cAddressContainer = document.getElementById('sensor-i2c-address').parentElement;
     const i2cAddressField = document.getElementById('sensor-i2c-address');
     
+    // LIS3DH FIFO stream settings only apply to the I2C accelerometer
+    const lis3dhConfig = document.getElementById('lis3dh-config');
+    if (lis3dhConfig) {
+        lis3dhConfig.style.display = (protocol === 'I2C' && sensorType === 'LIS3DH') ? 'flex' : 'none';
+    }
+    
     // Hide I2C address field for non-I2C protocols
     if (protocol === 'I2C') {
         i2cAddressContainer.style.display = 'block';
@@ -864,7 +931,7 @@ window.updateRegisterRangeDisplay = function updateRegisterRangeDisplay() {
     }
     
     const baseRegister = parseInt(modbusRegField.value);
-    const registerCount = getRegisterCountForSensor(sensorType);
+    const registerCount = getRegisterCountForSensor(sensorType, getFormEncodings());
     
     if (registerCount > 1) {
         // Multi-output sensor: show the range
@@ -1276,17 +1343,39 @@ window.updateDataParsingFields = function updateDataParsingFields() {
     }
 }
 
+// Registers taken by one output in each Modbus encoding
+const REGISTER_ENCODING_WIDTHS = { int16: 1, uint16: 1, int32: 2, uint32: 2, float32: 2 };
+// Sensor registers must end inside the fixed input register window (MODBUS_INPUT_REGISTERS)
+const MODBUS_INPUT_REGISTERS = 32;
+
+// Encodings of outputs A/B/C of a saved sensor
+window.getSensorEncodings = function getSensorEncodings(sensor) {
+    return [sensor.modbusEncoding, sensor.modbusEncodingB, sensor.modbusEncodingC];
+};
+
+// Encodings of outputs A/B/C selected in the sensor form
+window.getFormEncodings = function getFormEncodings() {
+    return ['', '-b', '-c'].map(suffix => document.getElementById(`sensor-modbus-encoding${suffix}`)?.value || 'int16');
+};
+
 // Helper function to get the number of consecutive registers a sensor needs
-window.getRegisterCountForSensor = function getRegisterCountForSensor(sensorType) {
+window.getRegisterCountForSensor = function getRegisterCountForSensor(sensorType, encodings) {
     // Multi-output sensors that need consecutive registers
     const multiOutputSensors = {
-        'LIS3DH': 3,        // X, Y, Z axes (3 consecutive registers)
+        'LIS3DH': 12,       // X, Y, Z mean, then RMS, peak and crest factor per axis
         'LIS3DH_SPI': 3,    // X, Y, Z axes on SPI (3 consecutive registers)
         'SHT30': 2,         // Temperature, Humidity (2 consecutive registers)
-        'BME280': 3,        // Temperature, Humidity, Pressure (3 consecutive registers)
+        'BME280': 1,        // Only output A is mapped until humidity and pressure are decoded
         'BME680': 4         // Temperature, Humidity, Pressure, Gas resistance (4 consecutive registers)
     };
-    return multiOutputSensors[sensorType] || 1; // Default to 1 register for single-output sensors
+    let count = multiOutputSensors[sensorType] || 1; // Default to 1 register for single-output sensors
+    // 32-bit encodings of outputs A/B/C take a second register each
+    if (Array.isArray(encodings)) {
+        for (let i = 0; i < Math.min(count, 3); i++) {
+            count += (REGISTER_ENCODING_WIDTHS[encodings[i]] || 1) - 1;
+        }
+    }
+    return count;
 };
 
 // Helper function to get the next available modbus register
@@ -1297,7 +1386,7 @@ window.getNextAvailableRegister = function getNextAvailableRegister() {
     sensorConfigData.forEach(sensor => {
         if (sensor.modbusRegister !== undefined) {
             // Determine how many consecutive registers this sensor uses
-            const registerCount = getRegisterCountForSensor(sensor.type);
+            const registerCount = getRegisterCountForSensor(sensor.type, getSensorEncodings(sensor));
             
             // Mark all registers used by this sensor
             for (let i = 0; i < registerCount; i++) {
@@ -1354,6 +1443,8 @@ window.editSensor = function editSensor(index) {
             break;
         case 'UART':
             document.getElementById('sensor-uart-polling').value = sensor.pollingFrequency || 1000;
+            document.getElementById('sensor-uart-baud').value = sensor.uartBaud || 9600;
+            document.getElementById('sensor-uart-framing').value = sensor.uartFraming || '8N1';
             break;
         case 'One-Wire':
             document.getElementById('sensor-onewire-polling').value = sensor.pollingFrequency || 1000;
@@ -1377,12 +1468,19 @@ window.editSensor = function editSensor(index) {
     // Load pin assignments if they exist
     if (sensor.protocol === 'I2C' && sensor.sdaPin !== undefined && sensor.sclPin !== undefined) {
         document.getElementById('sensor-i2c-pins').value = `${sensor.sdaPin},${sensor.sclPin}`;
+        if (sensor.type === 'LIS3DH') {
+            document.getElementById('sensor-lis3dh-odr').value = (sensor.lis3dhOdr || 400).toString();
+            document.getElementById('sensor-lis3dh-range').value = (sensor.lis3dhRange || 2).toString();
+            document.getElementById('sensor-lis3dh-int-pin').value = sensor.lis3dhIntPin !== undefined ? sensor.lis3dhIntPin : -1;
+        }
     } else if (sensor.protocol === 'UART' && sensor.txPin !== undefined && sensor.rxPin !== undefined) {
         document.getElementById('sensor-uart-pins').value = `${sensor.txPin},${sensor.rxPin}`;
     } else if (sensor.protocol === 'Analog Voltage' && sensor.analogPin !== undefined) {
         document.getElementById('sensor-analog-pin').value = sensor.analogPin.toString();
     } else if (sensor.protocol === 'One-Wire' && sensor.oneWirePin !== undefined) {
         document.getElementById('sensor-onewire-pin').value = sensor.oneWirePin.toString();
+        document.getElementById('sensor-onewire-id').value = sensor.oneWireRom || '';
+        document.getElementById('sensor-onewire-resolution').value = (sensor.oneWireResolution || 12).toString();
         
         // Load One-Wire specific settings
         setTimeout(() => {
@@ -1454,6 +1552,13 @@ window.editSensor = function editSensor(index) {
     }
     document.getElementById('sensor-i2c-address').value = sensor.i2cAddress ? `0x${sensor.i2cAddress.toString(16).toUpperCase().padStart(2, '0')}` : '';
     document.getElementById('sensor-modbus-register').value = sensor.modbusRegister || '';
+    ['', 'B', 'C'].forEach(output => {
+        const suffix = output ? `-${output.toLowerCase()}` : '';
+        document.getElementById(`sensor-modbus-encoding${suffix}`).value = sensor[`modbusEncoding${output}`] || 'int16';
+        document.getElementById(`sensor-modbus-scale${suffix}`).value = sensor[`modbusScale${output}`] ?? 100;
+    });
+    document.getElementById('sensor-modbus-word-order').value = sensor.modbusWordSwap ? 'low' : 'high';
+    document.getElementById('sensor-modbus-byte-swap').checked = !!sensor.modbusByteSwap;
     
     // Mark register field as user-set since it's pre-filled with existing data
     const modbusRegField = document.getElementById('sensor-modbus-register');
@@ -1758,13 +1863,13 @@ window.saveSensor = function saveSensor() {
     
     // Check for modbus register conflicts (including multi-output sensors)
     // Determine how many consecutive registers this sensor type needs
-    const newSensorRegisterCount = getRegisterCountForSensor(type);
+    const newSensorRegisterCount = getRegisterCountForSensor(type, getFormEncodings());
     
     const conflictingSensor = sensorConfigData.find((sensor, index) => {
         if (index === editingSensorIndex) return false; // Skip self when editing
         
         // Determine how many consecutive registers the existing sensor uses
-        const existingSensorRegisterCount = getRegisterCountForSensor(sensor.type);
+        const existingSensorRegisterCount = getRegisterCountForSensor(sensor.type, getSensorEncodings(sensor));
         
         // Check if any of the new sensor's registers conflict with existing sensor's registers
         for (let i = 0; i < newSensorRegisterCount; i++) {
@@ -1787,6 +1892,12 @@ window.saveSensor = function saveSensor() {
         return false;
     });
     
+    // e.g. a LIS3DH at 20 fills 20-31 with 16-bit axes; a float32 axis would push its features past 31
+    if (modbusRegister + newSensorRegisterCount > MODBUS_INPUT_REGISTERS) {
+        showToast(`${type} needs ${newSensorRegisterCount} registers from ${modbusRegister}, past the last sensor register (${MODBUS_INPUT_REGISTERS - 1})`, 'error');
+        return;
+    }
+    
     if (conflictingSensor) {
         const newSensorInfo = type === 'LIS3DH' || type === 'LIS3DH_SPI' ? 
             `${type} (needs ${newSensorRegisterCount} consecutive registers starting at ${modbusRegister})` : 
@@ -1795,7 +1906,7 @@ window.saveSensor = function saveSensor() {
             type === 'BME280' ?
             `${type} (needs ${newSensorRegisterCount} consecutive registers starting at ${modbusRegister})` :
             `${type}`;
-        showToast(`Register conflict: ${newSensorInfo} conflicts with "${conflictingSensor.name}" (registers ${conflictingSensor.modbusRegister}-${conflictingSensor.modbusRegister + getRegisterCountForSensor(conflictingSensor.type) - 1})`, 'error');
+        showToast(`Register conflict: ${newSensorInfo} conflicts with "${conflictingSensor.name}" (registers ${conflictingSensor.modbusRegister}-${conflictingSensor.modbusRegister + getRegisterCountForSensor(conflictingSensor.type, getSensorEncodings(conflictingSensor)) - 1})`, 'error');
         return;
     }
     
@@ -1919,6 +2030,12 @@ window.saveSensor = function saveSensor() {
                 pinAssignments.sdaPin = sdaPin;
                 pinAssignments.sclPin = sclPin;
             }
+            if (type === 'LIS3DH') {
+                pinAssignments.lis3dhOdr = parseInt(document.getElementById('sensor-lis3dh-odr').value) || 400;
+                pinAssignments.lis3dhRange = parseInt(document.getElementById('sensor-lis3dh-range').value) || 2;
+                const intPin = parseInt(document.getElementById('sensor-lis3dh-int-pin').value);
+                pinAssignments.lis3dhIntPin = isNaN(intPin) ? -1 : intPin;
+            }
             break;
             
         case 'UART':
@@ -1928,6 +2045,8 @@ window.saveSensor = function saveSensor() {
                 pinAssignments.uartTxPin = txPin;
                 pinAssignments.uartRxPin = rxPin;
             }
+            pinAssignments.uartBaud = parseInt(document.getElementById('sensor-uart-baud').value) || 9600;
+            pinAssignments.uartFraming = document.getElementById('sensor-uart-framing').value || '8N1';
             break;
             
         case 'Analog Voltage':
@@ -1942,6 +2061,8 @@ window.saveSensor = function saveSensor() {
             if (oneWirePin) {
                 pinAssignments.oneWirePin = parseInt(oneWirePin);
             }
+            pinAssignments.oneWireRom = document.getElementById('sensor-onewire-id').value.trim();
+            pinAssignments.oneWireResolution = parseInt(document.getElementById('sensor-onewire-resolution').value) || 12;
             
             // Add One-Wire specific configuration
             const oneWireAuto = document.getElementById('sensor-onewire-auto').checked;
@@ -2104,6 +2225,16 @@ window.saveSensor = function saveSensor() {
         ...(sensorCommand && { command: sensorCommand })
     };
     
+    // Modbus register encoding per output
+    ['', 'B', 'C'].forEach(output => {
+        const suffix = output ? `-${output.toLowerCase()}` : '';
+        sensor[`modbusEncoding${output}`] = document.getElementById(`sensor-modbus-encoding${suffix}`).value;
+        const scale = parseFloat(document.getElementById(`sensor-modbus-scale${suffix}`).value);
+        sensor[`modbusScale${output}`] = isNaN(scale) ? 100 : scale;
+    });
+    sensor.modbusWordSwap = document.getElementById('sensor-modbus-word-order').value === 'low';
+    sensor.modbusByteSwap = document.getElementById('sensor-modbus-byte-swap').checked;
+    
     // Collect multi-output calibration data if multi-value is enabled
     if (document.getElementById('sensor-multi-value').checked) {
         const multiValueFields = document.querySelectorAll('.multi-value-item');
@@ -2584,6 +2715,78 @@ function createErrorDiv() {
     return div;
 }
 
+// Live updates pushed by the device over /events (Server-Sent Events).
+// Each event carries only what changed; a "reset" follows a sensor list reload.
+let eventSource = null;
+let liveSensors = new Map();
+let sensorRenderPending = false;
+
+function renderLiveSensors() {
+    sensorRenderPending = false;
+    const sensors = Array.from(liveSensors.keys()).sort((a, b) => a - b).map(i => liveSensors.get(i));
+    if (currentIOStatus) currentIOStatus.configured_sensors = sensors;
+    updateSensorDataFlow(sensors);
+}
+
+function updateLiveIOCells() {
+    if (!currentIOStatus) return;
+    for (let i = 0; i < 8; i++) {
+        const state = document.getElementById(`di-state-${i}`);
+        const latched = document.getElementById(`di-latched-${i}`);
+        if (state && currentIOStatus.dIn) state.textContent = currentIOStatus.dIn[i] ? 'HIGH' : 'LOW';
+        if (latched && currentIOStatus.dInLatched) latched.textContent = currentIOStatus.dInLatched[i] ? 'Latched' : '-';
+    }
+}
+
+function connectEventStream() {
+    if (eventSource) eventSource.close();
+    eventSource = new EventSource('/events');
+    
+    eventSource.onopen = function() {
+        const errorDiv = document.getElementById('connection-error');
+        if (errorDiv) {
+            errorDiv.style.display = 'none';
+        }
+    };
+    
+    eventSource.addEventListener('reset', function() {
+        liveSensors.clear();
+        renderLiveSensors();
+    });
+    
+    eventSource.addEventListener('io', function(e) {
+        currentIOStatus = Object.assign(currentIOStatus || {}, JSON.parse(e.data));
+        updateLiveIOCells();
+    });
+    
+    eventSource.addEventListener('sensor', function(e) {
+        // The first event after a reset is the whole entry, later ones only the readings
+        const sensor = JSON.parse(e.data);
+        liveSensors.set(sensor.index, Object.assign(liveSensors.get(sensor.index) || {}, sensor));
+        if (!sensorRenderPending) {
+            sensorRenderPending = true;
+            requestAnimationFrame(renderLiveSensors);
+        }
+    });
+    
+    eventSource.addEventListener('log', function(e) {
+        if (isWatching) addTerminalOutput(JSON.parse(e.data), 'bus-traffic');
+    });
+    
+    eventSource.onerror = function() {
+        const errorDiv = document.getElementById('connection-error') || createErrorDiv();
+        errorDiv.textContent = 'Connection lost - will keep retrying...';
+        errorDiv.style.display = 'block';
+        
+        // The browser reconnects by itself unless the device refused the stream
+        // (e.g. all event stream slots in use): poll once and try again later
+        if (eventSource.readyState === EventSource.CLOSED) {
+            updateIOStatus();
+            setTimeout(connectEventStream, 5000);
+        }
+    };
+}
+
 // Function to update sensor dataflow display
 function updateSensorDataFlow(sensors) {
     // Clear all sensor flow containers
@@ -2921,7 +3124,10 @@ window.saveSensorConfig = function saveSensorConfig() {
     })
     .then(response => {
         if (!response.ok) {
-            throw new Error('Network response was not ok');
+            // A rejected config (e.g. a register conflict) carries the reason in "error"
+            return response.json().catch(() => ({})).then(data => {
+                throw new Error(data.error || 'Network response was not ok');
+            });
         }
         return response.json();
     })
@@ -3070,9 +3276,7 @@ window.sendEzoCalibrationCommandWithValue = function sendEzoCalibrationCommandWi
 
 // ==================== TERMINAL FUNCTIONALITY ====================
 
-let watchInterval = null;
 let isWatching = false;
-let displayedLogs = new Set(); // Track displayed terminal logs to avoid duplicates
 
 // Update the terminal interface based on selected protocol
 window.updateTerminalInterface = function updateTerminalInterface() {
@@ -3352,7 +3556,6 @@ function toggleWatch() {
         .then(response => response.json())
         .then(data => {
             if (data.status === 'stopped') {
-                clearInterval(watchInterval);
                 isWatching = false;
                 watchBtn.textContent = 'Start Watch';
                 watchBtn.classList.remove('watching');
@@ -3389,30 +3592,7 @@ function toggleWatch() {
                 watchStatus.classList.add('watching');
                 addTerminalOutput(`Started watching ${protocol} on pin ${pin}`, 'success');
                 
-                // Start polling for terminal logs
-                watchInterval = setInterval(() => {
-                    fetch('/terminal/logs')
-                    .then(response => response.json())
-                    .then(logs => {
-                        // Show new logs that weren't displayed yet
-                        logs.slice(-10).forEach(log => {
-                            if (!displayedLogs.has(log)) {
-                                addTerminalOutput(log, 'bus-traffic');
-                                displayedLogs.add(log);
-                            }
-                        });
-                        
-                        // Keep only recent logs in memory to prevent memory leak
-                        if (displayedLogs.size > 100) {
-                            const logsArray = Array.from(displayedLogs);
-                            displayedLogs.clear();
-                            logsArray.slice(-50).forEach(log => displayedLogs.add(log));
-                        }
-                    })
-                    .catch(error => {
-                        console.error('Watch polling error:', error);
-                    });
-                }, 500); // Poll every 500ms for real-time feel
+                // New log lines arrive over the /events stream
             } else {
                 addTerminalOutput('Failed to start watch mode', 'error');
             }
@@ -3862,8 +4042,8 @@ window.renderIOConfigTable = function renderIOConfigTable(ioConfig) {
         html += `
             <tr>
                 <td>DI${i}</td>
-                <td>${ioConfig.diState[i] ? 'HIGH' : 'LOW'}</td>
-                <td>${ioConfig.diLatched[i] ? 'Latched' : '-'}</td>
+                <td id="di-state-${i}">${ioConfig.diState[i] ? 'HIGH' : 'LOW'}</td>
+                <td id="di-latched-${i}">${ioConfig.diLatched[i] ? 'Latched' : '-'}</td>
                 <td>
                     <input type="checkbox" ${ioConfig.diPullup[i] ? 'checked' : ''} onchange="togglePullup(${i}, this.checked)">
                 </td>
@@ -3965,12 +4145,10 @@ document.addEventListener('DOMContentLoaded', function() {
         });
     }
     
-    // Set up a single periodic update for IO status and sensor dataflow
-    setInterval(function() {
-        updateIOStatus(); // Update all IO status every 2 seconds
-    }, 2000);
+    // IO status, sensor readings and terminal traffic are pushed from here on
+    connectEventStream();
     
-    console.log('Periodic updates initialized');
+    console.log('Live updates initialized');
 });
 
 // Toggle multi-value configuration visibility
@@ -9,57 +9,127 @@
 #include <ArduinoModbus.h>
 #include <ArduinoJson.h>
 #include <LittleFS.h>
+#include <pico/mutex.h>
+#include <hardware/pio.h>
+#include <hardware/dma.h>
+#include <hardware/clocks.h>
+#include <hardware/gpio.h>
+#include <hardware/uart.h>
+#include <hardware/irq.h>
+#include <hardware/sync.h>
+#include <pico/time.h>
 
 #define MAX_SENSORS 10
 
-// Forward declarations
+// Bus a sensor is polled on, resolved once from its protocol string when the
+// schedule is built so the polling path never compares strings
+enum class SensorBus : uint8_t {
+    NONE,
+    I2C,
+    UART,
+    ONEWIRE
+};
+
+// Scheduled poll for one sensor
 struct SensorCommand {
     uint8_t sensorIndex;
-    uint32_t nextExecutionMs;
+    SensorBus bus;
+    uint32_t nextExecutionMs;   // Absolute due time (millis), wrap-safe comparisons only
     uint32_t intervalMs;
-    const char* command;
-    bool isGeneric;
+    uint32_t conversionMs;      // Conversion/settle time handed to the bus operation
 };
 
-// Simple command array handler
-struct CommandArray {
-    SensorCommand commands[MAX_SENSORS];
+// Deadline scheduler: binary min-heap of sensor commands keyed on nextExecutionMs.
+// peek() is O(1); reschedule/add are O(log n), so polling cost stays flat as
+// MAX_SENSORS grows.
+struct SensorScheduler {
+    SensorCommand heap[MAX_SENSORS];
     uint8_t count;
-    
-    void init() {
-        count = 0;
+
+    // millis() wraps every ~49 days; compare deadlines by signed difference
+    static bool dueBefore(uint32_t a, uint32_t b) {
+        return (int32_t)(a - b) < 0;
     }
-    
-    bool add(const SensorCommand& cmd) {
-        if (count < MAX_SENSORS) {
-            commands[count++] = cmd;
-            return true;
-        }
-        return false;
+
+    void clear() {
+        count = 0;
     }
-    
+
     bool isEmpty() const {
         return count == 0;
     }
-    
-    SensorCommand* getNext() {
-        return isEmpty() ? nullptr : &commands[0];
+
+    bool add(const SensorCommand& cmd) {
+        if (count >= MAX_SENSORS) return false;
+        uint8_t i = count++;
+        heap[i] = cmd;
+        siftUp(i);
+        return true;
     }
-    
-    void remove() {
-        if (!isEmpty()) {
-            for (uint8_t i = 0; i < count - 1; i++) {
-                commands[i] = commands[i + 1];
-            }
-            count--;
+
+    SensorCommand* peek() {
+        return isEmpty() ? nullptr : &heap[0];
+    }
+
+    // Advance the earliest command to its next slot. The deadline moves in whole
+    // intervals from the previous deadline rather than from "now", so processing
+    // latency never accumulates as drift; slots missed while the bus was busy are
+    // skipped instead of being replayed back-to-back.
+    void rescheduleTop(uint32_t now) {
+        if (isEmpty()) return;
+        SensorCommand& top = heap[0];
+        uint32_t interval = top.intervalMs > 0 ? top.intervalMs : 1;
+        top.nextExecutionMs += interval;
+        if (dueBefore(top.nextExecutionMs, now)) {
+            uint32_t missed = (now - top.nextExecutionMs) / interval + 1;
+            top.nextExecutionMs += missed * interval;
         }
+        siftDown(0);
     }
-    
-    void clear() {
-        count = 0;
+
+    void siftUp(uint8_t i) {
+        while (i > 0) {
+            uint8_t parent = (i - 1) / 2;
+            if (!dueBefore(heap[i].nextExecutionMs, heap[parent].nextExecutionMs)) break;
+            SensorCommand tmp = heap[i];
+            heap[i] = heap[parent];
+            heap[parent] = tmp;
+            i = parent;
+        }
+    }
+
+    void siftDown(uint8_t i) {
+        while (true) {
+            uint8_t left = 2 * i + 1;
+            uint8_t right = left + 1;
+            uint8_t smallest = i;
+            if (left < count && dueBefore(heap[left].nextExecutionMs, heap[smallest].nextExecutionMs)) smallest = left;
+            if (right < count && dueBefore(heap[right].nextExecutionMs, heap[smallest].nextExecutionMs)) smallest = right;
+            if (smallest == i) break;
+            SensorCommand tmp = heap[i];
+            heap[i] = heap[smallest];
+            heap[smallest] = tmp;
+            i = smallest;
+        }
     }
 };
 
+// UART sensor engine
+#define UART_RX_FIFO_SIZE 256          // Software RX ring filled by the UART interrupt handler
+#define UART_RESPONSE_TIMEOUT_MS 1000  // Max wait for a terminated response line
+#define EZO_POLL_INTERVAL_MS 50        // Re-check a probe whose status byte says 254 (still processing)
+#define EZO_RESPONSE_TIMEOUT_MS 2000   // Give up on a probe that never finishes processing
+#define LIS3DH_FIFO_WATERMARK 16       // Samples in the 32-level FIFO before INT1 fires
+#define LIS3DH_FIFO_POLL_MS 10         // FIFO status check interval without an INT1 pin
+#define LIS3DH_FEATURE_REGISTERS 9     // RMS, peak, crest factor for each axis
+
+// One-Wire (PIO) engine
+#define MAX_ONEWIRE_BUSES 4            // Distinct One-Wire pins (one PIO state machine + 2 DMA channels each)
+#define ONEWIRE_MAX_TRANSFER 24        // Bytes per reset-delimited transaction (Match ROM + scratchpad read = 19)
+#define MAX_ONEWIRE_DEVICES 24         // ROM IDs remembered per One-Wire pin
+#define DS18B20_EEPROM_WRITE_MS 10     // Copy Scratchpad needs the bus held idle this long
+#define ONEWIRE_TRANSFER_TIMEOUT_MS 50 // Abort a hung transaction (normal scratchpad read is ~8ms)
+
 // Watchdog timer
 #define WDT_TIMEOUT 5000
 
@@ -75,21 +145,79 @@ struct CommandArray {
 // Default I2C Pin Definitions (GP4/GP5 are safest for W5500-EVB-PoE-Pico)
 #define I2C_SDA_PIN 4
 #define I2C_SCL_PIN 5
+#define I2C_BUS_CLOCK_HZ 100000    // Standard mode for every sensor on the bus
+#define I2C_BURST_CLOCK_HZ 400000  // LIS3DH FIFO burst reads, then back to I2C_BUS_CLOCK_HZ
 
 // Constants
 #define CONFIG_FILE "/config.json"
 #define SENSORS_FILE "/sensors.json"
+#define GATEWAY_FILE "/gateway.json"
 #define CONFIG_VERSION 7  // Increment this when config structure changes
 #define HOSTNAME_MAX_LENGTH 32
-#define MAX_MODBUS_CLIENTS 4  // Maximum number of concurrent Modbus clients
+#define MAX_MODBUS_CLIENTS 16  // Connection pool ceiling; config.modbusMaxClients sets the active size
+#define MODBUS_DEFAULT_CLIENTS 8
+#define MODBUS_DEFAULT_IDLE_TIMEOUT 120  // Seconds without a request before a connection is closed (0 = never)
+#define MODBUS_EVICT_MIN_IDLE_MS 2000    // A new client only evicts a connection idle at least this long
+#define MODBUS_KEEPALIVE_IDLE_S 30       // TCP keepalive: first probe after 30s idle,
+#define MODBUS_KEEPALIVE_INTERVAL_S 10   // then every 10s,
+#define MODBUS_KEEPALIVE_COUNT 3         // dropped by lwIP after 3 unanswered probes
+#define MODBUS_LATENCY_BUCKETS 10        // Receive-to-reply histogram, bounds in MODBUS_LATENCY_BOUNDS_US
+#define MODBUS_STAT_FUNCTIONS 10         // FC 1, 2, 3, 4, 5, 6, 8, 15, 16 + other
+#define MODBUS_DIAG_BASE 500             // Reserved input register block with request statistics
+#define MODBUS_DIAG_REGISTERS 32
+#define MODBUS_RTU_DEFAULT_UNIT_ID 1
+#define MODBUS_RTU_DEFAULT_BAUD 19200
+#define MODBUS_RTU_DEFAULT_FRAMING "8E1"  // Modbus serial line default (even parity)
+#define MODBUS_RTU_DEFAULT_TX_PIN 12     // UART0 on GP12/GP13 (DO5/DO6): every header UART pair is shared, and
+#define MODBUS_RTU_DEFAULT_RX_PIN 13     // taking two outputs is harmless; GP24/25 are VBUS sense and the LED
+#define MODBUS_RTU_DEFAULT_DE_PIN 22     // RS485 driver enable (DE and /RE tied), -1 = auto-direction transceiver
+#define MODBUS_RTU_T35_FIXED_US 1750     // Fixed t3.5 above 19200 baud (Modbus serial line spec 2.5.1.1)
+#define MODBUS_HOLDING_REGISTERS 16      // Table sizes without the gateway window
+#define MODBUS_COILS 128                 // DO 0-7, latch resets 100-107
+#define MODBUS_DISCRETE_INPUTS 16
+#define MODBUS_GATEWAY_BASE 1000         // Gateway data lives at 1000-3999 in every table
+#define MODBUS_GATEWAY_END 4000
+#define MODBUS_GATEWAY_MAX_POLLS 16
+#define MODBUS_GATEWAY_WRITE_QUEUE 16
+#define MODBUS_GATEWAY_MIN_INTERVAL_MS 20
+#define MODBUS_GATEWAY_DEFAULT_TIMEOUT_MS 250
+#define MODBUS_DIAG_REFRESH_MS 1000
+#define MAX_HTTP_CONNECTIONS 6           // Concurrent HTTP/1.1 connections (browser opens up to 6 per host)
+#define MAX_EVENT_STREAMS 3              // /events streams; the rest of the pool stays free for requests
+#define HTTP_HEAD_BUFFER 1536            // Request line + headers, and the start of any pipelined request
+#define HTTP_MAX_PATH 128                // Request target including the query string
+#define HTTP_MAX_BODY 8192               // Largest POST body (sensor config); one buffer shared by all connections
+#define HTTP_KEEPALIVE_TIMEOUT_MS 15000  // Idle keep-alive connection is closed after this
+#define HTTP_REQUEST_TIMEOUT_MS 5000     // A started request must be complete within this (408 otherwise)
+#define HTTP_CLOSE_TIMEOUT_MS 2000       // Wait this long for a closing response to be acknowledged
+#define HTTP_EVICT_MIN_IDLE_MS 1000      // A new client only takes over a keep-alive connection idle this long
+#define HTTP_MAX_REQUESTS_PER_PASS 4     // Pipelined requests answered per connection per loop pass
+#define HTTP_CHUNK_SIZE 1400             // Streamed response chunk, one TCP segment with its framing
+#define HTTP_EVENT_DEFAULT_INTERVAL_MS 250  // /events coalescing interval (config.eventInterval)
+#define HTTP_EVENT_MIN_INTERVAL_MS 50
+#define HTTP_EVENT_MAX_INTERVAL_MS 10000
+#define HTTP_EVENT_PING_MS 15000         // Comment line on a quiet stream, so a dead peer is noticed
 #define MAX_SENSORS 10
+#define MODBUS_INPUT_REGISTERS 32  // Input register window (AI 0-2 + sensor outputs)
+// Each sensor's outputs at modbusRegister, plus outputs, quality and timestamp in the packed block
+#define MAX_REGISTER_MAP_ENTRIES (MAX_SENSORS * (2 * (3 + LIS3DH_FEATURE_REGISTERS) + 2))
+#define MODBUS_PACKED_DEFAULT_BASE 100   // First register of the packed sensor block
+#define MODBUS_PACKED_MAX_BASE 8000      // The input table is 0-based: keeps it under ~16.5 KB of RAM
+#define MODBUS_PACKED_HEADER_REGISTERS 3 // Uptime ms (2 registers) + sensor count
+#define MODBUS_PACKED_REFRESH_MS 250     // Header and quality word refresh interval
+#define SENSOR_QUALITY_NO_DATA 0x0001    // Sensor has not completed a read yet
+#define SENSOR_QUALITY_STALE 0x0002      // No read within 3 update intervals (at least 3s)
 
 // Global flags
-bool core0setupComplete = false;
+volatile bool core0setupComplete = false;  // Core1 (sensor engine) waits for this before touching any bus
 
 // Digital IO pins
 const uint8_t DIGITAL_INPUTS[] = {0, 1, 2, 3, 4, 5, 6, 7};  // Digital input pins
 const uint8_t DIGITAL_OUTPUTS[] = {8, 9, 10, 11, 12, 13, 14, 15}; // Digital output pins
+// DI/DO are contiguous GPIO runs, so channel i is bit i of the SIO word shifted by these
+#define DIGITAL_INPUT_SHIFT 0
+#define DIGITAL_OUTPUT_SHIFT 8
+#define DIGITAL_OUTPUT_PIN_MASK (0xFFu << DIGITAL_OUTPUT_SHIFT)
 const uint8_t ANALOG_INPUTS[] = {26, 27, 28};   // ADC pins
 
 // Network and Modbus Configuration
@@ -113,7 +241,49 @@ struct BusOperation {
     bool needsCRC;
 };
 
-// SensorCommand is already defined above
+// Fixed-capacity ring buffer of pending bus operations (one per sensor at most).
+// popFront() is O(1); removeAt() shifts the later entries down one slot (O(n),
+// at most MAX_SENSORS) so the queue stays in FIFO order.
+struct BusQueue {
+    BusOperation ops[MAX_SENSORS];
+    uint8_t head;
+    uint8_t count;
+
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+    bool isEmpty() const {
+        return count == 0;
+    }
+
+    BusOperation& at(uint8_t i) {
+        return ops[(head + i) % MAX_SENSORS];
+    }
+
+    bool push(const BusOperation& op) {
+        if (count >= MAX_SENSORS) return false;
+        ops[(head + count) % MAX_SENSORS] = op;
+        count++;
+        return true;
+    }
+
+    void popFront() {
+        if (isEmpty()) return;
+        head = (head + 1) % MAX_SENSORS;
+        count--;
+    }
+
+    // Close the gap by shifting later entries down, so the queue stays oldest-first
+    void removeAt(uint8_t i) {
+        if (i >= count) return;
+        for (uint8_t j = i; j + 1 < count; j++) {
+            at(j) = at(j + 1);
+        }
+        count--;
+    }
+};
 
 struct Config {
     uint8_t version;
@@ -128,13 +298,38 @@ struct Config {
     bool diLatch[8];          // Enable latching for digital inputs (stay ON until read)
     bool doInvert[8];         // Invert logic for digital outputs
     bool doInitialState[8];   // Initial state for digital outputs (true = ON, false = OFF)
+    bool modbusPackedEnabled; // Also publish all sensor outputs in one contiguous input register block
+    uint16_t modbusPackedBase; // First register of the packed block
+    uint8_t modbusMaxClients;  // Active connection pool size (1-MAX_MODBUS_CLIENTS)
+    uint16_t modbusIdleTimeout; // Seconds without a request before a connection is closed (0 = never)
+    bool modbusRtuEnabled;     // Modbus RTU server on RS485, serving the same register image as TCP
+    uint8_t modbusRtuUnitId;   // RTU slave address (1-247)
+    uint32_t modbusRtuBaud;
+    char modbusRtuFraming[4];  // "8N1", "8E1", ... (UART_FRAMINGS)
+    int8_t modbusRtuTxPin;     // TX/RX must be a pin pair of one hardware UART (uartPortForPins)
+    int8_t modbusRtuRxPin;
+    int8_t modbusRtuDePin;     // Driver enable, high while transmitting (-1 = none)
+    bool modbusRtuGateway;     // Run the RS485 port as gateway master (polls in GATEWAY_FILE) instead of a server
+    uint16_t eventInterval;    // ms between /events pushes; changes within one interval go out together
+};
+
+// Channel bit masks (bit i = DI/DO i) built from the bool config arrays by rebuildIOMasks()
+struct IOMasks {
+    uint8_t diInvert;
+    uint8_t diLatch;
+    uint8_t doInvert;
 };
 
+inline bool ioBit(uint8_t bits, int index) { return (bits >> index) & 1; }
+inline void setIoBit(uint8_t& bits, int index, bool value) {
+    bits = value ? (bits | (1 << index)) : (bits & ~(1 << index));
+}
+
 struct IOStatus {
-    bool dIn[8];          // Current state of digital inputs (including latching behavior if enabled)
-    bool dInRaw[8];       // Actual physical state of digital inputs (without latching)
-    bool dInLatched[8];   // Tracks if an input has been latched (true = latched)
-    bool dOut[8];
+    uint8_t dIn;          // Bit i: digital input i (including latching behavior if enabled)
+    uint8_t dInRaw;       // Bit i: input i after invert, without latching
+    uint8_t dInLatched;   // Bit i: input i has been latched
+    uint8_t dOut;         // Bit i: logical state of output i (before doInvert)
     uint16_t aIn[3];
     
     // I2C Sensor Data - Active sensor fields
@@ -150,6 +345,18 @@ struct IOStatus {
     float conductivity;
 };
 
+// Modbus encoding of one sensor output. Integer encodings register
+// round(calibrated value x scale) clamped to the type's range; FLOAT32 registers
+// the calibrated value unscaled. 32-bit encodings take two registers.
+enum class RegisterEncoding : uint8_t {
+    INT16,
+    UINT16,
+    INT32,
+    UINT32,
+    FLOAT32,
+    RAW16        // Signed 16-bit computed by the sensor engine (LIS3DH features)
+};
+
 // Sensor configuration structure (KEEP - intentional improvements)
 struct SensorConfig {
     bool enabled;
@@ -159,6 +366,11 @@ struct SensorConfig {
     uint8_t i2cAddress;
     char i2cAddressStr[8]; // Hex string for I2C address
     int modbusRegister;
+    // Modbus encoding per output (A/B/C)
+    RegisterEncoding modbusEncoding[3];
+    float modbusScale[3];     // Integer encodings register value x scale (default 100)
+    bool modbusWordSwap;      // 32-bit values low word first (default high word first)
+    bool modbusByteSwap;      // Swap the two bytes within each register
     float calibrationOffset;
     float calibrationSlope;
     char calibrationExpression[128];  // Mathematical expression for calibration (supports any equation)
@@ -168,8 +380,11 @@ struct SensorConfig {
     int dataPin;
     int uartTxPin;
     int uartRxPin;
+    uint32_t uartBaud;        // UART baud rate (default 9600)
+    char uartFraming[4];      // Data bits/parity/stop bits: "8N1", "8E1", "7O2", ...
     int analogPin;
     int oneWirePin;
+    char oneWireRom[17];      // Device ROM ID as 16 hex digits (empty = auto-assign from the pin's ROM search)
     int digitalPin;
     // Data parsing configuration
     char parsingMethod[16];   // raw, custom_bits, bit_field, status_register, json_path, csv_column
@@ -202,6 +417,7 @@ struct SensorConfig {
     int modbusValue;          // Primary value written to Modbus register
     int modbusValueB;         // Secondary value for next Modbus register
     int modbusValueC;         // Tertiary value for next Modbus register
+    int16_t vibrationRegisters[LIS3DH_FEATURE_REGISTERS]; // LIS3DH window RMS, peak (mg) and crest factor (x100) for X/Y/Z
     
     // Calibration for multiple outputs
     float calibrationOffsetB; // Calibration offset for rawValueB
@@ -213,14 +429,22 @@ struct SensorConfig {
     
     char rawDataString[128];  // Raw data string for parsing (I2C/UART responses)
     unsigned long lastReadTime; // When last read was performed
+    unsigned long readCount;    // Completed reads since boot/reconfiguration
+    float measuredIntervalMs;   // Smoothed interval between completed reads (0 = not measured yet)
     
     // One-Wire specific configuration
     char oneWireCommand[16];  // Hex command to send (e.g., "0x44" for Convert T)
     int oneWireInterval;      // Interval in seconds between commands (0 = manual only)
     int oneWireConversionTime; // Time in ms to wait after command before reading
+    uint8_t oneWireResolution; // DS18B20 resolution in bits (9-12); sets the conversion time
     unsigned long lastOneWireCmd; // When last command was sent
     bool oneWireAutoMode;     // Enable automatic periodic commands
     
+    // LIS3DH FIFO streaming configuration (updateInterval is the feature window)
+    uint16_t lis3dhOdr;       // Output data rate in Hz: 1, 10, 25, 50, 100, 200, 400, 1344 or 1620
+    uint8_t lis3dhRange;      // Full scale in g: 2, 4, 8 or 16
+    int lis3dhIntPin;         // GPIO wired to INT1 (watermark interrupt), -1 = poll FIFO status
+    
     // SPI specific configuration
     uint8_t spiChipSelect;    // GPIO pin for chip select
     char spiBus[8];           // "hw0", "hw1", or "soft" for software SPI
@@ -231,9 +455,82 @@ struct SensorConfig {
 };
 
 // Extern declarations for global variables
+// Sensor readings published by core1 (sensor engine) for core0 (network side)
+struct SensorValues {
+    float rawValue;
+    float rawValueB;
+    float rawValueC;
+    float calibratedValue;
+    float calibratedValueB;
+    float calibratedValueC;
+    int modbusValue;
+    int modbusValueB;
+    int modbusValueC;
+    int16_t vibrationRegisters[LIS3DH_FEATURE_REGISTERS];
+    unsigned long lastReadTime;
+    unsigned long readCount;
+    float measuredIntervalMs;
+    char rawDataString[128];  // Copies of the SensorConfig text fields, NUL-terminated
+    char response[64];
+};
+
+// Seqlock-protected copy of one sensor's values. Core1 is the only writer:
+// the sequence number is odd while a write is in progress, so a reader that
+// sees the same even number before and after copying has a consistent set
+// (e.g. X/Y/Z from the same sample). Readers never block the writer.
+struct SensorSnapshot {
+    volatile uint32_t sequence;
+    SensorValues values;
+
+    void publish(const SensorValues& v) {
+        sequence = sequence + 1;
+        __sync_synchronize();
+        memcpy(&values, &v, sizeof(values));  // Bytewise, so publishSensorSnapshots() can memcmp() it
+        __sync_synchronize();
+        sequence = sequence + 1;
+    }
+
+    void read(SensorValues& out) const {
+        uint32_t before, after;
+        do {
+            before = sequence;
+            __sync_synchronize();
+            out = values;
+            __sync_synchronize();
+            after = sequence;
+        } while ((before & 1) || before != after);
+    }
+};
+
+// Compiled Modbus input register map. compileRegisterMap() turns the sensor
+// config into one entry per output register, grouped by sensor, so the
+// register image only touches the registers of sensors whose values changed.
+enum class RegisterSource : uint8_t {
+    VALUE_A,     // SensorValues.modbusValue
+    VALUE_B,     // SensorValues.modbusValueB
+    VALUE_C,     // SensorValues.modbusValueC
+    VIBRATION,   // SensorValues.vibrationRegisters[feature]
+    QUALITY,     // Packed block: SENSOR_QUALITY_* bits
+    TIMESTAMP    // Packed block: lastReadTime (ms since boot, 2 registers)
+};
+
+struct RegisterMapEntry {
+    uint16_t address;
+    RegisterSource source;
+    uint8_t feature;
+    RegisterEncoding encoding;
+    bool wordSwap;
+    bool byteSwap;
+    bool packed;      // Entry lives in the packed block
+    float scale;
+};
+
 extern Config config;
 extern IOStatus ioStatus;
+extern IOMasks ioMasks;
 extern SensorConfig configuredSensors[MAX_SENSORS];
+extern SensorSnapshot sensorSnapshots[MAX_SENSORS];
+extern volatile bool sensorRegistersDirty[MAX_SENSORS];
 extern int numConfiguredSensors;
 
 // Ethernet and Server instances - Essential for web server
@@ -243,16 +540,289 @@ extern WiFiServer httpServer;    // HTTP server on port 80
 extern WiFiClient client;
 
 // Client management
+// Receive-to-reply latency; bucket i counts requests up to MODBUS_LATENCY_BOUNDS_US[i]
+struct ModbusLatencyHistogram {
+    uint32_t buckets[MODBUS_LATENCY_BUCKETS];
+    uint32_t count;
+    uint32_t maxUs;
+    uint64_t totalUs;
+};
+
+struct ModbusTrafficStats {
+    uint32_t requests;
+    uint32_t exceptions;     // Replies with an exception code
+    uint32_t malformed;      // Invalid MBAP frames (connection dropped)
+    uint32_t noResponse;     // Broadcasts and failed sends
+    uint32_t bytesIn;
+    uint32_t bytesOut;
+    ModbusLatencyHistogram latency;
+};
+
+struct ModbusFunctionStats {
+    uint32_t requests;
+    uint32_t exceptions;
+    ModbusLatencyHistogram latency;
+};
+
+// FC08 serial-line diagnostic counters (16-bit, cleared by sub-functions 0x01 and 0x0A)
+struct ModbusDiagnosticCounters {
+    uint16_t busMessages;        // 0x0B: all frames, including malformed
+    uint16_t commErrors;         // 0x0C: malformed frames
+    uint16_t exceptions;         // 0x0D
+    uint16_t serverMessages;     // 0x0E: requests processed
+    uint16_t noResponse;         // 0x0F
+};
+
+// Per-connection state; the register maps are shared through modbusImage
 struct ModbusClientConnection {
     WiFiClient client;
     ModbusTCPServer server;
     bool connected;
     IPAddress clientIP;
+    uint16_t clientPort;
     unsigned long connectionTime;
+    unsigned long lastActivity;  // Last request answered (or connect time)
+    ModbusTrafficStats stats;    // Since this connection was accepted
+};
+
+struct ModbusPoolStats {
+    uint32_t accepted;
+    uint32_t rejected;       // Pool full and no connection idle long enough to evict
+    uint32_t evicted;        // Least recently used idle connection closed for a new client
+    uint32_t idleClosed;     // Closed by the idle timeout
+    uint32_t disconnected;   // Closed by the peer or lwIP (keepalive)
+    uint8_t peak;
+};
+
+// HTTP/1.1 connection. Bytes are read into head without blocking as they arrive;
+// a request body goes to the shared httpBody buffer, which one connection holds
+// at a time while its body streams in.
+enum class HttpConnectionState : uint8_t {
+    FREE,
+    HEAD,      // Waiting for a complete request line and headers (idle keep-alive when headLength == 0)
+    BODY,      // Reading Content-Length bytes into httpBody
+    SEND,      // Writing a flash-resident response body as send buffer space frees up
+    EVENTS,    // Server-Sent Events stream (/events) until the client disconnects
+    CLOSING    // Response written; closed once the peer has acknowledged it
+};
+
+// What an /events stream has already sent; each push carries only what differs
+struct EventStreamState {
+    bool primed;                          // Full IO snapshot sent
+    uint8_t dIn;
+    uint8_t dOut;
+    uint8_t dInLatched;
+    uint16_t aIn[3];
+    uint32_t sensorSequence[MAX_SENSORS]; // sensorSnapshots[i].sequence last sent
+    uint32_t sensorGeneration;            // sensorConfigGeneration the sensor events belong to
+    uint32_t logSequence;                 // terminalLogSequence last sent
+    unsigned long lastPush;
+    unsigned long lastWrite;
+};
+
+// Change sequence of every /iostatus value: one stamp per trackIOChanges() pass that
+// saw a difference, so GET /iostatus?since=N can send only the values stamped after N
+struct IOChangeTracker {
+    bool primed;
+    uint32_t boot;                        // Random per boot: a sequence is only meaningful with its boot id
+    uint32_t sequence;                    // Newest stamp
+    uint32_t resetSequence;               // Stamp of the last sensor list reload; older clients get everything
+    uint32_t sensorGeneration;            // sensorConfigGeneration at that reload
+    uint8_t dIn;
+    uint8_t dOut;
+    uint8_t dInLatched;
+    uint16_t aIn[3];
+    uint32_t dInSequence[8];
+    uint32_t dOutSequence[8];
+    uint32_t dInLatchedSequence[8];
+    uint32_t aInSequence[3];
+    uint32_t sensorSnapshot[MAX_SENSORS]; // sensorSnapshots[i].sequence last seen
+    uint32_t sensorSequence[MAX_SENSORS];
+};
+
+struct HttpConnection {
+    WiFiClient client;
+    HttpConnectionState state;
+    char head[HTTP_HEAD_BUFFER];
+    uint16_t headLength;         // Bytes buffered in head
+    char method[8];
+    char target[HTTP_MAX_PATH];
+    uint32_t contentLength;
+    uint32_t bodyLength;         // Bytes of the body received so far
+    bool keepAlive;              // HTTP/1.1 without "Connection: close", or HTTP/1.0 with keep-alive
+    bool http11;                 // Client accepts chunked responses
+    bool acceptGzip;             // Accept-Encoding includes gzip
+    char ifNoneMatch[48];        // If-None-Match, empty when absent (longer lists are cut and simply miss)
+    const uint8_t* sendData;     // Rest of a SEND body
+    uint32_t sendRemaining;
+    int idleSendBuffer;          // availableForWrite() with nothing in flight, to tell when a reply is acknowledged
+    unsigned long lastActivity;  // Last byte received or response sent
+    unsigned long requestStarted;  // First byte of the request being read
+    unsigned long closeStarted;
+    uint32_t requests;           // Requests answered on this connection
+    EventStreamState events;     // EVENTS only
+};
+
+// Framing of the response being written by a routeRequest() handler. Handlers that
+// send Content-Length and the Connection header from httpConnectionHeader() leave the
+// connection open; any other response closes it.
+struct HttpExchange {
+    bool keepAlive;        // Request allows the connection to stay open
+    bool framed;           // Response is self-delimiting and announced keep-alive
+    bool chunked;          // Request was HTTP/1.1, so a streamed response may use chunked coding
+    const char* query;     // Query string after '?', empty when absent
+    const char* ifNoneMatch;
+    bool acceptGzip;
+    const uint8_t* pendingData;  // Body the server sends after the handler returns (flash, not copied)
+    uint32_t pendingLength;
+    bool eventStream;            // Handler started an /events stream; the connection switches to EVENTS
+};
+
+// Web UI file compiled into flash by scripts/embed_web_assets.py (include/web_assets.h)
+struct WebAsset {
+    const char* path;          // URL: the source name, or the content-hashed name index.html references
+    const char* file;          // Same file on LittleFS
+    const char* contentType;
+    const char* etag;          // Quoted content hash
+    const uint8_t* data;       // In XIP flash
+    uint32_t length;
+    bool gzip;                 // data is gzip (clients without gzip get the LittleFS file)
+    bool immutable;            // Hashed URL: cached for a year without revalidation
+};
+
+struct HttpServerStats {
+    uint32_t accepted;
+    uint32_t requests;
+    uint32_t reused;        // Requests answered on an already used connection
+    uint32_t evicted;       // Idle keep-alive connection closed for a new client
+    uint32_t timeouts;      // Idle or incomplete-request timeouts
+    uint32_t errors;        // 400/408/413/431/501 replies
+    uint8_t peak;
+};
+
+// RS485 link for the Modbus RTU server or gateway. The UART is driven through
+// the SDK (not SerialUART) so the RX interrupt can timestamp every character.
+struct ModbusRTULink {
+    int8_t port;                  // Hardware UART index, -1 when closed
+    bool gateway;                 // Master: frames are responses for ModbusRTUClient
+    uart_inst_t* uart;
+    int8_t dePin;
+    uint32_t charUs;              // One character time at the configured baud/framing
+    uint32_t t35Us;               // Inter-frame silence
+    int dmaTx;                    // Claimed once, reused across reconfiguration
+    uint8_t rx[2][MODBUS_RTU_MAX_ADU_LENGTH];  // Receive buffer and completed frame, swapped on t3.5
+    uint8_t rxBuffer;             // Index of the buffer the RX interrupt fills
+    volatile uint16_t rxLength;
+    volatile bool rxOverflow;
+    volatile uint32_t firstByteUs;
+    volatile uint32_t lastByteUs;
+    volatile bool frameReady;     // rx[rxBuffer ^ 1] holds a frame for pollModbusRTU()
+    uint16_t frameLength;
+    uint32_t frameStartedUs;
+    uint8_t tx[MODBUS_RTU_MAX_ADU_LENGTH];
+    volatile bool transmitting;   // DE asserted until the last stop bit has left the UART
+};
+
+// One downstream read from GATEWAY_FILE. Values land at localAddress in the
+// table matching the function: FC01 coils, FC02 discrete inputs, FC03 holding
+// registers, FC04 input registers. Writes to mapped coils and holding
+// registers are forwarded to the device.
+struct GatewayPoll {
+    uint8_t unitId;
+    uint8_t function;
+    uint16_t remoteAddress;
+    uint16_t count;
+    uint16_t localAddress;
+    uint32_t intervalMs;
+};
+
+struct GatewayConfig {
+    uint16_t responseTimeoutMs;
+    uint8_t pollCount;
+    GatewayPoll polls[MODBUS_GATEWAY_MAX_POLLS];
+};
+
+enum class GatewayStatus : uint8_t {
+    PENDING,    // Not answered yet
+    OK,
+    TIMEOUT,
+    EXCEPTION,  // exception holds the code
+    INVALID     // CRC, length or quantity mismatch
+};
+
+// Polls of one unit and function whose remote ranges touch, read as one request
+// (up to 125 registers or 2000 bits)
+struct GatewayRead {
+    uint8_t unitId;
+    uint8_t function;
+    uint16_t address;
+    uint16_t count;
+    uint32_t intervalMs;          // Shortest interval of its polls
+    uint16_t polls;               // Bit per gatewayConfig.polls entry served
+    uint32_t lastStartMs;
+    uint32_t responses;
+    uint32_t failures;
+    GatewayStatus status;
+    uint8_t exception;
+};
+
+// Mapped coils or holding registers written locally, forwarded from the
+// image when sent so queued rewrites of the same range collapse
+struct GatewayWrite {
+    uint8_t poll;
+    uint16_t localAddress;
+    uint16_t count;
+};
+
+struct ModbusGateway {
+    GatewayRead reads[MODBUS_GATEWAY_MAX_POLLS];
+    uint8_t readCount;
+    GatewayWrite writes[MODBUS_GATEWAY_WRITE_QUEUE];
+    uint8_t writeHead;
+    uint8_t writeCount;
+    bool waiting;                 // Request sent, response not handled yet
+    int8_t activeRead;            // reads[] index being answered, -1 for the head write
+    uint32_t sentMs;              // Response timeout runs from the end of transmission
+    uint16_t values[MODBUS_MAX_READ_BITS];
+};
+
+struct ModbusGatewayStats {
+    uint32_t requests;
+    uint32_t responses;
+    uint32_t timeouts;
+    uint32_t exceptions;
+    uint32_t invalid;
+    uint32_t otherUnit;           // Frames from a unit other than the one asked
+    uint32_t writes;              // Writes forwarded and confirmed
+    uint32_t writeFailures;
+    uint32_t writesDropped;       // Write queue full
+};
+
+struct ModbusRTUStats {
+    uint32_t frames;              // Frames delimited by t3.5
+    uint32_t otherUnit;           // Addressed to another slave on the bus
+    uint32_t overruns;            // Dropped: over 256 bytes, or a frame still waiting to be handled
+    uint32_t lineErrors;          // Framing/parity/break/overrun flags from the UART
+    ModbusTrafficStats traffic;
 };
 
 extern ModbusClientConnection modbusClients[MAX_MODBUS_CLIENTS];
+extern ModbusTCPServer modbusImage;
+extern ModbusRTULink modbusRtu;
+extern ModbusRTUStats modbusRtuStats;
+extern GatewayConfig gatewayConfig;
+extern ModbusGateway modbusGateway;
+extern ModbusGatewayStats modbusGatewayStats;
+extern HttpConnection httpConnections[MAX_HTTP_CONNECTIONS];
+extern HttpExchange httpExchange;
+extern HttpServerStats httpServerStats;
+extern bool fileSystemMounted;
 extern int connectedClients;
+extern ModbusPoolStats modbusPoolStats;
+extern ModbusTrafficStats modbusTotals;
+extern ModbusFunctionStats modbusFunctionStats[MODBUS_STAT_FUNCTIONS];
+extern ModbusDiagnosticCounters modbusDiagCounters;
+extern ModbusLatencyHistogram coilProcessingLatency;
 
 // Default configuration
 const Config DEFAULT_CONFIG = {
@@ -267,7 +837,20 @@ const Config DEFAULT_CONFIG = {
     .diInvert = {false, false, false, false, false, false, false, false},
     .diLatch = {false, false, false, false, false, false, false, false},
     .doInvert = {false, false, false, false, false, false, false, false},
-    .doInitialState = {false, false, false, false, false, false, false, false}
+    .doInitialState = {false, false, false, false, false, false, false, false},
+    .modbusPackedEnabled = false,
+    .modbusPackedBase = MODBUS_PACKED_DEFAULT_BASE,
+    .modbusMaxClients = MODBUS_DEFAULT_CLIENTS,
+    .modbusIdleTimeout = MODBUS_DEFAULT_IDLE_TIMEOUT,
+    .modbusRtuEnabled = false,
+    .modbusRtuUnitId = MODBUS_RTU_DEFAULT_UNIT_ID,
+    .modbusRtuBaud = MODBUS_RTU_DEFAULT_BAUD,
+    .modbusRtuFraming = MODBUS_RTU_DEFAULT_FRAMING,
+    .modbusRtuTxPin = MODBUS_RTU_DEFAULT_TX_PIN,
+    .modbusRtuRxPin = MODBUS_RTU_DEFAULT_RX_PIN,
+    .modbusRtuDePin = MODBUS_RTU_DEFAULT_DE_PIN,
+    .modbusRtuGateway = false,
+    .eventInterval = HTTP_EVENT_DEFAULT_INTERVAL_MS
 };
 
 void initializePins();
@@ -275,10 +858,109 @@ void loadConfig();
 void saveConfig();
 void loadSensorConfig();
 void saveSensorConfig();
+void loadGatewayConfig();
+void saveGatewayConfig();
 void updateIOpins();
 void resetLatches();
-void initializeEzoSensors();
-void handleEzoSensors();
+void rebuildIOMasks();
+void writeDigitalOutputs(uint8_t logicalStates);
+void setDigitalOutput(int index, bool state);
+void rebuildEzoCycle();
+void processEzoCycle();
+void rebuildLIS3DHStreams();
+void processLIS3DHStreams();
+const char* compileRegisterMap();
+const char* httpConnectionHeader();
+
+// Print target for streamed responses. Output collects in one fixed buffer and goes to
+// the socket as a chunk each time it fills, so the response size (sensor count, log
+// length) never changes the memory a request needs. Handlers serialise straight into
+// it with serializeJson(doc, out) or print(). HTTP/1.0 clients get the same bytes
+// unframed, delimited by closing the connection.
+struct ChunkedResponse : public Print {
+    static const size_t HEAD_ROOM = 8;   // Chunk size line ("578\r\n") written in front of the data
+
+    WiFiClient& client;
+    uint8_t buffer[HEAD_ROOM + HTTP_CHUNK_SIZE + 2];
+    size_t length;      // Data bytes in the current chunk
+    size_t total;       // Body bytes sent
+    bool chunked;
+
+    explicit ChunkedResponse(WiFiClient& c) : client(c), length(0), total(0), chunked(false) {}
+
+    using Print::write;
+
+    void begin(const char* contentType) {
+        chunked = httpExchange.chunked;
+        client.print("HTTP/1.1 200 OK\r\nContent-Type: ");
+        client.print(contentType);
+        client.print("\r\nAccess-Control-Allow-Origin: *\r\n"
+                     "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+                     "Access-Control-Allow-Headers: Content-Type\r\n");
+        if (chunked) {
+            client.print("Transfer-Encoding: chunked\r\n");
+            client.print(httpConnectionHeader());
+        } else {
+            client.print("Connection: close");
+        }
+        client.print("\r\n\r\n");
+    }
+
+    size_t write(uint8_t b) override {
+        buffer[HEAD_ROOM + length++] = b;
+        if (length == HTTP_CHUNK_SIZE) sendChunk();
+        return 1;
+    }
+
+    size_t write(const uint8_t* data, size_t size) override {
+        size_t remaining = size;
+        while (remaining > 0) {
+            size_t n = HTTP_CHUNK_SIZE - length;
+            if (n > remaining) n = remaining;
+            memcpy(buffer + HEAD_ROOM + length, data, n);
+            length += n;
+            data += n;
+            remaining -= n;
+            if (length == HTTP_CHUNK_SIZE) sendChunk();
+        }
+        return size;
+    }
+
+    // Size line, data and CRLF go out in a single write
+    void sendChunk() {
+        if (length == 0) return;
+        total += length;
+        if (!chunked) {
+            client.write(buffer + HEAD_ROOM, length);
+            length = 0;
+            return;
+        }
+        char sizeLine[HEAD_ROOM + 1];
+        int n = snprintf(sizeLine, sizeof(sizeLine), "%X\r\n", (unsigned)length);
+        memcpy(buffer + HEAD_ROOM - n, sizeLine, n);
+        buffer[HEAD_ROOM + length] = '\r';
+        buffer[HEAD_ROOM + length + 1] = '\n';
+        client.write(buffer + HEAD_ROOM - n, n + length + 2);
+        length = 0;
+    }
+
+    // Send the partial chunk and the terminating zero-length chunk
+    void end() {
+        sendChunk();
+        if (chunked) client.print("0\r\n\r\n");
+    }
+
+    // JSON string literal of the printable ASCII in text, quotes and backslashes escaped
+    void printJsonString(const char* text) {
+        write('"');
+        for (const char* c = text; *c; c++) {
+            if (*c < 32 || *c > 126) continue;
+            if (*c == '"' || *c == '\\') write('\\');
+            write((uint8_t)*c);
+        }
+        write('"');
+    }
+};
 
 // File serving helper for main.cpp
 void serveFileFromFS(WiFiClient& client, const String& filename, const String& contentType) {
@@ -286,8 +968,8 @@ void serveFileFromFS(WiFiClient& client, const String& filename, const String& c
     Serial.println(filename);
     Serial.print("[serveFileFromFS] Content-Type: ");
     Serial.println(contentType);
-    if (!LittleFS.begin()) {
-        Serial.println("[serveFileFromFS] LittleFS mount failed");
+    if (!fileSystemMounted) {
+        Serial.println("[serveFileFromFS] LittleFS not mounted");
         client.println("HTTP/1.1 500 Internal Server Error");
         client.println("Content-Type: text/plain");
         client.println("Connection: close");
@@ -316,7 +998,7 @@ void serveFileFromFS(WiFiClient& client, const String& filename, const String& c
     client.println("HTTP/1.1 200 OK");
     client.print("Content-Type: ");
     client.println(contentType);
-    client.println("Connection: close");
+    client.println(httpConnectionHeader());
     client.print("Content-Length: ");
     client.println(file.size());
     client.println();
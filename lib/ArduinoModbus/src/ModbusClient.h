@@ -209,8 +209,9 @@ protected:
 
   int begin(modbus_t* _mb, int defaultId);
 
-private:
   modbus_t* _mb;
+
+private:
   unsigned long _timeout;
   int _defaultId;
 
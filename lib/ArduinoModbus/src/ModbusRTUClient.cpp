@@ -57,4 +57,151 @@ int ModbusRTUClientClass::begin(RS485Class& rs485, unsigned long baudrate, uint1
   return begin(baudrate, config);
 }
 
+int ModbusRTUClientClass::begin(modbus_rtu_frame_send_t send, void* context)
+{
+  modbus_t* mb = modbus_new_rtu_frames(send, context);
+
+  if (!ModbusClient::begin(mb, 0x00)) {
+    return 0;
+  }
+
+  // Recovery would sleep for the response timeout; the caller owns timing
+  modbus_set_error_recovery(_mb, MODBUS_ERROR_RECOVERY_NONE);
+  _requestLength = 0;
+
+  return 1;
+}
+
+int ModbusRTUClientClass::sendRequest(int id, int function, int address, int nb, const uint16_t* values)
+{
+  uint8_t* req = _request;
+  int length = 0;
+
+  _requestLength = 0;
+  if (_mb == NULL || id < 1 || id > 247 || nb < 1) {
+    errno = EINVAL;
+    return 0;
+  }
+
+  req[length++] = id;
+  req[length++] = function;
+  req[length++] = address >> 8;
+  req[length++] = address & 0xff;
+
+  switch (function) {
+    case MODBUS_FC_READ_COILS:
+    case MODBUS_FC_READ_DISCRETE_INPUTS:
+    case MODBUS_FC_READ_HOLDING_REGISTERS:
+    case MODBUS_FC_READ_INPUT_REGISTERS:
+      if (nb > ((function <= MODBUS_FC_READ_DISCRETE_INPUTS) ? MODBUS_MAX_READ_BITS : MODBUS_MAX_READ_REGISTERS)) {
+        errno = EMBMDATA;
+        return 0;
+      }
+      req[length++] = nb >> 8;
+      req[length++] = nb & 0xff;
+      break;
+
+    case MODBUS_FC_WRITE_SINGLE_COIL:
+      req[length++] = values[0] ? 0xff : 0x00;
+      req[length++] = 0x00;
+      break;
+
+    case MODBUS_FC_WRITE_SINGLE_REGISTER:
+      req[length++] = values[0] >> 8;
+      req[length++] = values[0] & 0xff;
+      break;
+
+    case MODBUS_FC_WRITE_MULTIPLE_COILS: {
+      int bytes = (nb + 7) / 8;
+
+      if (nb > MODBUS_MAX_WRITE_BITS) {
+        errno = EMBMDATA;
+        return 0;
+      }
+      req[length++] = nb >> 8;
+      req[length++] = nb & 0xff;
+      req[length++] = bytes;
+      memset(&req[length], 0x00, bytes);
+      for (int i = 0; i < nb; i++) {
+        if (values[i]) {
+          req[length + i / 8] |= (1 << (i % 8));
+        }
+      }
+      length += bytes;
+      break;
+    }
+
+    case MODBUS_FC_WRITE_MULTIPLE_REGISTERS:
+      if (nb > MODBUS_MAX_WRITE_REGISTERS) {
+        errno = EMBMDATA;
+        return 0;
+      }
+      req[length++] = nb >> 8;
+      req[length++] = nb & 0xff;
+      req[length++] = nb * 2;
+      for (int i = 0; i < nb; i++) {
+        req[length++] = values[i] >> 8;
+        req[length++] = values[i] & 0xff;
+      }
+      break;
+
+    default:
+      errno = EINVAL;
+      return 0;
+  }
+
+  modbus_set_slave(_mb, id);
+  if (modbus_send_raw_request(_mb, req, length) < 0) {
+    return 0;
+  }
+
+  _requestLength = length;
+  return 1;
+}
+
+int ModbusRTUClientClass::handleResponse(uint8_t* frame, int length, uint16_t* values)
+{
+  if (_requestLength == 0) {
+    errno = EINVAL;
+    return -1;
+  }
+
+  int rc = modbus_rtu_check_frame(_mb, frame, length);
+
+  if (rc <= 0) {
+    return rc;
+  }
+  if (modbus_check_confirmation(_mb, _request, frame, length) < 0) {
+    _requestLength = 0;
+    return -1;
+  }
+
+  int function = _request[1];
+  int nb = (_request[4] << 8) | _request[5];
+
+  _requestLength = 0;
+  switch (function) {
+    case MODBUS_FC_READ_COILS:
+    case MODBUS_FC_READ_DISCRETE_INPUTS:
+      for (int i = 0; i < nb; i++) {
+        values[i] = (frame[3 + i / 8] >> (i % 8)) & 0x01;
+      }
+      return nb;
+
+    case MODBUS_FC_READ_HOLDING_REGISTERS:
+    case MODBUS_FC_READ_INPUT_REGISTERS:
+      for (int i = 0; i < nb; i++) {
+        values[i] = (frame[3 + i * 2] << 8) | frame[4 + i * 2];
+      }
+      return nb;
+
+    case MODBUS_FC_WRITE_MULTIPLE_COILS:
+    case MODBUS_FC_WRITE_MULTIPLE_REGISTERS:
+      return nb;
+
+    default:
+      return 1;
+  }
+}
+
 ModbusRTUClientClass ModbusRTUClient;
@@ -23,6 +23,10 @@
 #include "ModbusClient.h"
 #include <ArduinoRS485.h>
 
+extern "C" {
+#include "libmodbus/modbus-rtu.h"
+}
+
 class ModbusRTUClientClass : public ModbusClient {
 public:
   ModbusRTUClientClass();
@@ -40,8 +44,51 @@ public:
   int begin(unsigned long baudrate, uint16_t config = SERIAL_8N1);
   int begin(RS485Class& rs485, unsigned long baudrate, uint16_t config = SERIAL_8N1);
 
+  /**
+   * Start the Modbus RTU client without an RS485 port. Requests are handed
+   * to send; the caller receives and delimits the response frame (t3.5
+   * silence), applies its own response timeout, and passes the frame to
+   * handleResponse(). Nothing blocks.
+   *
+   * @param send called with each request ADU, CRC included
+   * @param context passed to send
+   *
+   * Return 1 on success, 0 on failure
+   */
+  int begin(modbus_rtu_frame_send_t send, void* context);
+
+  /**
+   * Send one request without waiting for the response
+   *
+   * @param id (slave) id of target, 1-247
+   * @param function MODBUS_FC_READ_COILS to MODBUS_FC_READ_INPUT_REGISTERS,
+   *        MODBUS_FC_WRITE_SINGLE_COIL/REGISTER or MODBUS_FC_WRITE_MULTIPLE_COILS/REGISTERS
+   * @param address first address on the target
+   * @param nb number of values
+   * @param values values to write (coils as 0/non-zero), NULL for reads
+   *
+   * Return 1 on success, 0 on failure
+   */
+  int sendRequest(int id, int function, int address, int nb, const uint16_t* values = NULL);
+
+  /**
+   * Check a response frame against the last request sent and decode it
+   *
+   * @param frame response ADU, CRC included
+   * @param length frame length in bytes
+   * @param values receives nb values (bits as 0/1) for a read request
+   *
+   * Return the number of values read or written, 0 if the frame is from
+   * another unit, -1 for an exception response or a malformed frame
+   * (errno is set, see lastError())
+   */
+  int handleResponse(uint8_t* frame, int length, uint16_t* values);
+
 private:
   RS485Class* _rs485 = &RS485;
+
+  uint8_t _request[MODBUS_RTU_MAX_ADU_LENGTH];
+  int _requestLength = 0;
 };
 
 extern ModbusRTUClientClass ModbusRTUClient;
@@ -57,6 +57,33 @@ int ModbusRTUServerClass::begin(RS485Class& rs485, int id, unsigned long baudrat
   return begin(id, baudrate, config);
 }
 
+int ModbusRTUServerClass::begin(int id, modbus_rtu_frame_send_t send, void* context)
+{
+  modbus_t* mb = modbus_new_rtu_frames(send, context);
+
+  if (!ModbusServer::begin(mb, id)) {
+    return 0;
+  }
+
+  return 1;
+}
+
+int ModbusRTUServerClass::handleFrame(uint8_t* frame, int length, uint32_t startedUs)
+{
+  int rc = modbus_rtu_check_frame(_mb, frame, length);
+
+  if (rc < 0) {
+    reportMalformed(length);
+    return -1;
+  }
+  if (rc == 0) {
+    return 0;
+  }
+
+  reply(frame, length, startedUs);
+  return 1;
+}
+
 int ModbusRTUServerClass::poll()
 {
   uint8_t request[MODBUS_RTU_MAX_ADU_LENGTH];
@@ -64,7 +91,7 @@ int ModbusRTUServerClass::poll()
   int requestLength = modbus_receive(_mb, request);
 
   if (requestLength > 0) {
-    modbus_reply(_mb, request, requestLength, &_mbMapping);
+    modbus_reply(_mb, request, requestLength, _mapping);
     return 1;
   }
   return 0;
@@ -23,6 +23,10 @@
 #include "ModbusServer.h"
 #include <ArduinoRS485.h>
 
+extern "C" {
+#include "libmodbus/modbus-rtu.h"
+}
+
 class ModbusRTUServerClass : public ModbusServer {
 public:
   ModbusRTUServerClass();
@@ -41,6 +45,31 @@ public:
   int begin(int id, unsigned long baudrate, uint16_t config = SERIAL_8N1);
   int begin(RS485Class& rs485, int id, unsigned long baudrate, uint16_t config = SERIAL_8N1);
 
+  /**
+   * Start the Modbus RTU server without an RS485 port. The caller receives
+   * and delimits request frames (t3.5 silence), hands each one to
+   * handleFrame(), and transmits replies when send is called.
+   *
+   * @param id (slave) id of the server
+   * @param send called with each reply ADU, CRC included
+   * @param context passed to send
+   *
+   * Return 1 on success, 0 on failure
+   */
+  int begin(int id, modbus_rtu_frame_send_t send, void* context);
+
+  /**
+   * Handle one complete request frame received by the caller
+   *
+   * @param frame request ADU, CRC included
+   * @param length frame length in bytes
+   * @param startedUs micros() when the first byte of the frame was received
+   *
+   * Return 1 if the request was handled, 0 if it is addressed to another
+   * unit, -1 if the frame is malformed (CRC error or too short)
+   */
+  int handleFrame(uint8_t* frame, int length, uint32_t startedUs);
+
   /**
    * Poll interface for requests
    */
@@ -22,7 +22,17 @@
 #include "ModbusServer.h"
 
 ModbusServer::ModbusServer() :
-  _mb(NULL)
+  _mb(NULL),
+  _mapping(&_mbMapping),
+  _requestCallback(NULL),
+  _requestContext(NULL),
+  _customFunction(0),
+  _functionHandler(NULL),
+  _functionContext(NULL),
+  _coilCallback(NULL),
+  _coilContext(NULL),
+  _registerCallback(NULL),
+  _registerContext(NULL)
 {
   memset(&_mbMapping, 0x00, sizeof(_mbMapping));
 }
@@ -138,15 +148,14 @@ int ModbusServer::configureInputRegisters(int startAddress, int nb)
 
   size_t s = sizeof(_mbMapping.tab_input_registers[0]) * nb;
 
-  _mbMapping.tab_input_registers = (uint16_t*)realloc(_mbMapping.tab_input_registers, s);
-
-  if (_mbMapping.tab_input_registers == NULL) {
-    _mbMapping.start_input_registers = 0;
-    _mbMapping.nb_input_registers = 0;
+  // On failure the previous table stays allocated and served
+  uint16_t* table = (uint16_t*)realloc(_mbMapping.tab_input_registers, s);
 
+  if (table == NULL) {
     return 0;
   }
 
+  _mbMapping.tab_input_registers = table;
   memset(_mbMapping.tab_input_registers, 0x00, s);
   _mbMapping.start_input_registers = startAddress;
   _mbMapping.nb_input_registers = nb;
@@ -156,76 +165,76 @@ int ModbusServer::configureInputRegisters(int startAddress, int nb)
 
 int ModbusServer::coilRead(int address)
 {
-  if (_mbMapping.start_bits > address || 
-      (_mbMapping.start_bits + _mbMapping.nb_bits) < (address + 1)) {
+  if (_mapping->start_bits > address || 
+      (_mapping->start_bits + _mapping->nb_bits) < (address + 1)) {
     errno = EMBXILADD;
 
     return -1;
   }
 
-  return _mbMapping.tab_bits[address - _mbMapping.start_bits];
+  return _mapping->tab_bits[address - _mapping->start_bits];
 }
 
 int ModbusServer::discreteInputRead(int address)
 {
-  if (_mbMapping.start_input_bits > address || 
-      (_mbMapping.start_input_bits + _mbMapping.nb_input_bits) < (address + 1)) {
+  if (_mapping->start_input_bits > address || 
+      (_mapping->start_input_bits + _mapping->nb_input_bits) < (address + 1)) {
     errno = EMBXILADD;
 
     return -1;
   }
 
-  return _mbMapping.tab_input_bits[address - _mbMapping.start_input_bits];
+  return _mapping->tab_input_bits[address - _mapping->start_input_bits];
 }
 
 long ModbusServer::holdingRegisterRead(int address)
 {
-  if (_mbMapping.start_registers > address ||
-      (_mbMapping.start_registers + _mbMapping.nb_registers) < (address + 1)) {
+  if (_mapping->start_registers > address ||
+      (_mapping->start_registers + _mapping->nb_registers) < (address + 1)) {
     errno = EMBXILADD;
 
     return -1;
   }
 
-  return _mbMapping.tab_registers[address - _mbMapping.start_registers];
+  return _mapping->tab_registers[address - _mapping->start_registers];
 }
 
 long ModbusServer::inputRegisterRead(int address)
 {
-  if (_mbMapping.start_input_registers > address || 
-      (_mbMapping.start_input_registers + _mbMapping.nb_input_registers) < (address + 1)) {
+  if (_mapping->start_input_registers > address || 
+      (_mapping->start_input_registers + _mapping->nb_input_registers) < (address + 1)) {
     errno = EMBXILADD;
 
     return -1;
   }
 
- return _mbMapping.tab_input_registers[address - _mbMapping.start_input_registers];
+ return _mapping->tab_input_registers[address - _mapping->start_input_registers];
 }
 
 int ModbusServer::coilWrite(int address, uint8_t value)
 {
-  if (_mbMapping.start_bits > address ||
-      (_mbMapping.start_bits + _mbMapping.nb_bits) < (address + 1)) {
+  if (_mapping->start_bits > address ||
+      (_mapping->start_bits + _mapping->nb_bits) < (address + 1)) {
     errno = EMBXILADD;
 
     return 0;
   }
 
-  _mbMapping.tab_bits[address - _mbMapping.start_bits] = value;
+  _mapping->tab_bits[address - _mapping->start_bits] = value;
 
   return 1;
 }
 
 int ModbusServer::holdingRegisterWrite(int address, uint16_t value)
 {
-  if (_mbMapping.start_registers > address || 
-      (_mbMapping.start_registers + _mbMapping.nb_registers) < (address + 1)) {
+  if (_mapping->start_registers > address || 
+      (_mapping->start_registers + _mapping->nb_registers) < (address + 1)) {
     errno = EMBXILADD;
 
     return 0;
   }
 
-  _mbMapping.tab_registers[address - _mbMapping.start_registers] = value;
+  _mapping->tab_registers[address - _mapping->start_registers] = value;
 
   return 1;
 }
@@ -255,14 +264,66 @@ int ModbusServer::discreteInputWrite(int address, uint8_t value)
 
 int ModbusServer::writeDiscreteInputs(int address, uint8_t values[], int nb)
 {
-  if (_mbMapping.start_input_bits > address || 
-      (_mbMapping.start_input_bits + _mbMapping.nb_input_bits) < (address + nb)) {
+  if (_mapping->start_input_bits > address || 
+      (_mapping->start_input_bits + _mapping->nb_input_bits) < (address + nb)) {
+    errno = EMBXILADD;
+
+    return 0;
+  }
+
+  memcpy(&_mapping->tab_input_bits[address - _mapping->start_input_bits], values, sizeof(values[0]) * nb);
+
+  return 1;
+}
+
+int ModbusServer::writeDiscreteInputBits(int address, uint32_t bits, int nb)
+{
+  if (nb < 1 || nb > 32 || _mapping->start_input_bits > address ||
+      (_mapping->start_input_bits + _mapping->nb_input_bits) < (address + nb)) {
     errno = EMBXILADD;
 
     return 0;
   }
 
-  memcpy(&_mbMapping.tab_input_bits[address - _mbMapping.start_input_bits], values, sizeof(values[0]) * nb);
+  uint8_t* dest = &_mapping->tab_input_bits[address - _mapping->start_input_bits];
+  for (int i = 0; i < nb; i++) {
+    dest[i] = (bits >> i) & 1;
+  }
+
+  return 1;
+}
+
+uint32_t ModbusServer::readCoilBits(int address, int nb)
+{
+  if (nb < 1 || nb > 32 || _mapping->start_bits > address ||
+      (_mapping->start_bits + _mapping->nb_bits) < (address + nb)) {
+    errno = EMBXILADD;
+
+    return 0;
+  }
+
+  const uint8_t* src = &_mapping->tab_bits[address - _mapping->start_bits];
+  uint32_t bits = 0;
+  for (int i = 0; i < nb; i++) {
+    bits |= (uint32_t)(src[i] ? 1 : 0) << i;
+  }
+
+  return bits;
+}
+
+int ModbusServer::writeCoilBits(int address, uint32_t bits, int nb)
+{
+  if (nb < 1 || nb > 32 || _mapping->start_bits > address ||
+      (_mapping->start_bits + _mapping->nb_bits) < (address + nb)) {
+    errno = EMBXILADD;
+
+    return 0;
+  }
+
+  uint8_t* dest = &_mapping->tab_bits[address - _mapping->start_bits];
+  for (int i = 0; i < nb; i++) {
+    dest[i] = (bits >> i) & 1;
+  }
 
   return 1;
 }
@@ -274,18 +335,103 @@ int ModbusServer::inputRegisterWrite(int address, uint16_t value)
 
 int ModbusServer::writeInputRegisters(int address, uint16_t values[], int nb)
 {
-  if (_mbMapping.start_input_registers > address || 
-      (_mbMapping.start_input_registers + _mbMapping.nb_input_registers) < (address + nb)) {
+  if (_mapping->start_input_registers > address || 
+      (_mapping->start_input_registers + _mapping->nb_input_registers) < (address + nb)) {
     errno = EMBXILADD;
 
     return 0;
   }
 
-  memcpy(&_mbMapping.tab_input_registers[address - _mbMapping.start_input_registers], values, sizeof(values[0]) * nb);
+  memcpy(&_mapping->tab_input_registers[address - _mapping->start_input_registers], values, sizeof(values[0]) * nb);
 
   return 1;
 }
 
+void ModbusServer::shareMapping(ModbusServer& image)
+{
+  _mapping = &image._mbMapping;
+}
+
+void ModbusServer::onRequest(ModbusRequestCallback callback, void* context)
+{
+  _requestCallback = callback;
+  _requestContext = context;
+}
+
+void ModbusServer::onFunction(uint8_t function, modbus_pdu_handler_t handler, void* context)
+{
+  _customFunction = function;
+  _functionHandler = handler;
+  _functionContext = context;
+}
+
+void ModbusServer::onCoilWrite(ModbusCoilWriteCallback callback, void* context)
+{
+  _coilCallback = callback;
+  _coilContext = context;
+}
+
+void ModbusServer::onRegisterWrite(ModbusRegisterWriteCallback callback, void* context)
+{
+  _registerCallback = callback;
+  _registerContext = context;
+}
+
+int ModbusServer::reply(const uint8_t* request, int requestLength, uint32_t startedUs)
+{
+  int offset = modbus_get_header_length(_mb);
+  uint8_t function = request[offset];
+  int sent;
+
+  if (_functionHandler != NULL && function == _customFunction) {
+    sent = modbus_reply_pdu(_mb, request, requestLength, _functionHandler, _functionContext);
+  } else {
+    sent = modbus_reply(_mb, request, requestLength, _mapping);
+  }
+
+  if (_coilCallback != NULL && modbus_get_reply_exception(_mb) == 0 &&
+      (function == MODBUS_FC_WRITE_SINGLE_COIL || function == MODBUS_FC_WRITE_MULTIPLE_COILS)) {
+    int address = (request[offset + 1] << 8) | request[offset + 2];
+    int count = (function == MODBUS_FC_WRITE_SINGLE_COIL) ? 1 : ((request[offset + 3] << 8) | request[offset + 4]);
+    _coilCallback(_coilContext, address, count, startedUs);
+  }
+
+  if (_registerCallback != NULL && modbus_get_reply_exception(_mb) == 0) {
+    if (function == MODBUS_FC_WRITE_SINGLE_REGISTER) {
+      _registerCallback(_registerContext, (request[offset + 1] << 8) | request[offset + 2], 1, startedUs);
+    } else if (function == MODBUS_FC_WRITE_MULTIPLE_REGISTERS) {
+      _registerCallback(_registerContext, (request[offset + 1] << 8) | request[offset + 2],
+                        (request[offset + 3] << 8) | request[offset + 4], startedUs);
+    } else if (function == MODBUS_FC_WRITE_AND_READ_REGISTERS) {
+      _registerCallback(_registerContext, (request[offset + 5] << 8) | request[offset + 6],
+                        (request[offset + 7] << 8) | request[offset + 8], startedUs);
+    }
+  }
+
+  if (_requestCallback != NULL) {
+    ModbusRequestInfo info;
+    info.function = function;
+    info.exception = modbus_get_reply_exception(_mb);
+    info.malformed = false;
+    info.requestLength = requestLength;
+    info.responseLength = (sent > 0) ? sent : 0;
+    info.latencyUs = micros() - startedUs;
+    _requestCallback(_requestContext, info);
+  }
+
+  return sent;
+}
+
+void ModbusServer::reportMalformed(int length)
+{
+  if (_requestCallback != NULL) {
+    ModbusRequestInfo info = {};
+    info.malformed = true;
+    info.requestLength = length;
+    _requestCallback(_requestContext, info);
+  }
+}
+
 int ModbusServer::begin(modbus_t* mb, int id)
 {
   end();
@@ -319,6 +465,7 @@ void ModbusServer::end()
   }
 
   memset(&_mbMapping, 0x00, sizeof(_mbMapping));
+  _mapping = &_mbMapping;
 
   if (_mb != NULL) {
     modbus_close(_mb);
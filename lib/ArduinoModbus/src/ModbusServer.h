@@ -26,6 +26,27 @@ extern "C" {
   #include "libmodbus/modbus.h"
 }
 
+/**
+ * One request handled by poll(), passed to the onRequest() callback
+ */
+struct ModbusRequestInfo {
+  uint8_t function;         // Request function code, 0 for a malformed frame
+  uint8_t exception;        // Exception code replied, 0 for a normal response
+  bool malformed;           // Framing/CRC error; a TCP connection is dropped
+  uint16_t requestLength;   // ADU bytes received
+  uint16_t responseLength;  // ADU bytes sent, 0 if no reply (broadcast, send failure)
+  uint32_t latencyUs;       // First request byte read to reply written
+};
+
+typedef void (*ModbusRequestCallback)(void* context, const ModbusRequestInfo& info);
+
+// Coils [address, address + count) were written by FC05/FC15; startedUs is
+// micros() when the first byte of the request was read
+typedef void (*ModbusCoilWriteCallback)(void* context, int address, int count, uint32_t startedUs);
+
+// Holding registers [address, address + count) were written by FC06/FC16/FC23
+typedef void (*ModbusRegisterWriteCallback)(void* context, int address, int count, uint32_t startedUs);
+
 class ModbusServer {
 
 public:
@@ -101,6 +122,39 @@ public:
    */
   int writeDiscreteInputs(int address, uint8_t values[], int nb);
 
+  /**
+   * Write up to 32 of the server's Discrete Inputs from a bit mask,
+   * bit i to address + i.
+   *
+   * @param address address of the first discrete input
+   * @param bits bit mask of values
+   * @param nb number of discrete inputs to write (1-32)
+   *
+   * @return 1 on success, 0 on failure.
+   */
+  int writeDiscreteInputBits(int address, uint32_t bits, int nb);
+
+  /**
+   * Read up to 32 of the server's Coils into a bit mask, address + i to bit i.
+   *
+   * @param address address of the first coil
+   * @param nb number of coils to read (1-32)
+   *
+   * @return bit mask of coil values, 0 if out of range
+   */
+  uint32_t readCoilBits(int address, int nb);
+
+  /**
+   * Write up to 32 of the server's Coils from a bit mask, bit i to address + i.
+   *
+   * @param address address of the first coil
+   * @param bits bit mask of values
+   * @param nb number of coils to write (1-32)
+   *
+   * @return 1 on success, 0 on failure.
+   */
+  int writeCoilBits(int address, uint32_t bits, int nb);
+
   /**
    * Write the value of the server's Input Register for the specified address
    * and value.
@@ -124,10 +178,56 @@ public:
    */
   int writeInputRegisters(int address, uint16_t values[], int nb);
 
+  /**
+   * Serve and access the coils, discrete inputs and registers of another
+   * server instead of this server's own, so several connections share one
+   * register image. The image server must outlive this server; end()
+   * reverts to the server's own maps.
+   *
+   * @param image server whose maps are configured with configure*()
+   */
+  void shareMapping(ModbusServer& image);
+
+  /**
+   * Call a function after every request handled by poll(), for statistics
+   *
+   * @param callback function to call, NULL to remove
+   * @param context passed back to the callback
+   */
+  void onRequest(ModbusRequestCallback callback, void* context);
+
+  /**
+   * Answer one function code libmodbus does not implement (e.g. FC08)
+   * with an application handler
+   *
+   * @param function function code to handle
+   * @param handler builds the response PDU, see modbus_pdu_handler_t
+   * @param context passed back to the handler
+   */
+  void onFunction(uint8_t function, modbus_pdu_handler_t handler, void* context);
+
+  /**
+   * Call a function as soon as a write coil request (FC05/FC15) has been
+   * applied to the coils, so outputs can follow without waiting for a poll
+   *
+   * @param callback function to call, NULL to remove
+   * @param context passed back to the callback
+   */
+  void onCoilWrite(ModbusCoilWriteCallback callback, void* context);
+
+  /**
+   * Call a function as soon as a write holding register request (FC06,
+   * FC16 or the write part of FC23) has been applied
+   *
+   * @param callback function to call, NULL to remove
+   * @param context passed back to the callback
+   */
+  void onRegisterWrite(ModbusRegisterWriteCallback callback, void* context);
+
   /**
    * Poll for requests
    * 
-   * @return 1 on request, 0 on no request.
+   * @return number of requests handled, 0 on no request.
    */
   virtual int poll() = 0;
 
@@ -142,9 +242,24 @@ protected:
 
   int begin(modbus_t* _mb, int id);
 
+  // Reply to one complete request and report it to the onRequest() callback
+  int reply(const uint8_t* request, int requestLength, uint32_t startedUs);
+  void reportMalformed(int length);
+
 protected:
   modbus_t* _mb;
   modbus_mapping_t _mbMapping;
+  modbus_mapping_t* _mapping;  // _mbMapping, or the image set by shareMapping()
+
+  ModbusRequestCallback _requestCallback;
+  void* _requestContext;
+  uint8_t _customFunction;
+  modbus_pdu_handler_t _functionHandler;
+  void* _functionContext;
+  ModbusCoilWriteCallback _coilCallback;
+  void* _coilContext;
+  ModbusRegisterWriteCallback _registerCallback;
+  void* _registerContext;
 };
 
 #endif
@@ -59,15 +59,25 @@ void ModbusTCPServer::accept(Client& client)
 
 int ModbusTCPServer::poll()
 {
+  int handled = 0;
+
   if (_client != NULL) {
     uint8_t request[MODBUS_TCP_MAX_ADU_LENGTH];
+    uint32_t startedUs;
+    int requestLength;
+
+    // Answer every complete request already received; a partial frame is
+    // kept and completed on a later poll without waiting for its bytes
+    while ((requestLength = modbus_tcp_receive_nb(_mb, request, &startedUs)) > 0) {
+      reply(request, requestLength, startedUs);
+      handled++;
+    }
 
-    int requestLength = modbus_receive(_mb, request);
-
-    if (requestLength > 0) {
-      modbus_reply(_mb, request, requestLength, &_mbMapping);
-      return 1;
+    if (requestLength < 0) {
+      // Framing is lost after an invalid MBAP header, drop the connection
+      reportMalformed(modbus_get_header_length(_mb));
+      _client->stop();
     }
   }
-  return 0;
+  return handled;
 }
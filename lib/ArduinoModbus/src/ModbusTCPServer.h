@@ -46,7 +46,9 @@ public:
   void accept(Client& client);
 
   /**
-   * Poll accepted client for requests
+   * Poll accepted client for requests without blocking
+   *
+   * Return the number of requests answered
    */
   virtual int poll();
 
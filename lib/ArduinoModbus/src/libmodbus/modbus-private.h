@@ -114,6 +114,8 @@ struct _modbus {
     struct timeval byte_timeout;
     const modbus_backend_t *backend;
     void *backend_data;
+    /* Exception code of the last reply, 0 if it was a normal response */
+    int reply_exception;
 };
 
 void _modbus_init_common(modbus_t *ctx);
@@ -18,6 +18,7 @@
 #include <windows.h>
 #elif defined(ARDUINO)
 #include <ArduinoRS485.h>
+#include "modbus-rtu.h"
 #else
 #include <termios.h>
 #endif
@@ -50,6 +51,9 @@ typedef struct _modbus_rtu {
     unsigned long baud;
     uint16_t config;
     RS485Class* rs485;
+    /* Frame transport (modbus_new_rtu_frames), rs485 is NULL */
+    modbus_rtu_frame_send_t frame_send;
+    void *frame_context;
 #else
     /* Device: "/dev/ttyS0", "/dev/ttyUSB0" or "/dev/tty.USA19*" on Mac OS X. */
     char *device;
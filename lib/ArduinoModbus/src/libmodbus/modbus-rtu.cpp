@@ -327,6 +327,10 @@ static ssize_t _modbus_rtu_send(modbus_t *ctx, const uint8_t *req, int req_lengt
 
     ssize_t size;
 
+    if (ctx_rtu->frame_send != NULL) {
+        return ctx_rtu->frame_send(ctx_rtu->frame_context, req, req_length);
+    }
+
     ctx_rtu->rs485->noReceive();
     ctx_rtu->rs485->beginTransmission();
     size = ctx_rtu->rs485->write(req, req_length);
@@ -654,8 +658,10 @@ static int _modbus_rtu_connect(modbus_t *ctx)
         return -1;
     }
 #elif defined(ARDUINO)
-    ctx_rtu->rs485->begin(ctx_rtu->baud, ctx_rtu->config);
-    ctx_rtu->rs485->receive();
+    if (ctx_rtu->rs485 != NULL) {
+        ctx_rtu->rs485->begin(ctx_rtu->baud, ctx_rtu->config);
+        ctx_rtu->rs485->receive();
+    }
 #else
     /* The O_NOCTTY flag tells UNIX that this program doesn't want
        to be the "controlling terminal" for that port. If you
@@ -1208,10 +1214,10 @@ static void _modbus_rtu_close(modbus_t *ctx)
                 (int)GetLastError());
     }
 #elif defined(ARDUINO)
-    (void)ctx_rtu;
-
-    ctx_rtu->rs485->noReceive();
-    ctx_rtu->rs485->end();
+    if (ctx_rtu->rs485 != NULL) {
+        ctx_rtu->rs485->noReceive();
+        ctx_rtu->rs485->end();
+    }
 #else
     if (ctx->s != -1) {
         tcsetattr(ctx->s, TCSANOW, &ctx_rtu->old_tios);
@@ -1230,7 +1236,7 @@ static int _modbus_rtu_flush(modbus_t *ctx)
 #elif defined(ARDUINO)
     modbus_rtu_t *ctx_rtu = (modbus_rtu_t*)ctx->backend_data;
 
-    while (ctx_rtu->rs485->available()) {
+    while (ctx_rtu->rs485 != NULL && ctx_rtu->rs485->available()) {
         ctx_rtu->rs485->read();
     }
 
@@ -1262,6 +1268,12 @@ static int _modbus_rtu_select(modbus_t *ctx, fd_set *rset,
     unsigned long wait_time_millis = (tv == NULL) ? 0 : (tv->tv_sec * 1000) + (tv->tv_usec / 1000);
     unsigned long start = millis();
 
+    if (ctx_rtu->rs485 == NULL) {
+        /* Frame transport: requests are never read through the backend */
+        errno = ETIMEDOUT;
+        return -1;
+    }
+
     do {
         s_rc = ctx_rtu->rs485->available();
 
@@ -1365,6 +1377,8 @@ modbus_t* modbus_new_rtu(const char *device,
     ctx_rtu->rs485 = rs485;
     ctx_rtu->baud = baud;
     ctx_rtu->config = config;
+    ctx_rtu->frame_send = NULL;
+    ctx_rtu->frame_context = NULL;
 #else
     ctx_rtu->device = NULL;
 
@@ -1407,3 +1421,46 @@ modbus_t* modbus_new_rtu(const char *device,
 
     return ctx;
 }
+
+#ifdef ARDUINO
+/* RTU context without a serial port: the caller owns the UART, passes each
+   received frame to modbus_rtu_check_frame() and transmits replies in send */
+modbus_t* modbus_new_rtu_frames(modbus_rtu_frame_send_t send, void *context)
+{
+    modbus_t *ctx;
+    modbus_rtu_t *ctx_rtu;
+
+    if (send == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    ctx = modbus_new_rtu(NULL, 0, 0);
+    ctx_rtu = (modbus_rtu_t *)ctx->backend_data;
+    ctx_rtu->frame_send = send;
+    ctx_rtu->frame_context = context;
+
+    /* The caller delimited the frame, so there is nothing left on the line to
+       wait for and flush: exception replies (response_exception()) go out
+       without sleeping through the response timeout on the caller's core */
+    ctx->response_timeout.tv_sec = 0;
+    ctx->response_timeout.tv_usec = 0;
+
+    return ctx;
+}
+
+/* Validate one complete frame delimited by the caller. Returns the frame
+   length if it is addressed to this slave (or broadcast) with a valid CRC,
+   0 if it is for another slave, or -1 with errno EMBBADDATA (too short) or
+   EMBBADCRC. */
+int modbus_rtu_check_frame(modbus_t *ctx, uint8_t *adu, int length)
+{
+    if (length < _MODBUS_RTU_HEADER_LENGTH + 1 + _MODBUS_RTU_CHECKSUM_LENGTH ||
+        length > MODBUS_RTU_MAX_ADU_LENGTH) {
+        errno = EMBBADDATA;
+        return -1;
+    }
+
+    return _modbus_rtu_check_integrity(ctx, adu, length);
+}
+#endif
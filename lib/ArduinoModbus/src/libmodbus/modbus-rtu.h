@@ -20,6 +20,12 @@ MODBUS_BEGIN_DECLS
 #ifdef ARDUINO
 class RS485Class;
 MODBUS_API modbus_t* modbus_new_rtu(RS485Class *rs485, unsigned long baud, uint16_t config);
+
+/* Frame transport: the caller delimits requests (t3.5 silence) and transmits
+   each reply ADU, CRC included, through send instead of an RS485Class port */
+typedef int (*modbus_rtu_frame_send_t)(void *context, const uint8_t *adu, int length);
+MODBUS_API modbus_t* modbus_new_rtu_frames(modbus_rtu_frame_send_t send, void *context);
+MODBUS_API int modbus_rtu_check_frame(modbus_t *ctx, uint8_t *adu, int length);
 #else
 MODBUS_API modbus_t* modbus_new_rtu(const char *device, int baud, char parity,
                                     int data_bit, int stop_bit);
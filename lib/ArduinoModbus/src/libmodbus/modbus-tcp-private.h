@@ -33,6 +33,10 @@ typedef struct _modbus_tcp {
 #ifdef ARDUINO
     IPAddress ip;
     Client* client;
+    /* ADU being assembled by modbus_tcp_receive_nb(), kept across calls */
+    uint8_t rx_buf[MODBUS_TCP_MAX_ADU_LENGTH];
+    int rx_length;
+    uint32_t rx_start_us;  /* micros() when the first byte of rx_buf was read */
 #else
     /* IP address */
     char ip[16];
@@ -770,6 +770,7 @@ int modbus_tcp_accept(modbus_t *ctx, int *s)
     modbus_tcp_t *ctx_tcp = (modbus_tcp_t*)ctx->backend_data;
 
     ctx_tcp->client = client;
+    ctx_tcp->rx_length = 0;
 
     return 0;
 #else
@@ -796,6 +797,73 @@ int modbus_tcp_accept(modbus_t *ctx, int *s)
 #endif
 }
 
+#ifdef ARDUINO
+/* Non-blocking indication receive: reads only the bytes already available,
+   assembling the MBAP header and then the PDU across calls. Bytes beyond the
+   current ADU stay in the client buffer for the next call, so a caller can
+   loop until 0 to handle every complete request already received.
+   Returns the ADU length when one is complete (copied to req, with the
+   micros() time its first byte was read in rx_start_us if not NULL), 0 when
+   more bytes are needed, or -1 with errno EMBBADDATA on an invalid MBAP header. */
+int modbus_tcp_receive_nb(modbus_t *ctx, uint8_t *req, uint32_t *rx_start_us)
+{
+    if (ctx == NULL || req == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    modbus_tcp_t *ctx_tcp = (modbus_tcp_t*)ctx->backend_data;
+
+    if (ctx_tcp->client == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    for (;;) {
+        int adu_length = _MODBUS_TCP_HEADER_LENGTH;
+
+        if (ctx_tcp->rx_length >= _MODBUS_TCP_HEADER_LENGTH) {
+            const uint8_t *mbap = ctx_tcp->rx_buf;
+            /* Length field counts the unit identifier and the PDU */
+            int length_field = (mbap[4] << 8) | mbap[5];
+
+            if (mbap[2] != 0 || mbap[3] != 0 || length_field < 2 ||
+                6 + length_field > MODBUS_TCP_MAX_ADU_LENGTH) {
+                ctx_tcp->rx_length = 0;
+                errno = EMBBADDATA;
+                return -1;
+            }
+            adu_length = 6 + length_field;
+
+            if (ctx_tcp->rx_length == adu_length) {
+                memcpy(req, ctx_tcp->rx_buf, adu_length);
+                if (rx_start_us != NULL) {
+                    *rx_start_us = ctx_tcp->rx_start_us;
+                }
+                ctx_tcp->rx_length = 0;
+                return adu_length;
+            }
+        }
+
+        int available = ctx_tcp->client->available();
+        if (available <= 0) {
+            return 0;
+        }
+
+        int wanted = adu_length - ctx_tcp->rx_length;
+        int rc = ctx_tcp->client->read(ctx_tcp->rx_buf + ctx_tcp->rx_length,
+                                       available < wanted ? available : wanted);
+        if (rc <= 0) {
+            return 0;
+        }
+        if (ctx_tcp->rx_length == 0) {
+            ctx_tcp->rx_start_us = micros();
+        }
+        ctx_tcp->rx_length += rc;
+    }
+}
+#endif
+
 #ifndef ARDUINO
 int modbus_tcp_pi_accept(modbus_t *ctx, int *s)
 {
@@ -964,6 +1032,7 @@ modbus_t* modbus_new_tcp(const char *ip, int port)
 #ifdef ARDUINO
     ctx_tcp->client = client;
     ctx_tcp->ip = ip_address;
+    ctx_tcp->rx_length = 0;
 #else
     if (ip != NULL) {
         dest_size = sizeof(char) * 16;
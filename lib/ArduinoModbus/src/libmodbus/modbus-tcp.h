@@ -64,6 +64,7 @@ MODBUS_API modbus_t* modbus_new_tcp(Client* client, IPAddress ip_address, int po
 MODBUS_API int modbus_tcp_accept(modbus_t *ctx, Client* client);
 #endif
 MODBUS_API int modbus_tcp_listen(modbus_t *ctx);
+MODBUS_API int modbus_tcp_receive_nb(modbus_t *ctx, uint8_t *req, uint32_t *rx_start_us);
 #else
 MODBUS_API modbus_t* modbus_new_tcp(const char *ip_address, int port);
 MODBUS_API int modbus_tcp_listen(modbus_t *ctx, int nb_connection);
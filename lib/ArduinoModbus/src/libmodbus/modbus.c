@@ -693,6 +693,21 @@ static int check_confirmation(modbus_t *ctx, uint8_t *req,
     return rc;
 }
 
+#ifdef ARDUINO
+/* Check a response the caller received against the request ADU it answers
+   (for contexts without a receive path, see modbus_new_rtu_frames()) */
+int modbus_check_confirmation(modbus_t *ctx, uint8_t *req,
+                              uint8_t *rsp, int rsp_length)
+{
+    if (ctx == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    return check_confirmation(ctx, req, rsp, rsp_length);
+}
+#endif
+
 static int response_io_status(uint8_t *tab_io_status,
                               int address, int nb,
                               uint8_t *rsp, int offset)
@@ -736,11 +751,13 @@ static int response_exception(modbus_t *ctx, sft_t *sft,
         va_end(ap);
     }
 
-    /* Flush if required */
-    if (to_flush) {
+    /* Flush if required. Not on TCP: the MBAP length already delimits the
+       request, and flushing would drop requests pipelined behind it */
+    if (to_flush && ctx->backend->backend_type != _MODBUS_BACKEND_TYPE_TCP) {
         _sleep_response_timeout(ctx);
         modbus_flush(ctx);
     }
+    ctx->reply_exception = exception_code;
 
     /* Build exception response */
     sft->function = sft->function + 0x80;
@@ -772,6 +789,7 @@ int modbus_reply(modbus_t *ctx, const uint8_t *req,
         return -1;
     }
 
+    ctx->reply_exception = 0;
     offset = ctx->backend->header_length;
     slave = req[offset - 1];
     function = req[offset];
@@ -976,11 +994,11 @@ int modbus_reply(modbus_t *ctx, const uint8_t *req,
     }
         break;
     case MODBUS_FC_READ_EXCEPTION_STATUS:
-        if (ctx->debug) {
-            fprintf(stderr, "FIXME Not implemented\n");
-        }
-        errno = ENOPROTOOPT;
-        return -1;
+        /* Not implemented: answer like any unsupported function instead of
+           leaving the master to time out */
+        rsp_length = response_exception(
+            ctx, &sft, MODBUS_EXCEPTION_ILLEGAL_FUNCTION, rsp, TRUE,
+            "Read exception status is not supported\n");
         break;
     case MODBUS_FC_MASK_WRITE_REGISTER: {
         int mapping_address = address - mb_mapping->start_registers;
@@ -1087,6 +1105,7 @@ int modbus_reply_exception(modbus_t *ctx, const uint8_t *req,
     /* Positive exception code */
     if (exception_code < MODBUS_EXCEPTION_MAX) {
         rsp[rsp_length++] = exception_code;
+        ctx->reply_exception = exception_code;
         return send_msg(ctx, rsp, rsp_length);
     } else {
         errno = EINVAL;
@@ -1094,6 +1113,62 @@ int modbus_reply_exception(modbus_t *ctx, const uint8_t *req,
     }
 }
 
+/* Reply to a request through an application PDU handler, with the same
+   framing, exception and broadcast handling as modbus_reply() */
+int modbus_reply_pdu(modbus_t *ctx, const uint8_t *req, int req_length,
+                     modbus_pdu_handler_t handler, void *context)
+{
+    int offset;
+    int slave;
+    int pdu_length;
+    int rc;
+    uint8_t rsp[MAX_MESSAGE_LENGTH];
+    uint8_t rsp_pdu[MODBUS_MAX_PDU_LENGTH];
+    int rsp_length;
+    sft_t sft;
+
+    if (ctx == NULL || handler == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    ctx->reply_exception = 0;
+    offset = ctx->backend->header_length;
+    slave = req[offset - 1];
+    pdu_length = req_length - offset - ctx->backend->checksum_length;
+
+    sft.slave = slave;
+    sft.function = req[offset];
+    sft.t_id = ctx->backend->prepare_response_tid(req, &req_length);
+
+    rc = handler(context, req + offset, pdu_length, rsp_pdu);
+    if (rc <= 0 || rc > MODBUS_MAX_PDU_LENGTH) {
+        int exception_code = (rc < 0) ? -rc : MODBUS_EXCEPTION_SLAVE_OR_SERVER_FAILURE;
+        sft.function = sft.function + 0x80;
+        rsp_length = ctx->backend->build_response_basis(&sft, rsp);
+        rsp[rsp_length++] = exception_code;
+        ctx->reply_exception = exception_code;
+    } else {
+        sft.function = rsp_pdu[0];
+        rsp_length = ctx->backend->build_response_basis(&sft, rsp);
+        memcpy(rsp + rsp_length, rsp_pdu + 1, rc - 1);
+        rsp_length += rc - 1;
+    }
+
+    /* Suppress any responses when the request was a broadcast */
+    return (slave == MODBUS_BROADCAST_ADDRESS) ? 0 : send_msg(ctx, rsp, rsp_length);
+}
+
+int modbus_get_reply_exception(modbus_t *ctx)
+{
+    if (ctx == NULL) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    return ctx->reply_exception;
+}
+
 /* Reads IO status */
 static int read_io_status(modbus_t *ctx, int function,
                           int addr, int nb, uint8_t *dest)
@@ -1632,6 +1707,8 @@ void _modbus_init_common(modbus_t *ctx)
 
     ctx->byte_timeout.tv_sec = 0;
     ctx->byte_timeout.tv_usec = _BYTE_TIMEOUT;
+
+    ctx->reply_exception = 0;
 }
 
 /* Define the slave number */
@@ -59,6 +59,7 @@ MODBUS_BEGIN_DECLS
 #define MODBUS_FC_WRITE_SINGLE_COIL         0x05
 #define MODBUS_FC_WRITE_SINGLE_REGISTER     0x06
 #define MODBUS_FC_READ_EXCEPTION_STATUS     0x07
+#define MODBUS_FC_DIAGNOSTICS               0x08
 #define MODBUS_FC_WRITE_MULTIPLE_COILS      0x0F
 #define MODBUS_FC_WRITE_MULTIPLE_REGISTERS  0x10
 #define MODBUS_FC_REPORT_SLAVE_ID           0x11
@@ -226,12 +227,25 @@ MODBUS_API int modbus_send_raw_request(modbus_t *ctx, uint8_t *raw_req, int raw_
 MODBUS_API int modbus_receive(modbus_t *ctx, uint8_t *req);
 
 MODBUS_API int modbus_receive_confirmation(modbus_t *ctx, uint8_t *rsp);
+#ifdef ARDUINO
+MODBUS_API int modbus_check_confirmation(modbus_t *ctx, uint8_t *req,
+                                         uint8_t *rsp, int rsp_length);
+#endif
 
 MODBUS_API int modbus_reply(modbus_t *ctx, const uint8_t *req,
                             int req_length, modbus_mapping_t *mb_mapping);
 MODBUS_API int modbus_reply_exception(modbus_t *ctx, const uint8_t *req,
                                       unsigned int exception_code);
 
+/* Application handler for a function code libmodbus does not implement.
+   Writes the response PDU (function code first) to rsp_pdu and returns its
+   length, or returns -exception_code to send an exception response. */
+typedef int (*modbus_pdu_handler_t)(void *context, const uint8_t *pdu,
+                                    int pdu_length, uint8_t *rsp_pdu);
+MODBUS_API int modbus_reply_pdu(modbus_t *ctx, const uint8_t *req, int req_length,
+                                modbus_pdu_handler_t handler, void *context);
+MODBUS_API int modbus_get_reply_exception(modbus_t *ctx);
+
 /**
  * UTILS FUNCTIONS
  **/
@@ -0,0 +1,120 @@
+"""Compile the web UI in data/ into include/web_assets.h.
+
+Every asset that shrinks is gzip-compressed (deterministic: mtime 0) and each is
+named by a hash of its content, so the firmware can serve it straight from XIP
+flash with Content-Encoding: gzip, a strong ETag and a long Cache-Control.
+index.html is rewritten to reference the hashed names and revalidates on every
+load; the hashed files themselves never change and are cached for a year.
+
+Runs before each build as a PlatformIO extra script, or by hand:
+    python scripts/embed_web_assets.py
+"""
+
+import gzip
+import hashlib
+import os
+
+try:
+    Import("env")  # noqa: F821 - provided by PlatformIO/SCons
+    PROJECT_DIR = env["PROJECT_DIR"]  # noqa: F821
+except NameError:
+    PROJECT_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+DATA_DIR = os.path.join(PROJECT_DIR, "data")
+OUTPUT = os.path.join(PROJECT_DIR, "include", "web_assets.h")
+
+# Served file, content type, referenced from index.html (gets a hashed URL)
+ASSETS = [
+    ("styles.css", "text/css", True),
+    ("script.js", "application/javascript", True),
+    ("logo.png", "image/png", True),
+    ("favicon.ico", "image/x-icon", False),
+]
+INDEX = ("index.html", "text/html")
+HASH_LENGTH = 12
+
+
+def content_hash(data):
+    return hashlib.sha256(data).hexdigest()[:HASH_LENGTH]
+
+
+def hashed_name(name, digest):
+    stem, ext = os.path.splitext(name)
+    return "%s.%s%s" % (stem, digest, ext)
+
+
+def c_array(symbol, data):
+    lines = ["static const uint8_t %s[%d] = {" % (symbol, len(data))]
+    for i in range(0, len(data), 16):
+        lines.append("    " + ", ".join("0x%02X" % b for b in data[i:i + 16]) + ",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def build():
+    arrays = []
+    entries = []
+
+    def add(name, content_type, data, urls):
+        digest = content_hash(data)
+        symbol = "WEB_ASSET_" + name.replace(".", "_").upper()
+        compressed = gzip.compress(data, compresslevel=9, mtime=0)
+        # Already-compressed formats (PNG) are stored as they are
+        gzipped = len(compressed) < len(data)
+        stored = compressed if gzipped else data
+        arrays.append(c_array(symbol, stored))
+        for url, immutable in urls:
+            entries.append('    {"/%s", "/%s", "%s", "\\"%s\\"", %s, %d, %s, %s},' % (
+                url, name, content_type, digest, symbol, len(stored),
+                "true" if gzipped else "false", "true" if immutable else "false"))
+        return digest, len(data), len(stored)
+
+    report = []
+    index_path = os.path.join(DATA_DIR, INDEX[0])
+    index = open(index_path, "rb").read() if os.path.exists(index_path) else None
+
+    for name, content_type, referenced in ASSETS:
+        path = os.path.join(DATA_DIR, name)
+        if not os.path.exists(path):
+            continue
+        data = open(path, "rb").read()
+        digest = content_hash(data)
+        urls = [(name, False)]
+        if referenced:
+            urls.append((hashed_name(name, digest), True))
+            if index is not None:
+                for quote in (b'"', b"'"):
+                    index = index.replace(quote + name.encode() + quote,
+                                          quote + hashed_name(name, digest).encode() + quote)
+        report.append((name,) + add(name, content_type, data, urls))
+
+    if index is not None:
+        report.append((INDEX[0],) + add(INDEX[0], INDEX[1], index, [(INDEX[0], False)]))
+
+    out = [
+        "// Generated by scripts/embed_web_assets.py from data/ - do not edit",
+        "#pragma once",
+        "",
+    ]
+    out.extend(arrays)
+    out.append("")
+    if entries:
+        out.append("static const WebAsset WEB_ASSETS[] = {")
+        out.extend(entries)
+        out.append("};")
+    else:
+        out.append("static const WebAsset WEB_ASSETS[1] = {};")
+    out.append("#define WEB_ASSET_COUNT %d" % len(entries))
+    out.append("")
+    text = "\n".join(out)
+
+    # Leave the header untouched when nothing changed, so main.cpp is not rebuilt
+    if os.path.exists(OUTPUT) and open(OUTPUT).read() == text:
+        return
+    with open(OUTPUT, "w") as f:
+        f.write(text)
+    for name, digest, size, compressed in report:
+        print("web asset %-12s %s %7d -> %6d bytes" % (name, digest, size, compressed))
+
+
+build()
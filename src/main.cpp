@@ -1,6 +1,5 @@
 #include "sys_init.h"
-#include <Adafruit_LIS3DH.h>
-#include <Adafruit_Sensor.h>
+#include "web_assets.h"  // Generated from data/ by scripts/embed_web_assets.py
 
 // Sensor reading functions
 bool readSHT30(uint8_t sensorIndex, float& temperature, float& humidity);
@@ -12,16 +11,16 @@ float evaluateCalibrationExpression(float x, const SensorConfig& sensor);
 float applyCalibration(float rawValue, const SensorConfig& sensor);
 float applyCalibrationB(float rawValue, const SensorConfig& sensor);
 float applyCalibrationC(float rawValue, const SensorConfig& sensor);
-void handleLIS3DHSensors();  // Forward declaration for LIS3DH polling handler
 // Use ANALOG_INPUTS from sys_init.h instead of ADC_PINS
-#include "Ezo_i2c.h"
-
-// LIS3DH accelerometer instances (one per sensor, max 8 sensors)
-Adafruit_LIS3DH* lis3dhSensors[MAX_SENSORS] = {nullptr};
 
 // SensorConfig array definition (from sys_init.h extern)
 SensorConfig configuredSensors[MAX_SENSORS] = {};
+SensorSnapshot sensorSnapshots[MAX_SENSORS] = {};  // Written by core1, read by core0
+volatile bool sensorRegistersDirty[MAX_SENSORS] = {};  // Set by core1 on publish, cleared by core0 once pushed to Modbus
+auto_init_mutex(adcMutex);  // analogRead() is used from both cores
 int numConfiguredSensors = 0;
+uint32_t sensorConfigGeneration = 0;  // Bumped when the sensor list is reloaded; /events streams resend every sensor
+IOChangeTracker ioChanges = {};      // Change sequences behind /iostatus?since=N
 
 // Preset table for named sensors
 struct SensorPreset {
@@ -43,7 +42,7 @@ const SensorPreset sensorPresets[] = {
     { "EZO_EC", "I2C", {0x52, 0x00}, 1, 5000, 900 },
     { "EZO_DO", "I2C", {0x52, 0x00}, 1, 5000, 900 },
     { "EZO_RTD", "I2C", {0x52, 0x00}, 1, 5000, 900 },
-    // LIS3DH: 3-axis accelerometer, I2C, 1s polling, direct register read (no command)
+    // LIS3DH: 3-axis accelerometer, I2C, FIFO stream; updateInterval is the feature window
     { "LIS3DH", "I2C", {0x00, 0x00}, 0, 1000, 0 },
     // Add more named sensors here as needed
 };
@@ -95,14 +94,14 @@ void applySensorPresets() {
             if (configuredSensors[i].i2cAddress == 0) configuredSensors[i].i2cAddress = 0x76;
             if (strlen(configuredSensors[i].protocol) == 0) strcpy(configuredSensors[i].protocol, "I2C");
             if (configuredSensors[i].updateInterval == 0) configuredSensors[i].updateInterval = 1000;
-            if (configuredSensors[i].modbusRegister == 0) configuredSensors[i].modbusRegister = 16;
+            if (configuredSensors[i].modbusRegister == 0) configuredSensors[i].modbusRegister = 9;  // Clear of SHT30 at 15-16
         } else if (strcmp(configuredSensors[i].type, "DS18B20") == 0) {
             if (strlen(configuredSensors[i].protocol) == 0) strcpy(configuredSensors[i].protocol, "One-Wire");
             if (configuredSensors[i].updateInterval == 0) configuredSensors[i].updateInterval = 2000;
             if (configuredSensors[i].modbusRegister == 0) configuredSensors[i].modbusRegister = 14;
         } else if (strcmp(configuredSensors[i].type, "LIS3DH") == 0) {
             if (configuredSensors[i].i2cAddress == 0) configuredSensors[i].i2cAddress = 0x18;
-            // LIS3DH uses direct register read, NOT a command - clear any existing command
+            // LIS3DH is streamed from its FIFO, NOT a command - clear any existing command
             memset(configuredSensors[i].command, 0, sizeof(configuredSensors[i].command));
             if (strlen(configuredSensors[i].protocol) == 0) strcpy(configuredSensors[i].protocol, "I2C");
             if (configuredSensors[i].updateInterval == 0) configuredSensors[i].updateInterval = 1000;
@@ -165,6 +164,7 @@ void applySensorPresets() {
 // Global object definitions
 Config config; // Define the actual config object
 IOStatus ioStatus = {};
+IOMasks ioMasks = {};
 
 // Network configuration for W5500
 uint8_t mac[] = {0xDE, 0xAD, 0xBE, 0xEF, 0xFE, 0xED};
@@ -174,39 +174,76 @@ WiFiServer modbusServer(502);
 WiFiServer httpServer(80);    // HTTP server on port 80
 WiFiClient client;
 ModbusClientConnection modbusClients[MAX_MODBUS_CLIENTS];
+HttpConnection httpConnections[MAX_HTTP_CONNECTIONS];
+HttpExchange httpExchange = {};
+HttpServerStats httpServerStats = {};
+bool fileSystemMounted = false;
+ModbusTCPServer modbusImage;  // Coil/register maps shared by every client connection
 int connectedClients = 0;
-
-// Bus operation queues are declared in sys_init.h
-extern BusOperation i2cQueue[MAX_SENSORS];
-extern BusOperation uartQueue[MAX_SENSORS];
-extern BusOperation oneWireQueue[MAX_SENSORS];
-extern int i2cQueueSize;
-extern int uartQueueSize;
-extern int oneWireQueueSize;
-
-// Command arrays for each bus type
-CommandArray i2cCommands;
-CommandArray uartCommands;
-CommandArray oneWireCommands;
+ModbusPoolStats modbusPoolStats = {};
+ModbusTrafficStats modbusTotals = {};
+ModbusFunctionStats modbusFunctionStats[MODBUS_STAT_FUNCTIONS] = {};
+ModbusDiagnosticCounters modbusDiagCounters = {};
+ModbusLatencyHistogram coilProcessingLatency = {};  // FC05/FC15 first byte read by the firmware to output pin written
+ModbusRTULink modbusRtu = {.port = -1, .uart = NULL, .dePin = -1, .charUs = 0, .t35Us = 0, .dmaTx = -1};
+ModbusRTUStats modbusRtuStats = {};
+GatewayConfig gatewayConfig = {.responseTimeoutMs = MODBUS_GATEWAY_DEFAULT_TIMEOUT_MS, .pollCount = 0};
+ModbusGateway modbusGateway = {};
+ModbusGatewayStats modbusGatewayStats = {};
+int modbusHoldingRegisterCount = 0;     // Table sizes set by resizeModbusImage()
+int modbusCoilCount = 0;
+int modbusDiscreteInputCount = 0;
+const uint8_t MODBUS_STAT_FUNCTION_CODES[MODBUS_STAT_FUNCTIONS] = {1, 2, 3, 4, 5, 6, 8, 15, 16, 0};  // 0 = other
+const uint32_t MODBUS_LATENCY_BOUNDS_US[MODBUS_LATENCY_BUCKETS] = {250, 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000, UINT32_MAX};
+unsigned long lastDiagRefreshMs = 0;
+
+// Compiled register map (rebuilt by compileRegisterMap(), read by updateModbusImage() on core0)
+RegisterMapEntry registerMap[MAX_REGISTER_MAP_ENTRIES];
+uint16_t registerMapStart[MAX_SENSORS]; // First entry of each sensor
+uint8_t registerMapCount[MAX_SENSORS];  // Entries per sensor (0 = disabled/unmapped)
+const char* registerMapConflict[MAX_SENSORS]; // Why a sensor's fixed-window registers were not mapped, or NULL
+int registerMapConflictCount = 0;      // Enabled sensors left out for a register conflict
+bool registerImageStale = true;         // Sensor registers must be cleared and rewritten
+int modbusInputRegisterCount = MODBUS_DIAG_BASE + MODBUS_DIAG_REGISTERS;  // Grows to cover the packed block
+int packedSensorCount = 0;              // Sensors with a record in the packed block
+int packedRegisterCount = 0;            // Packed block length including the header
+uint32_t lastPackedRefreshMs = 0;
+
+// Deadline scheduler for every polled sensor (I2C, UART, One-Wire)
+SensorScheduler sensorSchedule;
 
 // Bus operation queues
-BusOperation i2cQueue[MAX_SENSORS];
-BusOperation uartQueue[MAX_SENSORS];
-BusOperation oneWireQueue[MAX_SENSORS];
-int i2cQueueSize = 0;
-int uartQueueSize = 0;
-int oneWireQueueSize = 0;
-
-// Command queues are already declared as extern above
+BusQueue i2cQueue;
+BusQueue uartQueue;
+BusQueue oneWireQueue;
+bool sensorQueued[MAX_SENSORS] = {false};  // O(1) duplicate check across all bus queues
 
 // Forward declarations for functions used before definition
-void handleSimpleHTTP();
-void updateIOForClient(int clientIndex);
+void pollHttpServer();
+void updateModbusImage();
+void readModbusEncoding(JsonObject sensor, SensorConfig& cfg);
+void readModbusEncodings(JsonObject sensor, RegisterEncoding encodings[3]);
+int sensorRegisterSpan(const char* type, const RegisterEncoding encodings[3]);
+void writeModbusEncoding(JsonObject sensor, const SensorConfig& cfg);
+int registerAddressFor(int sensorIndex, RegisterSource source, uint8_t feature = 0);
+int32_t sensorModbusValue(const SensorConfig& sensor, int output, float value);
+const char* registerEncodingName(RegisterEncoding encoding);
 void routeRequest(WiFiClient& client, String method, String path, String body);
 void sendFile(WiFiClient& client, String filename, String contentType);
+const WebAsset* findWebAsset(const char* path);
+void sendWebAsset(WiFiClient& client, const WebAsset& asset);
 void send404(WiFiClient& client);
 void sendJSONConfig(WiFiClient& client);
 void sendJSONIOStatus(WiFiClient& client);
+void fillIOStatusSensor(JsonObject sensor, int i, const SensorValues& values);
+void fillSensorReadings(JsonObject sensor, int i, const SensorValues& values);
+void trackIOChanges();
+const char* queryParam(const char* query, const char* name);
+void sendJSONIOStatusDelta(WiFiClient& client, uint32_t since);
+void printIOBitChanges(Print& out, const char* name, uint8_t bits, const uint32_t* sequences, uint32_t since);
+void printIOBits(Print& out, const char* name, uint8_t bits);
+void startEventStream(WiFiClient& client);
+void pumpEventStream(int slot);
 void sendJSONIOConfig(WiFiClient& client);
 void sendJSONSensorData(WiFiClient& client);
 void sendJSONSensorConfig(WiFiClient& client);
@@ -219,21 +256,41 @@ void handlePOSTResetSingleLatch(WiFiClient& client, String body);
 void handlePOSTSensorConfig(WiFiClient& client, String body);
 void handlePOSTSensorCommand(WiFiClient& client, String body);
 void handlePOSTSensorPoll(WiFiClient& client, String body);
+void handlePOSTModbusGateway(WiFiClient& client, String body);
 // TODO: Implement Poll Now functionality
-bool validateCRC(uint8_t* data, size_t length) {
+
+// Dallas/Maxim CRC8 (polynomial x^8 + x^5 + x^4 + 1, reflected 0x8C), one lookup per byte
+const uint8_t DALLAS_CRC8_TABLE[256] = {
+    0x00, 0x5E, 0xBC, 0xE2, 0x61, 0x3F, 0xDD, 0x83, 0xC2, 0x9C, 0x7E, 0x20, 0xA3, 0xFD, 0x1F, 0x41,
+    0x9D, 0xC3, 0x21, 0x7F, 0xFC, 0xA2, 0x40, 0x1E, 0x5F, 0x01, 0xE3, 0xBD, 0x3E, 0x60, 0x82, 0xDC,
+    0x23, 0x7D, 0x9F, 0xC1, 0x42, 0x1C, 0xFE, 0xA0, 0xE1, 0xBF, 0x5D, 0x03, 0x80, 0xDE, 0x3C, 0x62,
+    0xBE, 0xE0, 0x02, 0x5C, 0xDF, 0x81, 0x63, 0x3D, 0x7C, 0x22, 0xC0, 0x9E, 0x1D, 0x43, 0xA1, 0xFF,
+    0x46, 0x18, 0xFA, 0xA4, 0x27, 0x79, 0x9B, 0xC5, 0x84, 0xDA, 0x38, 0x66, 0xE5, 0xBB, 0x59, 0x07,
+    0xDB, 0x85, 0x67, 0x39, 0xBA, 0xE4, 0x06, 0x58, 0x19, 0x47, 0xA5, 0xFB, 0x78, 0x26, 0xC4, 0x9A,
+    0x65, 0x3B, 0xD9, 0x87, 0x04, 0x5A, 0xB8, 0xE6, 0xA7, 0xF9, 0x1B, 0x45, 0xC6, 0x98, 0x7A, 0x24,
+    0xF8, 0xA6, 0x44, 0x1A, 0x99, 0xC7, 0x25, 0x7B, 0x3A, 0x64, 0x86, 0xD8, 0x5B, 0x05, 0xE7, 0xB9,
+    0x8C, 0xD2, 0x30, 0x6E, 0xED, 0xB3, 0x51, 0x0F, 0x4E, 0x10, 0xF2, 0xAC, 0x2F, 0x71, 0x93, 0xCD,
+    0x11, 0x4F, 0xAD, 0xF3, 0x70, 0x2E, 0xCC, 0x92, 0xD3, 0x8D, 0x6F, 0x31, 0xB2, 0xEC, 0x0E, 0x50,
+    0xAF, 0xF1, 0x13, 0x4D, 0xCE, 0x90, 0x72, 0x2C, 0x6D, 0x33, 0xD1, 0x8F, 0x0C, 0x52, 0xB0, 0xEE,
+    0x32, 0x6C, 0x8E, 0xD0, 0x53, 0x0D, 0xEF, 0xB1, 0xF0, 0xAE, 0x4C, 0x12, 0x91, 0xCF, 0x2D, 0x73,
+    0xCA, 0x94, 0x76, 0x28, 0xAB, 0xF5, 0x17, 0x49, 0x08, 0x56, 0xB4, 0xEA, 0x69, 0x37, 0xD5, 0x8B,
+    0x57, 0x09, 0xEB, 0xB5, 0x36, 0x68, 0x8A, 0xD4, 0x95, 0xCB, 0x29, 0x77, 0xF4, 0xAA, 0x48, 0x16,
+    0xE9, 0xB7, 0x55, 0x0B, 0x88, 0xD6, 0x34, 0x6A, 0x2B, 0x75, 0x97, 0xC9, 0x4A, 0x14, 0xF6, 0xA8,
+    0x74, 0x2A, 0xC8, 0x96, 0x15, 0x4B, 0xA9, 0xF7, 0xB6, 0xE8, 0x0A, 0x54, 0xD7, 0x89, 0x6B, 0x35
+};
+
+uint8_t crc8Dallas(const uint8_t* data, size_t length) {
     uint8_t crc = 0;
-    
-    for (size_t i = 0; i < length - 1; i++) {
-        uint8_t inbyte = data[i];
-        for (uint8_t j = 0; j < 8; j++) {
-            uint8_t mix = (crc ^ inbyte) & 0x01;
-            crc >>= 1;
-            if (mix) crc ^= 0x8C;
-            inbyte >>= 1;
-        }
+    for (size_t i = 0; i < length; i++) {
+        crc = DALLAS_CRC8_TABLE[crc ^ data[i]];
     }
-    
-    return crc == data[length - 1];
+    return crc;
+}
+
+// Validate a One-Wire block whose last byte is the CRC of the preceding bytes
+bool validateCRC(uint8_t* data, size_t length) {
+    if (length < 2) return false;
+    return crc8Dallas(data, length - 1) == data[length - 1];
 }
 
 void setPinModes();
@@ -241,6 +298,21 @@ void setupEthernet();
 void reapplyNetworkConfig();
 void reapplySensorConfig();
 void setupModbus();
+void acceptModbusClient(WiFiClient& newClient);
+bool openModbusRTU();
+void closeModbusRTU();
+void pollModbusRTU();
+void recordModbusRTURequest(void* context, const ModbusRequestInfo& info);
+void resizeModbusImage();
+int gatewayTableEnd(uint8_t function);
+void compileGatewayReads();
+void pollModbusGateway();
+void queueGatewayWrites(uint8_t function, int address, int count);
+void forwardModbusRegisterWrite(void* context, int address, int count, uint32_t startedUs);
+void closeModbusClient(int slot, const char* reason);
+void recordModbusRequest(void* context, const ModbusRequestInfo& info);
+void applyModbusCoilWrite(void* context, int address, int count, uint32_t startedUs);
+int handleModbusDiagnostics(void* context, const uint8_t* pdu, int pduLength, uint8_t* rsp);
 void setupWebServer();
 
 // Terminal monitoring function declarations
@@ -255,18 +327,75 @@ String executeTerminalCommand(String command, String pin, String protocol);
 void processI2CQueue();
 void processUARTQueue();
 void processOneWireQueue();
-void enqueueBusOperation(uint8_t sensorIndex, const char* protocol);
+SensorBus sensorBusForProtocol(const char* protocol);
+bool isEzoType(const char* type);
+void enqueueBusOperation(const SensorCommand& cmd);
+void rebuildSensorSchedule();
 void updateBusQueues();
+void updateAnalogSensors();
+
+// Dual-core sensor engine (core1 owns every sensor bus)
+void publishSensorSnapshots();
+void readSensorValues(int sensorIndex, SensorValues& values);
+void pauseSensorCore();
+void resumeSensorCore();
 // validateCRC is already declared above
 
 // CRC validation for One-Wire sensors is implemented above
 
+// Record a completed read and update the measured read rate for a sensor
+void recordSensorRead(int sensorIndex, unsigned long now) {
+    SensorConfig& sensor = configuredSensors[sensorIndex];
+    if (sensor.readCount > 0) {
+        float interval = (float)(now - sensor.lastReadTime);
+        // Exponential moving average so a single slow read doesn't swamp the figure
+        sensor.measuredIntervalMs = (sensor.measuredIntervalMs <= 0.0f)
+            ? interval
+            : sensor.measuredIntervalMs + (interval - sensor.measuredIntervalMs) * 0.2f;
+    }
+    sensor.readCount++;
+    sensor.lastReadTime = now;
+}
+
+// Retire a finished operation so its sensor can be queued again
+void finishBusOperation(BusQueue& queue, uint8_t index) {
+    sensorQueued[queue.at(index).sensorIndex] = false;
+    queue.removeAt(index);
+}
+
+// Pick the next I2C operation that can use the bus right now.
+// Operations waiting out a conversion no longer block the bus: every in-flight
+// operation is checked, elapsed conversions are promoted, and reads are served
+// before new commands so results are collected as soon as they are available.
+int selectI2COperation(unsigned long currentTime) {
+    int readIndex = -1;
+    int idleIndex = -1;
+    for (uint8_t i = 0; i < i2cQueue.count; i++) {
+        BusOperation& candidate = i2cQueue.at(i);
+        if ((candidate.state == BusOpState::REQUEST_SENT || candidate.state == BusOpState::WAITING_CONVERSION) &&
+            currentTime - candidate.startTime >= candidate.conversionTime) {
+            candidate.state = BusOpState::READY_TO_READ;
+        }
+        if (candidate.state == BusOpState::ERROR) {
+            return i;
+        }
+        if (candidate.state == BusOpState::READY_TO_READ && readIndex < 0) {
+            readIndex = i;
+        } else if (candidate.state == BusOpState::IDLE && idleIndex < 0) {
+            idleIndex = i;
+        }
+    }
+    return readIndex >= 0 ? readIndex : idleIndex;
+}
+
 // Bus queue processor implementations
 void processI2CQueue() {
-    if (i2cQueueSize == 0) return;
+    if (i2cQueue.isEmpty()) return;
     
     unsigned long currentTime = millis();
-    BusOperation& op = i2cQueue[0];
+    int opIndex = selectI2COperation(currentTime);
+    if (opIndex < 0) return;  // Every operation is waiting on a conversion; bus stays free
+    BusOperation& op = i2cQueue.at(opIndex);
     
     switch(op.state) {
         case BusOpState::IDLE: {
@@ -276,148 +405,7 @@ void processI2CQueue() {
             // Check if sensor has a command to send
             bool hasCommand = strlen(configuredSensors[op.sensorIndex].command) > 0;
             
-            // Special handling for LIS3DH: atomic write+read without losing register pointer
-            if (strcmp(configuredSensors[op.sensorIndex].type, "LIS3DH") == 0) {
-                // LIS3DH: Write register address then read data
-                // Try normal transaction with full STOP and new START (more reliable than repeated START)
-                logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "TX", 
-                                "Register address: 0x28 (OUT_X_L, no auto-increment for first byte)", 
-                                String(configuredSensors[op.sensorIndex].name));
-                
-                // Step 1: Write register address WITHOUT auto-increment bit for first read
-                Wire.beginTransmission(configuredSensors[op.sensorIndex].i2cAddress);
-                Wire.write(0x28);  // Just 0x28, NO auto-increment yet - verify we're at the right register
-                int writeResult = Wire.endTransmission(true);  // true = STOP
-                
-                if (writeResult == 0) {
-                    logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "ACK", 
-                                    "Register 0x28 selected", 
-                                    String(configuredSensors[op.sensorIndex].name));
-                    
-                    delayMicroseconds(100);
-                    
-                    // Step 2: Read 1 byte from OUT_X_L to verify it's X data
-                    Wire.requestFrom((int)configuredSensors[op.sensorIndex].i2cAddress, 1);
-                    uint8_t x_low = 0;
-                    if (Wire.available()) {
-                        x_low = Wire.read();
-                        Serial.printf("[DEBUG] Single byte read from 0x28: 0x%02X\n", x_low);
-                    }
-                    
-                    // Step 3: Now read X_H from 0x29
-                    Wire.beginTransmission(configuredSensors[op.sensorIndex].i2cAddress);
-                    Wire.write(0x29);
-                    Wire.endTransmission(true);
-                    delayMicroseconds(100);
-                    
-                    Wire.requestFrom((int)configuredSensors[op.sensorIndex].i2cAddress, 1);
-                    uint8_t x_high = 0;
-                    if (Wire.available()) {
-                        x_high = Wire.read();
-                        Serial.printf("[DEBUG] Single byte read from 0x29: 0x%02X\n", x_high);
-                    }
-                    
-                    // Step 4: Now try auto-increment read of all 6 bytes starting from 0x28
-                    Wire.beginTransmission(configuredSensors[op.sensorIndex].i2cAddress);
-                    Wire.write(0xA8);  // 0x28 with auto-increment
-                    Wire.endTransmission(true);
-                    delayMicroseconds(100);
-                    
-                    Wire.requestFrom((int)configuredSensors[op.sensorIndex].i2cAddress, 6);
-                    
-                    if (Wire.available()) {
-                        char response[32] = {0};
-                        String rawHex = "";
-                        int idx = 0;
-                        
-                        while(Wire.available() && idx < 6) {
-                            uint8_t byte = Wire.read();
-                            response[idx++] = byte;
-                            if (rawHex.length() > 0) rawHex += " ";
-                            rawHex += "0x" + String(byte, HEX);
-                        }
-                        response[idx] = '\0';
-                        
-                        logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "RX", 
-                                        "Raw: [" + rawHex + "]", 
-                                        String(configuredSensors[op.sensorIndex].name));
-                        
-                        Serial.printf("[DEBUG] Full 6-byte read: [0x%02X 0x%02X 0x%02X 0x%02X 0x%02X 0x%02X]\n",
-                                    (uint8_t)response[0], (uint8_t)response[1],
-                                    (uint8_t)response[2], (uint8_t)response[3],
-                                    (uint8_t)response[4], (uint8_t)response[5]);
-                        
-                        Serial.printf("[DEBUG] Single bytes: X_L=0x%02X, X_H=0x%02X\n", x_low, x_high);
-                        
-                        // Parse LIS3DH data immediately in IDLE state
-                        if (idx >= 6) {
-                            // Extract raw 16-bit signed integers (little-endian)
-                            int16_t x_raw = ((uint8_t)response[1] << 8) | (uint8_t)response[0];
-                            int16_t y_raw = ((uint8_t)response[3] << 8) | (uint8_t)response[2];
-                            int16_t z_raw = ((uint8_t)response[5] << 8) | (uint8_t)response[4];
-                            
-                            // Debug: log raw values before shifting
-                            Serial.printf("[DEBUG] LIS3DH raw (before shift): X=0x%04X (%d), Y=0x%04X (%d), Z=0x%04X (%d)\n", 
-                                         (uint16_t)x_raw, x_raw, (uint16_t)y_raw, y_raw, (uint16_t)z_raw, z_raw);
-                            
-                            // LIS3DH in standard 10-bit mode (±2g range):
-                            // - Data occupies upper 10 bits (bits 15-6)
-                            // - Lower 6 bits are padding
-                            // - Right-shift by 6 to get actual 10-bit value (-512 to +511)
-                            // - Scale: ±2g / 512 LSB = 3.906 mg/LSB
-                            x_raw >>= 6;
-                            y_raw >>= 6;
-                            z_raw >>= 6;
-                            
-                            Serial.printf("[DEBUG] LIS3DH raw (after shift): X=%d, Y=%d, Z=%d\n", x_raw, y_raw, z_raw);
-                            
-                            float x_mg = (float)x_raw * 3.906f;  // ±2g standard mode: 3.906 mg/LSB
-                            float y_mg = (float)y_raw * 3.906f;
-                            float z_mg = (float)z_raw * 3.906f;
-                            
-                            configuredSensors[op.sensorIndex].rawValue = x_mg;
-                            configuredSensors[op.sensorIndex].rawValueB = y_mg;
-                            configuredSensors[op.sensorIndex].rawValueC = z_mg;
-                            
-                            float calibratedX = applyCalibration(x_mg, configuredSensors[op.sensorIndex]);
-                            float calibratedY = applyCalibrationB(y_mg, configuredSensors[op.sensorIndex]);
-                            float calibratedZ = applyCalibrationC(z_mg, configuredSensors[op.sensorIndex]);
-                            
-                            configuredSensors[op.sensorIndex].calibratedValue = calibratedX;
-                            configuredSensors[op.sensorIndex].calibratedValueB = calibratedY;
-                            configuredSensors[op.sensorIndex].calibratedValueC = calibratedZ;
-                            
-                            configuredSensors[op.sensorIndex].modbusValue = (int)(calibratedX * 100);
-                            configuredSensors[op.sensorIndex].modbusValueB = (int)(calibratedY * 100);
-                            configuredSensors[op.sensorIndex].modbusValueC = (int)(calibratedZ * 100);
-                            
-                            logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "VAL", 
-                                            "X: " + String(x_mg, 2) + " mg, Y: " + String(y_mg, 2) + " mg, Z: " + String(z_mg, 2) + " mg", 
-                                            String(configuredSensors[op.sensorIndex].name));
-                        } else {
-                            logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "ERR", 
-                                            "LIS3DH response too short: " + String(idx) + " bytes", 
-                                            String(configuredSensors[op.sensorIndex].name));
-                        }
-                    } else {
-                        logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "TIMEOUT", 
-                                        "No response after register set", 
-                                        String(configuredSensors[op.sensorIndex].name));
-                    }
-                } else {
-                    logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "NACK", 
-                                    "Failed to set register address, error: " + String(writeResult), 
-                                    String(configuredSensors[op.sensorIndex].name));
-                }
-                
-                // Move to next operation - LIS3DH handled completely in IDLE state
-                for(int i = 0; i < i2cQueueSize - 1; i++) {
-                    i2cQueue[i] = i2cQueue[i + 1];
-                }
-                i2cQueueSize--;
-                rp2040.wdt_reset();
-                return;
-            } else if (hasCommand) {
+            if (hasCommand) {
                 // Sanitize command: remove control chars except explicit \r or \n
                 String rawCmd = String(configuredSensors[op.sensorIndex].command);
                 String command = "";
@@ -496,7 +484,6 @@ void processI2CQueue() {
                 // Check if sensor needs delay before reading
                 bool hasCommand = strlen(configuredSensors[op.sensorIndex].command) > 0;
                 
-                // LIS3DH is handled completely in IDLE state, so skip state transitions for it
                 if (hasCommand && op.conversionTime > 0) {
                     op.state = BusOpState::REQUEST_SENT;
                     op.startTime = currentTime;
@@ -511,48 +498,30 @@ void processI2CQueue() {
                 if (++op.retryCount >= 3) {
                     logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "ERR", "Max retries exceeded", String(configuredSensors[op.sensorIndex].name));
                     // Move to next operation after 3 retries
-                    for(int i = 0; i < i2cQueueSize - 1; i++) {
-                        i2cQueue[i] = i2cQueue[i + 1];
-                    }
-                    i2cQueueSize--;
+                    finishBusOperation(i2cQueue, opIndex);
                 }
             }
             break;
         }
             
-        case BusOpState::REQUEST_SENT: {
-            if (currentTime - op.startTime >= op.conversionTime) {
-                op.state = BusOpState::READY_TO_READ;
-            }
-            break;
-        }
-        
-        case BusOpState::WAITING_CONVERSION: {
-            // Wait for conversion/delay time to elapse (used for LIS3DH register pointer setup)
-            if (currentTime - op.startTime >= op.conversionTime) {
-                op.state = BusOpState::READY_TO_READ;
-            }
+        case BusOpState::REQUEST_SENT:
+        case BusOpState::WAITING_CONVERSION:
+            // Conversions are promoted in selectI2COperation(); never selected while pending
             break;
-        }
             
         case BusOpState::READY_TO_READ: {
             // Per-op timeout: abort if this operation has been pending too long (3 seconds)
             if (op.startTime > 0 && currentTime - op.startTime > 3000) {
                 Serial.printf("[I2C] TIMEOUT: Sensor %d stuck in READY_TO_READ for 3s, removing from queue\n", op.sensorIndex);
                 configuredSensors[op.sensorIndex].rawValue = -1000.0;  // Mark as error
-                for(int i = 0; i < i2cQueueSize - 1; i++) {
-                    i2cQueue[i] = i2cQueue[i + 1];
-                }
-                i2cQueueSize--;
+                finishBusOperation(i2cQueue, opIndex);
                 rp2040.wdt_reset();
                 return;
             }
             
             // Determine how many bytes to request based on sensor type
             int bytesToRequest = 32;  // Default for most sensors
-            if (strcmp(configuredSensors[op.sensorIndex].type, "LIS3DH") == 0) {
-                bytesToRequest = 6;  // LIS3DH: OUT_X_L, OUT_X_H, OUT_Y_L, OUT_Y_H, OUT_Z_L, OUT_Z_H
-            } else if (strcmp(configuredSensors[op.sensorIndex].type, "SHT30") == 0) {
+            if (strcmp(configuredSensors[op.sensorIndex].type, "SHT30") == 0) {
                 bytesToRequest = 6;  // SHT30: 6 bytes (temp MSB/LSB/CRC + hum MSB/LSB/CRC)
             }
             
@@ -589,7 +558,7 @@ void processI2CQueue() {
                 }
                 strncpy(configuredSensors[op.sensorIndex].response, cleanResponse.c_str(), sizeof(configuredSensors[op.sensorIndex].response)-1);
                 configuredSensors[op.sensorIndex].response[sizeof(configuredSensors[op.sensorIndex].response)-1] = '\0';
-                configuredSensors[op.sensorIndex].lastReadTime = currentTime;
+                recordSensorRead(op.sensorIndex, currentTime);
                 
                 // Process response based on sensor type
                 if (strcmp(configuredSensors[op.sensorIndex].type, "SHT30") == 0) {
@@ -615,8 +584,8 @@ void processI2CQueue() {
                         configuredSensors[op.sensorIndex].calibratedValueB = calibratedHum;
                         
                         // Convert to Modbus values (scaled by 100 for decimal precision)
-                        configuredSensors[op.sensorIndex].modbusValue = (int)(calibratedTemp * 100);
-                        configuredSensors[op.sensorIndex].modbusValueB = (int)(calibratedHum * 100);
+                        configuredSensors[op.sensorIndex].modbusValue = sensorModbusValue(configuredSensors[op.sensorIndex], 0, calibratedTemp);
+                        configuredSensors[op.sensorIndex].modbusValueB = sensorModbusValue(configuredSensors[op.sensorIndex], 1, calibratedHum);
                         
                         logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "VAL", 
                                         "Temp: " + String(temperature) + "°C, Hum: " + String(humidity) + "%", 
@@ -626,77 +595,6 @@ void processI2CQueue() {
                                         "SHT30 response too short: " + String(idx) + " bytes", 
                                         String(configuredSensors[op.sensorIndex].name));
                     }
-                } else if (strcmp(configuredSensors[op.sensorIndex].type, "EZO-PH") == 0 || 
-                          strcmp(configuredSensors[op.sensorIndex].type, "EZO_PH") == 0) {
-                    // Atlas Scientific EZO PH protocol: first byte is status
-                    if (idx > 0) {
-                        uint8_t statusCode = (uint8_t)response[0];
-                        if (statusCode == 1) {
-                            // Success: parse ASCII data after status byte
-                            String dataStr = "";
-                            for (int j = 1; j < idx; j++) {
-                                char c = response[j];
-                                if (c >= 32 && c <= 126) dataStr += c;
-                            }
-                            dataStr.trim();
-                            if (dataStr.length() > 0) {
-                                configuredSensors[op.sensorIndex].rawValue = dataStr.toFloat();
-                                // Apply calibration and update calibratedValue/modbusValue
-                                float calibratedValue = applyCalibration(configuredSensors[op.sensorIndex].rawValue, configuredSensors[op.sensorIndex]);
-                                configuredSensors[op.sensorIndex].calibratedValue = calibratedValue;
-                                configuredSensors[op.sensorIndex].modbusValue = (int)(calibratedValue * 100);
-                                logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "VAL", "EZO Success: '" + dataStr + "', Calibrated: " + String(calibratedValue), String(configuredSensors[op.sensorIndex].name));
-                            } else {
-                                configuredSensors[op.sensorIndex].rawValue = -998.0;
-                                configuredSensors[op.sensorIndex].calibratedValue = 0.0;
-                                configuredSensors[op.sensorIndex].modbusValue = 0;
-                                logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "ERR", "EZO-PH: Empty data after success code", String(configuredSensors[op.sensorIndex].name));
-                            }
-                        } else if (statusCode == 254) {
-                            // Processing: use non-blocking retry (don't use delay!)
-                            if (op.retryCount < 3) {
-                                op.retryCount++;
-                                // Reschedule as REQUEST_SENT with short conversion time to retry after 100ms
-                                op.state = BusOpState::REQUEST_SENT;
-                                op.conversionTime = 100;
-                                op.startTime = currentTime;
-                                logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "WARN", "EZO-PH: Processing, will retry " + String(op.retryCount), String(configuredSensors[op.sensorIndex].name));
-                                return; // Do not dequeue yet, will process again next loop
-                            } else {
-                                configuredSensors[op.sensorIndex].rawValue = -996.0;
-                                logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "ERR", "EZO-PH: Processing timeout after 3 retries", String(configuredSensors[op.sensorIndex].name));
-                            }
-                        } else if (statusCode == 2) {
-                            configuredSensors[op.sensorIndex].rawValue = -997.0;
-                            logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "ERR", "EZO-PH: Syntax error", String(configuredSensors[op.sensorIndex].name));
-                        } else if (statusCode == 255) {
-                            configuredSensors[op.sensorIndex].rawValue = -995.0;
-                            logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "WARN", "EZO-PH: No data available", String(configuredSensors[op.sensorIndex].name));
-                        } else {
-                            configuredSensors[op.sensorIndex].rawValue = -994.0;
-                            logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "ERR", "EZO-PH: Unknown status " + String(statusCode), String(configuredSensors[op.sensorIndex].name));
-                        }
-                    } else {
-                        configuredSensors[op.sensorIndex].rawValue = -993.0;
-                        logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "ERR", "EZO-PH: No response data", String(configuredSensors[op.sensorIndex].name));
-                    }
-                } else if (strcmp(configuredSensors[op.sensorIndex].type, "EZO-EC") == 0 || 
-                          strcmp(configuredSensors[op.sensorIndex].type, "EZO_EC") == 0) {
-                    // Handle both hyphen and underscore variants for compatibility
-                    uint8_t responseCode = (uint8_t)response[0];
-                    if (responseCode == 1 && idx > 1) {
-                        String dataStr = "";
-                        for (int j = 1; j < idx; j++) {
-                            if (response[j] >= 32 && response[j] <= 126) {
-                                dataStr += (char)response[j];
-                            }
-                        }
-                        configuredSensors[op.sensorIndex].rawValue = dataStr.toFloat();
-                        logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "VAL", "EC: " + String(configuredSensors[op.sensorIndex].rawValue), String(configuredSensors[op.sensorIndex].name));
-                    } else {
-                        configuredSensors[op.sensorIndex].rawValue = atof(response);
-                        logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "VAL", "EC: " + String(configuredSensors[op.sensorIndex].rawValue), String(configuredSensors[op.sensorIndex].name));
-                    }
                 } else if (strcmp(configuredSensors[op.sensorIndex].type, "GENERIC_I2C") == 0 || 
                           strcmp(configuredSensors[op.sensorIndex].type, "GENERIC") == 0 ||
                           strcmp(configuredSensors[op.sensorIndex].type, "Generic I2C") == 0) {
@@ -707,7 +605,7 @@ void processI2CQueue() {
                     // Apply primary calibration using expression-capable function
                     float calibratedPrimary = applyCalibration(primaryValue, configuredSensors[op.sensorIndex]);
                     configuredSensors[op.sensorIndex].calibratedValue = calibratedPrimary;
-                    configuredSensors[op.sensorIndex].modbusValue = (int)(calibratedPrimary * 100);
+                    configuredSensors[op.sensorIndex].modbusValue = sensorModbusValue(configuredSensors[op.sensorIndex], 0, calibratedPrimary);
                     
                     // Check if secondary parsing is configured (for multi-output)
                     if (strlen(configuredSensors[op.sensorIndex].parsingMethodB) > 0 && 
@@ -724,7 +622,7 @@ void processI2CQueue() {
                         // Apply secondary calibration using expression-capable function
                         float calibratedSecondary = applyCalibrationB(secondaryValue, configuredSensors[op.sensorIndex]);
                         configuredSensors[op.sensorIndex].calibratedValueB = calibratedSecondary;
-                        configuredSensors[op.sensorIndex].modbusValueB = (int)(calibratedSecondary * 100);
+                        configuredSensors[op.sensorIndex].modbusValueB = sensorModbusValue(configuredSensors[op.sensorIndex], 1, calibratedSecondary);
                         
                         logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "VAL", 
                                         "Primary: " + String(primaryValue) + ", Secondary: " + String(secondaryValue), 
@@ -734,505 +632,981 @@ void processI2CQueue() {
                                         "Parsed: " + String(primaryValue), 
                                         String(configuredSensors[op.sensorIndex].name));
                     }
-                } else if (strcmp(configuredSensors[op.sensorIndex].type, "LIS3DH") == 0) {
-                    // LIS3DH returns 6 bytes: X_LSB, X_MSB, Y_LSB, Y_MSB, Z_LSB, Z_MSB (signed 16-bit little-endian)
-                    if (idx >= 6) {
-                        // Extract 16-bit signed integers from raw response bytes (little-endian format)
-                        // LIS3DH auto-increments through: 0x28(X_L), 0x29(X_H), 0x2A(Y_L), 0x2B(Y_H), 0x2C(Z_L), 0x2D(Z_H)
-                        int16_t x_raw = ((uint8_t)response[1] << 8) | (uint8_t)response[0];
-                        int16_t y_raw = ((uint8_t)response[3] << 8) | (uint8_t)response[2];
-                        int16_t z_raw = ((uint8_t)response[5] << 8) | (uint8_t)response[4];
-                        
-                        // LIS3DH in standard 10-bit mode (±2g range):
-                        // - Data occupies upper 10 bits (bits 15-6)
-                        // - Lower 6 bits are padding
-                        // - Right-shift by 6 to get actual 10-bit value (-512 to +511)
-                        // - Scale: ±2g / 512 LSB = 3.906 mg/LSB
-                        x_raw >>= 6;
-                        y_raw >>= 6;
-                        z_raw >>= 6;
-                        
-                        float x_mg = (float)x_raw * 3.906f;  // ±2g standard mode: 3.906 mg/LSB
-                        float y_mg = (float)y_raw * 3.906f;
-                        float z_mg = (float)z_raw * 3.906f;
-                        
-                        // Store raw values in multi-axis structure
-                        configuredSensors[op.sensorIndex].rawValue = x_mg;
-                        configuredSensors[op.sensorIndex].rawValueB = y_mg;
-                        configuredSensors[op.sensorIndex].rawValueC = z_mg;
-                        
-                        // Apply calibration to all three axes using new expression-capable functions
-                        float calibratedX = applyCalibration(x_mg, configuredSensors[op.sensorIndex]);
-                        float calibratedY = applyCalibrationB(y_mg, configuredSensors[op.sensorIndex]);
-                        float calibratedZ = applyCalibrationC(z_mg, configuredSensors[op.sensorIndex]);
-                        
-                        configuredSensors[op.sensorIndex].calibratedValue = calibratedX;
-                        configuredSensors[op.sensorIndex].calibratedValueB = calibratedY;
-                        configuredSensors[op.sensorIndex].calibratedValueC = calibratedZ;
-                        
-                        // Convert to Modbus values (scaled by 100 for decimal precision)
-                        configuredSensors[op.sensorIndex].modbusValue = (int)(calibratedX * 100);
-                        configuredSensors[op.sensorIndex].modbusValueB = (int)(calibratedY * 100);
-                        configuredSensors[op.sensorIndex].modbusValueC = (int)(calibratedZ * 100);
-                        
-                        logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "VAL", 
-                                        "X: " + String(x_mg, 2) + " mg, Y: " + String(y_mg, 2) + " mg, Z: " + String(z_mg, 2) + " mg", 
-                                        String(configuredSensors[op.sensorIndex].name));
-                    } else {
-                        logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "ERR", 
-                                        "LIS3DH response too short: " + String(idx) + " bytes", 
-                                        String(configuredSensors[op.sensorIndex].name));
-                    }
                 } else {
                     // Fallback: log raw value for all other I2C sensors
                     logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "VAL", "Raw: " + String(response), String(configuredSensors[op.sensorIndex].name));
                 }
                 
                 // Move queue forward
-                for(int i = 0; i < i2cQueueSize - 1; i++) {
-                    i2cQueue[i] = i2cQueue[i + 1];
-                }
-                i2cQueueSize--;
+                finishBusOperation(i2cQueue, opIndex);
             } else {
                 logI2CTransaction(configuredSensors[op.sensorIndex].i2cAddress, "TIMEOUT", "No response received", String(configuredSensors[op.sensorIndex].name));
                 // Move to next operation on timeout
-                for(int i = 0; i < i2cQueueSize - 1; i++) {
-                    i2cQueue[i] = i2cQueue[i + 1];
-                }
-                i2cQueueSize--;
+                finishBusOperation(i2cQueue, opIndex);
             }
             break;
         }
             
         case BusOpState::ERROR: {
             // Move to next operation
-            for(int i = 0; i < i2cQueueSize - 1; i++) {
-                i2cQueue[i] = i2cQueue[i + 1];
-            }
-            i2cQueueSize--;
+            finishBusOperation(i2cQueue, opIndex);
             break;
         }
     }
 }
 
-void processUARTQueue() {
-    if (uartQueueSize == 0) return;
-    
-    unsigned long currentTime = millis();
-    BusOperation& op = uartQueue[0];
-    
-    // Declare variables outside switch to avoid 'crosses initialization' error
-    int txPin, rxPin;
-    
+// UART sensor engine: both hardware UARTs stay open between reads. Received
+// bytes are collected by the core's UART interrupt handler into a software
+// FIFO, so each poll only drains what has already arrived and never waits.
+struct UARTPort {
+    SerialUART* serial;
+    int txPin;
+    int rxPin;
+    uint32_t baud;
+    uint16_t framing;
+    bool open;
+    int8_t activeSensor;  // Sensor currently owning the port (-1 = free)
+};
 
-    
-    switch(op.state) {
-        case BusOpState::IDLE:
-            txPin = configuredSensors[op.sensorIndex].uartTxPin;
-            rxPin = configuredSensors[op.sensorIndex].uartRxPin;
-            
-            // Initialize UART if pins are valid
-            if (txPin >= 0 && rxPin >= 0 && txPin <= 28 && rxPin <= 28) {
-                // Configure hardware UART (RP2040 has UART0 and UART1)
-                if ((txPin == 0 && rxPin == 1) || (txPin == 12 && rxPin == 13) || 
-                    (txPin == 16 && rxPin == 17) || (txPin == 4 && rxPin == 5)) {
-                    
-                    // Use Serial1 for UART communication
-                    Serial1.setTX(txPin);
-                    Serial1.setRX(rxPin);
-                    Serial1.begin(9600); // Default baud rate
-                    
-                    // Send command if configured
-                    const char* command = configuredSensors[op.sensorIndex].command;
-                    if (strlen(command) > 0) {
-                        Serial1.print(command);
-                        Serial1.print("\r\n");
+UARTPort uartPorts[2] = {
+    {&Serial1, -1, -1, 0, 0, false, -1},  // UART0
+    {&Serial2, -1, -1, 0, 0, false, -1}   // UART1
+};
+volatile bool uartPortsStale = false;  // Set when core0 may have used Serial1 while core1 was parked
 
-                        
-                        // Log the UART transaction for terminal watch
-                        String pinStr = String(txPin) + "," + String(rxPin);
-                        logUARTTransaction(pinStr, "TX", String(command));
-                        
-                        // Wait for response
-                        delay(100);
-                        
-                        String response = "";
-                        unsigned long timeout = millis() + 1000; // 1 second timeout
-                        while (millis() < timeout && response.length() < 120) {
-                            if (Serial1.available()) {
-                                char c = Serial1.read();
-                                response += c;
-                                if (c == '\n' || c == '\r') break; // End of line
-                            }
-                        }
-                        
-                        if (response.length() > 0) {
-                            response.trim();
-                            
-                            // Log the UART response for terminal watch
-                            logUARTTransaction(pinStr, "RX", response);
-                            
-                            strncpy(configuredSensors[op.sensorIndex].rawDataString, response.c_str(), 
-                                   sizeof(configuredSensors[op.sensorIndex].rawDataString)-1);
-
-                            
-                            // Parse the response to extract numeric value
-                            float value = 0.0;
-                            // Try to extract first number from response
-                            for (int i = 0; i < response.length(); i++) {
-                                if (isdigit(response[i]) || response[i] == '.' || response[i] == '-') {
-                                    value = response.substring(i).toFloat();
-                                    break;
-                                }
-                            }
-                            
-                            configuredSensors[op.sensorIndex].rawValue = value;
-                            // Apply calibration using expression-capable function
-                            float calibratedValue = applyCalibration(value, configuredSensors[op.sensorIndex]);
-                            configuredSensors[op.sensorIndex].calibratedValue = calibratedValue;
-                            configuredSensors[op.sensorIndex].modbusValue = (int)(calibratedValue * 100);
-                            
-                        } else {
+// Per-sensor receive line (fixed storage, no String churn)
+char uartRxLine[MAX_SENSORS][UART_RX_FIFO_SIZE / 2];
+uint8_t uartRxLength[MAX_SENSORS] = {0};
 
-                            configuredSensors[op.sensorIndex].rawValue = 0.0;
-                            strcpy(configuredSensors[op.sensorIndex].rawDataString, "NO_RESPONSE");
-                        }
-                    } else {
+struct UARTFramingOption {
+    const char* name;
+    uint16_t config;
+};
 
-                        // Just read any available data
-                        String response = "";
-                        while (Serial1.available() && response.length() < 120) {
-                            char c = Serial1.read();
-                            response += c;
-                        }
-                        if (response.length() > 0) {
-                            response.trim();
-                            strncpy(configuredSensors[op.sensorIndex].rawDataString, response.c_str(), 
-                                   sizeof(configuredSensors[op.sensorIndex].rawDataString)-1);
-                        }
-                    }
-                    
-                    Serial1.end(); // Close UART to free pins for other sensors
-                } else {
+const UARTFramingOption UART_FRAMINGS[] = {
+    {"8N1", SERIAL_8N1}, {"8E1", SERIAL_8E1}, {"8O1", SERIAL_8O1},
+    {"8N2", SERIAL_8N2}, {"8E2", SERIAL_8E2}, {"8O2", SERIAL_8O2},
+    {"7N1", SERIAL_7N1}, {"7E1", SERIAL_7E1}, {"7O1", SERIAL_7O1},
+    {"7N2", SERIAL_7N2}, {"7E2", SERIAL_7E2}, {"7O2", SERIAL_7O2}
+};
 
-                    configuredSensors[op.sensorIndex].rawValue = 0.0;
-                    strcpy(configuredSensors[op.sensorIndex].rawDataString, "INVALID_PINS");
-                }
-            } else {
+uint16_t uartFramingConfig(const char* framing) {
+    for (size_t i = 0; i < sizeof(UART_FRAMINGS) / sizeof(UART_FRAMINGS[0]); i++) {
+        if (strcasecmp(framing, UART_FRAMINGS[i].name) == 0) return UART_FRAMINGS[i].config;
+    }
+    return SERIAL_8N1;
+}
 
-                configuredSensors[op.sensorIndex].rawValue = 0.0;
-                strcpy(configuredSensors[op.sensorIndex].rawDataString, "INVALID_PINS");
-            }
-            
-            configuredSensors[op.sensorIndex].lastReadTime = currentTime;
-            
-            // Move to next operation
-            for(int i = 0; i < uartQueueSize - 1; i++) {
-                uartQueue[i] = uartQueue[i + 1];
-            }
-            uartQueueSize--;
-            break;
-            
-        case BusOpState::REQUEST_SENT:
-        case BusOpState::READY_TO_READ:
-        case BusOpState::ERROR:
-            // Move to next operation
-            for(int i = 0; i < uartQueueSize - 1; i++) {
-                uartQueue[i] = uartQueue[i + 1];
+// UART baud of a sensors.json / POST entry; "baudRate" is the older key
+uint32_t readUartBaud(JsonObject sensor) {
+    if (sensor.containsKey("uartBaud") && sensor["uartBaud"].is<int>()) return sensor["uartBaud"].as<int>();
+    if (sensor.containsKey("baudRate") && sensor["baudRate"].is<int>()) return sensor["baudRate"].as<int>();
+    return 9600;
+}
+
+// Map a TX/RX pin pair onto the RP2040 UART that can drive it (-1 = invalid pair)
+int uartPortForPins(int txPin, int rxPin) {
+    if ((txPin == 0 || txPin == 12 || txPin == 16 || txPin == 28) && rxPin == txPin + 1) return 0;
+    if ((txPin == 4 || txPin == 8 || txPin == 20 || txPin == 24) && rxPin == txPin + 1) return 1;
+    return -1;
+}
+
+// RS485 port pins: a UART pair on the Pico header (GP0-22, 26-28) clear of the W5500,
+// DE the same or -1. GP23-25 are board-internal (GP25 is LED_BUILTIN).
+bool modbusRTUPinsUsable(int txPin, int rxPin, int dePin) {
+    auto headerPin = [](int pin) {
+        return (pin >= 0 && pin <= 22 && (pin < PIN_ETH_MISO || pin > PIN_ETH_IRQ)) || (pin >= 26 && pin <= 28);
+    };
+    return uartPortForPins(txPin, rxPin) >= 0 && headerPin(txPin) && headerPin(rxPin) &&
+           (dePin == -1 || (headerPin(dePin) && dePin != txPin && dePin != rxPin));
+}
+
+// Open (or re-open with new settings) the port for a sensor. Only reconfigures
+// when pins, baud or framing differ from what the port is already running.
+void openUARTPort(UARTPort& port, const SensorConfig& sensor) {
+    uint32_t baud = sensor.uartBaud > 0 ? sensor.uartBaud : 9600;
+    uint16_t framing = uartFramingConfig(sensor.uartFraming);
+    if (port.open && port.txPin == sensor.uartTxPin && port.rxPin == sensor.uartRxPin &&
+        port.baud == baud && port.framing == framing) {
+        return;
+    }
+    if (port.open) {
+        port.serial->end();
+    }
+    port.serial->setTX(sensor.uartTxPin);
+    port.serial->setRX(sensor.uartRxPin);
+    port.serial->setFIFOSize(UART_RX_FIFO_SIZE);
+    port.serial->begin(baud, framing);
+    port.txPin = sensor.uartTxPin;
+    port.rxPin = sensor.uartRxPin;
+    port.baud = baud;
+    port.framing = framing;
+    port.open = true;
+}
+
+// Parse a completed (or timed out) response line and publish the reading
+void completeUARTRead(BusOperation& op, unsigned long currentTime) {
+    SensorConfig& sensor = configuredSensors[op.sensorIndex];
+    char* line = uartRxLine[op.sensorIndex];
+    uint8_t len = uartRxLength[op.sensorIndex];
+    
+    // Trim surrounding whitespace/control characters
+    uint8_t start = 0;
+    while (start < len && (uint8_t)line[start] <= ' ') start++;
+    while (len > start && (uint8_t)line[len - 1] <= ' ') len--;
+    line[len] = '\0';
+    line += start;
+    
+    if (*line == '\0') {
+        sensor.rawValue = 0.0;
+        strcpy(sensor.rawDataString, "NO_RESPONSE");
+    } else {
+        char pinStr[12];
+        snprintf(pinStr, sizeof(pinStr), "%d,%d", sensor.uartTxPin, sensor.uartRxPin);
+        logUARTTransaction(String(pinStr), "RX", String(line));
+        
+        strncpy(sensor.rawDataString, line, sizeof(sensor.rawDataString)-1);
+        sensor.rawDataString[sizeof(sensor.rawDataString)-1] = '\0';
+        
+        // Extract the first number from the response
+        float value = 0.0;
+        for (const char* c = line; *c; c++) {
+            if (isdigit((unsigned char)*c) || *c == '.' || *c == '-') {
+                value = atof(c);
+                break;
             }
-            uartQueueSize--;
-            break;
+        }
+        
+        sensor.rawValue = value;
+        // Apply calibration using expression-capable function
+        float calibratedValue = applyCalibration(value, sensor);
+        sensor.calibratedValue = calibratedValue;
+        sensor.modbusValue = sensorModbusValue(sensor, 0, calibratedValue);
     }
+    recordSensorRead(op.sensorIndex, currentTime);
 }
 
-void processOneWireQueue() {
-    if (oneWireQueueSize == 0) return;
+// Drive every queued UART operation one step: start when its port is free,
+// then collect bytes until a line terminator or timeout. Never blocks.
+void processUARTQueue() {
+    if (uartPortsStale) {
+        // Terminal/poll handlers reconfigure Serial1 directly; reopen on next use
+        for (int p = 0; p < 2; p++) {
+            if (uartPorts[p].open) uartPorts[p].serial->end();
+            uartPorts[p].open = false;
+            uartPorts[p].activeSensor = -1;
+        }
+        uartPortsStale = false;
+    }
+    if (uartQueue.isEmpty()) return;
     
     unsigned long currentTime = millis();
-    BusOperation& op = oneWireQueue[0];
-    
-    int owPin = configuredSensors[op.sensorIndex].oneWirePin;
-    uint8_t scratchpad[9] = {0};
-    bool presence;
-    bool readOk;
     
-    switch(op.state) {
-        case BusOpState::IDLE:
-
-            // Initialize One-Wire transaction
-            pinMode(owPin, OUTPUT);
-            digitalWrite(owPin, LOW);
-            delayMicroseconds(480);
-            pinMode(owPin, INPUT_PULLUP);
-            delayMicroseconds(70);
-            presence = !digitalRead(owPin);
-            delayMicroseconds(410);
-
-            if (presence) {
-
+    for (uint8_t i = 0; i < uartQueue.count; i++) {
+        BusOperation& op = uartQueue.at(i);
+        SensorConfig& sensor = configuredSensors[op.sensorIndex];
+        int portIndex = uartPortForPins(sensor.uartTxPin, sensor.uartRxPin);
+        
+        if (portIndex < 0 || portIndex == modbusRtu.port) {
+            sensor.rawValue = 0.0;
+            strcpy(sensor.rawDataString, portIndex < 0 ? "INVALID_PINS" : "UART_IN_USE_BY_MODBUS_RTU");
+            recordSensorRead(op.sensorIndex, currentTime);
+            finishBusOperation(uartQueue, i);
+            return;
+        }
+        UARTPort& port = uartPorts[portIndex];
+        
+        switch (op.state) {
+            case BusOpState::IDLE: {
+                if (port.activeSensor >= 0) break;  // Port busy with another sensor
                 
-                // Log the One-Wire transaction for terminal watch
-                logOneWireTransaction(String(owPin), "TX", "0xCC 0x44 (Skip ROM + Convert T)");
+                openUARTPort(port, sensor);
+                port.activeSensor = op.sensorIndex;
                 
-                // Send Skip ROM (0xCC) + Convert T (0x44) command
-                // Skip ROM command
-                for (int bit = 0; bit < 8; bit++) {
-                    pinMode(owPin, OUTPUT);
-                    digitalWrite(owPin, LOW);
-                    if ((0xCC >> bit) & 1) {
-                        delayMicroseconds(6);
-                        pinMode(owPin, INPUT_PULLUP);
-                        delayMicroseconds(64);
-                    } else {
-                        delayMicroseconds(60);
-                        pinMode(owPin, INPUT_PULLUP);
-                        delayMicroseconds(10);
-                    }
+                // Discard anything left over from a previous exchange
+                while (port.serial->available()) port.serial->read();
+                uartRxLength[op.sensorIndex] = 0;
+                
+                const char* command = sensor.command;
+                if (strlen(command) > 0) {
+                    port.serial->print(command);
+                    port.serial->print("\r\n");
+                    
+                    // Log the UART transaction for terminal watch
+                    char pinStr[12];
+                    snprintf(pinStr, sizeof(pinStr), "%d,%d", sensor.uartTxPin, sensor.uartRxPin);
+                    logUARTTransaction(String(pinStr), "TX", String(command));
                 }
+                // Streaming sensors (no command) simply wait for their next line
+                op.state = BusOpState::REQUEST_SENT;
+                op.startTime = currentTime;
+                break;
+            }
+            
+            case BusOpState::REQUEST_SENT: {
+                char* line = uartRxLine[op.sensorIndex];
+                uint8_t& len = uartRxLength[op.sensorIndex];
+                bool complete = false;
                 
-                // Convert T command
-                for (int bit = 0; bit < 8; bit++) {
-                    pinMode(owPin, OUTPUT);
-                    digitalWrite(owPin, LOW);
-                    if ((0x44 >> bit) & 1) {
-                        delayMicroseconds(6);
-                        pinMode(owPin, INPUT_PULLUP);
-                        delayMicroseconds(64);
+                while (port.serial->available()) {
+                    char c = port.serial->read();
+                    if (c == '\n' || c == '\r') {
+                        if (len > 0) {
+                            complete = true;
+                            break;
+                        }
+                        continue;  // Skip leading terminators
+                    }
+                    if (len < sizeof(uartRxLine[0]) - 1) {
+                        line[len++] = c;
                     } else {
-                        delayMicroseconds(60);
-                        pinMode(owPin, INPUT_PULLUP);
-                        delayMicroseconds(10);
+                        complete = true;  // Line buffer full
+                        break;
                     }
                 }
                 
-                op.state = BusOpState::REQUEST_SENT;
-                op.startTime = currentTime;
-                configuredSensors[op.sensorIndex].lastOneWireCmd = currentTime;
-            } else {
-
-                if (++op.retryCount >= 3) {
-
-                    for(int i = 0; i < oneWireQueueSize - 1; i++) {
-                        oneWireQueue[i] = oneWireQueue[i + 1];
-                    }
-                    oneWireQueueSize--;
+                if (complete || currentTime - op.startTime >= UART_RESPONSE_TIMEOUT_MS) {
+                    completeUARTRead(op, currentTime);
+                    port.activeSensor = -1;
+                    finishBusOperation(uartQueue, i);
+                    return;
                 }
+                break;
             }
-            break;
+            
+            default:
+                if (port.activeSensor == op.sensorIndex) port.activeSensor = -1;
+                finishBusOperation(uartQueue, i);
+                return;
+        }
+    }
+}
 
-        case BusOpState::REQUEST_SENT:
-            if (currentTime - op.startTime >= op.conversionTime) {
+// ============================================================================
+// One-Wire master on PIO
+// ============================================================================
+// Reset, write and read slots are generated by a PIO state machine (program
+// from the pico-examples onewire library) clocked at 1 MHz, so one instruction
+// is 1 us. Each byte is one 32-bit FIFO word in and one out: bytes are shifted
+// out LSB first and the sampled bits autopush back in the top byte of the RX
+// word. Whole transactions are moved by DMA, so the CPU only starts them and
+// later checks for completion.
+//
+// .program onewire
+// .side_set 1 pindirs
+// PUBLIC reset_bus:
+//         set x, 28       side 1  [15]   ; pull bus low (480 us)
+// loop_a: jmp x-- loop_a  side 1  [15]
+//         set x, 8        side 0  [6]    ; release bus, wait for presence
+// loop_b: jmp x-- loop_b  side 0  [6]
+//         mov isr, pins   side 0         ; sample presence pulse
+//         push            side 0
+//         set x, 24       side 0  [7]    ; finish reset time slot
+// loop_c: jmp x-- loop_c  side 0  [15]
+// .wrap_target
+// PUBLIC fetch_bit:
+//         out x, 1        side 0         ; next bit (autopull)
+//         jmp !x  send_0  side 1  [5]    ; pull low, branch if sending '0'
+// send_1: set x, 2        side 0  [8]    ; release, wait for slave
+//         in pins, 1      side 0  [4]    ; sample (autopush)
+// loop_e: jmp x-- loop_e  side 0  [15]
+//         jmp fetch_bit   side 0
+// send_0: set x, 2        side 1  [5]    ; keep bus low
+// loop_d: jmp x-- loop_d  side 1  [15]
+//         in null, 1      side 0  [8]    ; release, shift 0 (autopush)
+// .wrap
+const uint16_t ONEWIRE_PIO_INSTRUCTIONS[] = {
+    0xFF3C, 0x1F41, 0xE628, 0x0643, 0xA0C0, 0x8020, 0xE738, 0x0F47,
+    0x6021, 0x152E, 0xE822, 0x4401, 0x0F4C, 0x0008, 0xF522, 0x1F4F,
+    0x4861
+};
+const uint ONEWIRE_PIO_OFFSET_RESET = 0;
+const uint ONEWIRE_PIO_OFFSET_FETCH_BIT = 8;
+const uint ONEWIRE_PIO_WRAP = 16;
+
+const pio_program_t ONEWIRE_PIO_PROGRAM = {
+    .instructions = ONEWIRE_PIO_INSTRUCTIONS,
+    .length = sizeof(ONEWIRE_PIO_INSTRUCTIONS) / sizeof(ONEWIRE_PIO_INSTRUCTIONS[0]),
+    .origin = -1
+};
 
-                op.state = BusOpState::READY_TO_READ;
-            }
-            break;
+enum class OneWireResult {
+    BUSY,
+    DONE,
+    NO_PRESENCE,
+    TIMEOUT
+};
 
-        case BusOpState::READY_TO_READ:
-            readOk = true;
+// One PIO state machine per One-Wire pin
+struct OneWireBus {
+    int pin = -1;            // -1 = free slot
+    PIO pio;
+    uint sm;
+    uint offset;
+    int dmaTx;
+    int dmaRx;
+    bool active;             // Transaction in flight
+    bool resetPending;       // Waiting for the presence sample
+    uint8_t length;
+    int owner = -1;          // Sensor index that started the transaction in flight
+    unsigned long startTime;
+    uint32_t txWords[ONEWIRE_MAX_TRANSFER];
+    uint32_t rxWords[ONEWIRE_MAX_TRANSFER];
+    bool searched;           // ROM search has run since the pin was claimed or a rescan was requested
+    bool persistPending;     // Copy DS18B20 scratchpads to EEPROM on the next idle pass
+    uint8_t romCount;
+    uint8_t roms[MAX_ONEWIRE_DEVICES][8];
+};
 
-            // Send read scratchpad command
-            pinMode(owPin, OUTPUT);
-            digitalWrite(owPin, LOW);
-            delayMicroseconds(480);
-            pinMode(owPin, INPUT_PULLUP);
-            delayMicroseconds(70);
-            presence = !digitalRead(owPin);
-            delayMicroseconds(410);
+OneWireBus oneWireBuses[MAX_ONEWIRE_BUSES];
+int oneWireProgramOffset[2] = {-1, -1};  // Program load offset in pio0/pio1
+volatile bool oneWireBusesStale = false; // Core0 may have bit-banged a pin while core1 was parked
+volatile bool oneWireRescanRequested = true; // Re-run the ROM search on every configured pin
+volatile bool oneWirePersistRequested = false; // Store DS18B20 resolution in device EEPROM
+
+// Resolved Match ROM address per sensor (false = Skip ROM, sole device on its pin)
+uint8_t oneWireSensorRom[MAX_SENSORS][8];
+bool oneWireSensorAddressed[MAX_SENSORS];
+
+// Configure (or re-attach) the state machine and its pin
+void oneWireInitPin(OneWireBus& bus) {
+    pio_sm_set_enabled(bus.pio, bus.sm, false);
+    
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, bus.offset + ONEWIRE_PIO_OFFSET_FETCH_BIT, bus.offset + ONEWIRE_PIO_WRAP);
+    sm_config_set_sideset(&c, 1, false, true);
+    sm_config_set_out_pins(&c, bus.pin, 1);
+    sm_config_set_set_pins(&c, bus.pin, 1);
+    sm_config_set_in_pins(&c, bus.pin);
+    sm_config_set_sideset_pins(&c, bus.pin);
+    sm_config_set_clkdiv(&c, clock_get_hz(clk_sys) / 1000000.0f);  // 1 us per instruction
+    sm_config_set_out_shift(&c, true, true, 8);
+    sm_config_set_in_shift(&c, true, true, 8);
+    
+    // Open drain: output latch low, bus driven only by toggling the pin direction.
+    // The pad pull-up keeps an idle line from floating; it does not replace the external 4.7k.
+    pio_gpio_init(bus.pio, bus.pin);
+    gpio_pull_up(bus.pin);
+    pio_sm_set_pins_with_mask(bus.pio, bus.sm, 0, 1u << bus.pin);
+    pio_sm_set_pindirs_with_mask(bus.pio, bus.sm, 0, 1u << bus.pin);
+    
+    pio_sm_init(bus.pio, bus.sm, bus.offset + ONEWIRE_PIO_OFFSET_FETCH_BIT, &c);
+    pio_sm_set_enabled(bus.pio, bus.sm, true);
+    bus.active = false;
+    bus.resetPending = false;
+}
 
-            if (presence) {
+// Find the bus for a pin, claiming a state machine and DMA channels on first use
+OneWireBus* oneWireBusForPin(int pin) {
+    if (pin < 0 || pin > 29) return nullptr;
+    
+    int freeSlot = -1;
+    for (int i = 0; i < MAX_ONEWIRE_BUSES; i++) {
+        if (oneWireBuses[i].pin == pin) return &oneWireBuses[i];
+        if (oneWireBuses[i].pin < 0 && freeSlot < 0) freeSlot = i;
+    }
+    if (freeSlot < 0) return nullptr;
+    
+    OneWireBus& bus = oneWireBuses[freeSlot];
+    PIO pios[2] = {pio0, pio1};
+    for (int p = 0; p < 2; p++) {
+        if (oneWireProgramOffset[p] < 0) {
+            if (!pio_can_add_program(pios[p], &ONEWIRE_PIO_PROGRAM)) continue;
+            oneWireProgramOffset[p] = pio_add_program(pios[p], &ONEWIRE_PIO_PROGRAM);
+        }
+        int sm = pio_claim_unused_sm(pios[p], false);
+        if (sm < 0) continue;
+        
+        bus.pio = pios[p];
+        bus.sm = (uint)sm;
+        bus.offset = (uint)oneWireProgramOffset[p];
+        bus.pin = pin;
+        bus.dmaTx = dma_claim_unused_channel(true);
+        bus.dmaRx = dma_claim_unused_channel(true);
+        oneWireInitPin(bus);
+        Serial.printf("[1-Wire] GP%d on PIO%d SM%d\n", pin, p, sm);
+        return &bus;
+    }
+    Serial.printf("[1-Wire] No free PIO state machine for GP%d\n", pin);
+    return nullptr;
+}
 
-                
-                // Send Skip ROM (0xCC) + Read Scratchpad (0xBE) command
-                // Skip ROM command
-                for (int bit = 0; bit < 8; bit++) {
-                    pinMode(owPin, OUTPUT);
-                    digitalWrite(owPin, LOW);
-                    if ((0xCC >> bit) & 1) {
-                        delayMicroseconds(6);
-                        pinMode(owPin, INPUT_PULLUP);
-                        delayMicroseconds(64);
-                    } else {
-                        delayMicroseconds(60);
-                        pinMode(owPin, INPUT_PULLUP);
-                        delayMicroseconds(10);
-                    }
+// Start a transaction: bus reset, then `length` bytes written (0xFF to read a byte)
+bool oneWireBegin(OneWireBus& bus, const uint8_t* data, uint8_t length) {
+    if (bus.active || length > ONEWIRE_MAX_TRANSFER) return false;
+    
+    for (uint8_t i = 0; i < length; i++) {
+        bus.txWords[i] = data[i];
+    }
+    bus.length = length;
+    
+    pio_sm_clear_fifos(bus.pio, bus.sm);
+    pio_sm_exec(bus.pio, bus.sm, pio_encode_jmp(bus.offset + ONEWIRE_PIO_OFFSET_RESET));
+    bus.active = true;
+    bus.resetPending = true;
+    bus.startTime = millis();
+    return true;
+}
+
+// Abort a hung transaction and park the state machine at fetch_bit
+void oneWireAbort(OneWireBus& bus) {
+    dma_channel_abort(bus.dmaTx);
+    dma_channel_abort(bus.dmaRx);
+    pio_sm_set_enabled(bus.pio, bus.sm, false);
+    pio_sm_clear_fifos(bus.pio, bus.sm);
+    pio_sm_restart(bus.pio, bus.sm);
+    pio_sm_exec(bus.pio, bus.sm, pio_encode_jmp(bus.offset + ONEWIRE_PIO_OFFSET_FETCH_BIT));
+    pio_sm_set_enabled(bus.pio, bus.sm, true);
+    bus.active = false;
+    bus.resetPending = false;
+}
+
+// Advance a transaction without waiting. On DONE, `rx` holds one sampled byte per written byte.
+OneWireResult oneWirePoll(OneWireBus& bus, uint8_t* rx) {
+    if (!bus.active) return OneWireResult::DONE;
+    
+    if (millis() - bus.startTime > ONEWIRE_TRANSFER_TIMEOUT_MS) {
+        oneWireAbort(bus);
+        return OneWireResult::TIMEOUT;
+    }
+    
+    if (bus.resetPending) {
+        if (pio_sm_is_rx_fifo_empty(bus.pio, bus.sm)) return OneWireResult::BUSY;
+        
+        // Presence pulse: a device holds the line low while it is sampled
+        // (pins are read relative to the IN base, so the bus pin is bit 0)
+        bool presence = (pio_sm_get(bus.pio, bus.sm) & 1u) == 0;
+        bus.resetPending = false;
+        if (!presence) {
+            bus.active = false;
+            return OneWireResult::NO_PRESENCE;
+        }
+        
+        // RX channel first so no sampled byte is missed, then feed the TX FIFO
+        dma_channel_config rxc = dma_channel_get_default_config(bus.dmaRx);
+        channel_config_set_transfer_data_size(&rxc, DMA_SIZE_32);
+        channel_config_set_read_increment(&rxc, false);
+        channel_config_set_write_increment(&rxc, true);
+        channel_config_set_dreq(&rxc, pio_get_dreq(bus.pio, bus.sm, false));
+        dma_channel_configure(bus.dmaRx, &rxc, bus.rxWords, &bus.pio->rxf[bus.sm], bus.length, true);
+        
+        dma_channel_config txc = dma_channel_get_default_config(bus.dmaTx);
+        channel_config_set_transfer_data_size(&txc, DMA_SIZE_32);
+        channel_config_set_read_increment(&txc, true);
+        channel_config_set_write_increment(&txc, false);
+        channel_config_set_dreq(&txc, pio_get_dreq(bus.pio, bus.sm, true));
+        dma_channel_configure(bus.dmaTx, &txc, &bus.pio->txf[bus.sm], bus.txWords, bus.length, true);
+        return OneWireResult::BUSY;
+    }
+    
+    if (dma_channel_is_busy(bus.dmaRx)) return OneWireResult::BUSY;
+    
+    for (uint8_t i = 0; i < bus.length; i++) {
+        rx[i] = (uint8_t)(bus.rxWords[i] >> 24);
+    }
+    bus.active = false;
+    return OneWireResult::DONE;
+}
+
+// ROM IDs are kept as 16 uppercase hex digits, family code first ("28FF4C1D0316045A")
+void oneWireRomToHex(const uint8_t* rom, char* hex) {
+    for (int i = 0; i < 8; i++) {
+        snprintf(&hex[i * 2], 3, "%02X", rom[i]);
+    }
+}
+
+bool oneWireRomFromHex(const char* hex, uint8_t* rom) {
+    if (strlen(hex) != 16) return false;
+    for (int i = 0; i < 8; i++) {
+        char byteStr[3] = {hex[i * 2], hex[i * 2 + 1], '\0'};
+        char* endPtr;
+        rom[i] = (uint8_t)strtoul(byteStr, &endPtr, 16);
+        if (*endPtr != '\0') return false;
+    }
+    return true;
+}
+
+// Accept "28:FF:4C:..." / "28-ff-4c..." from the UI and store the canonical form (empty if invalid)
+void normalizeOneWireRom(const char* input, char* out) {
+    int length = 0;
+    for (const char* c = input; *c && length < 16; c++) {
+        if (isxdigit((unsigned char)*c)) out[length++] = toupper((unsigned char)*c);
+    }
+    out[length] = '\0';
+    uint8_t rom[8];
+    if (!oneWireRomFromHex(out, rom) || crc8Dallas(rom, 7) != rom[7]) out[0] = '\0';
+}
+
+// Blocking slot primitives for the ROM search. The search picks each bit from the
+// previous two reads, so it cannot be pre-built into a DMA transfer.
+bool oneWireResetBlocking(OneWireBus& bus) {
+    pio_sm_clear_fifos(bus.pio, bus.sm);
+    pio_sm_exec(bus.pio, bus.sm, pio_encode_jmp(bus.offset + ONEWIRE_PIO_OFFSET_RESET));
+    return (pio_sm_get_blocking(bus.pio, bus.sm) & 1u) == 0;
+}
+
+// Switch autopush/autopull between byte transfers (8) and single slots (1)
+void oneWireSetSlotBits(OneWireBus& bus, uint bits) {
+    pio_sm_set_enabled(bus.pio, bus.sm, false);
+    bus.pio->sm[bus.sm].shiftctrl = (bus.pio->sm[bus.sm].shiftctrl &
+        ~(PIO_SM0_SHIFTCTRL_PUSH_THRESH_BITS | PIO_SM0_SHIFTCTRL_PULL_THRESH_BITS)) |
+        ((bits & 0x1f) << PIO_SM0_SHIFTCTRL_PUSH_THRESH_LSB) |
+        ((bits & 0x1f) << PIO_SM0_SHIFTCTRL_PULL_THRESH_LSB);
+    pio_sm_set_enabled(bus.pio, bus.sm, true);
+}
+
+bool oneWireSlotBlocking(OneWireBus& bus, bool bit) {
+    pio_sm_put_blocking(bus.pio, bus.sm, bit ? 1u : 0u);
+    return (pio_sm_get_blocking(bus.pio, bus.sm) >> 31) & 1u;
+}
+
+// Enumerate every device on the pin with Search ROM (0xF0). Takes ~13ms per device,
+// so it only runs when a pin is first claimed or a rescan is requested.
+void oneWireSearchBus(OneWireBus& bus) {
+    bus.romCount = 0;
+    bus.searched = true;
+    
+    uint8_t rom[8] = {0};
+    int lastDiscrepancy = 0;
+    bool lastDevice = false;
+    
+    while (!lastDevice && bus.romCount < MAX_ONEWIRE_DEVICES) {
+        if (!oneWireResetBlocking(bus)) break;
+        pio_sm_put_blocking(bus.pio, bus.sm, 0xF0);
+        pio_sm_get_blocking(bus.pio, bus.sm);
+        
+        oneWireSetSlotBits(bus, 1);
+        int lastZero = 0;
+        bool complete = true;
+        for (int bit = 1; bit <= 64; bit++) {
+            uint8_t& romByte = rom[(bit - 1) / 8];
+            uint8_t mask = 1u << ((bit - 1) % 8);
+            bool idBit = oneWireSlotBlocking(bus, true);
+            bool complementBit = oneWireSlotBlocking(bus, true);
+            if (idBit && complementBit) {
+                complete = false;  // Nobody answered (device removed mid-search)
+                break;
+            }
+            
+            bool direction;
+            if (idBit != complementBit) {
+                direction = idBit;
+            } else {
+                // Discrepancy: devices differ at this bit. Retrace the previous path below the
+                // last branch point, take 1 at it, and 0 at any new branch after it.
+                direction = bit < lastDiscrepancy ? (romByte & mask) != 0 : bit == lastDiscrepancy;
+                if (!direction) lastZero = bit;
+            }
+            romByte = direction ? (romByte | mask) : (romByte & ~mask);
+            oneWireSlotBlocking(bus, direction);
+        }
+        oneWireSetSlotBits(bus, 8);
+        if (!complete) break;
+        
+        lastDiscrepancy = lastZero;
+        lastDevice = lastDiscrepancy == 0;
+        if (rom[0] != 0 && crc8Dallas(rom, 7) == rom[7]) {
+            memcpy(bus.roms[bus.romCount++], rom, 8);
+        }
+    }
+    
+    pio_sm_clear_fifos(bus.pio, bus.sm);
+    Serial.printf("[1-Wire] GP%d: %d device(s) found\n", bus.pin, bus.romCount);
+    logOneWireTransaction(String(bus.pin), "INFO", "ROM search: " + String(bus.romCount) + " device(s)");
+}
+
+// Resolve the ROM each sensor on this pin is addressed with. Sensors with a configured
+// ROM keep it; the rest take unclaimed devices in search order. A lone device on the
+// pin is still read with Skip ROM.
+void assignOneWireDevices(const OneWireBus& bus) {
+    bool claimed[MAX_ONEWIRE_DEVICES] = {false};
+    
+    for (int i = 0; i < numConfiguredSensors; i++) {
+        SensorConfig& sensor = configuredSensors[i];
+        if (sensor.oneWirePin != bus.pin || sensor.oneWireRom[0] == '\0') continue;
+        
+        oneWireSensorAddressed[i] = oneWireRomFromHex(sensor.oneWireRom, oneWireSensorRom[i]);
+        bool found = false;
+        for (int d = 0; d < bus.romCount; d++) {
+            if (memcmp(bus.roms[d], oneWireSensorRom[i], 8) == 0) {
+                claimed[d] = true;
+                found = true;
+            }
+        }
+        if (!found) {
+            Serial.printf("[1-Wire] %s: ROM %s not present on GP%d\n", sensor.name, sensor.oneWireRom, bus.pin);
+        }
+    }
+    
+    for (int i = 0; i < numConfiguredSensors; i++) {
+        SensorConfig& sensor = configuredSensors[i];
+        if (sensor.oneWirePin != bus.pin || sensor.oneWireRom[0] != '\0') continue;
+        
+        oneWireSensorAddressed[i] = false;
+        if (bus.romCount <= 1) continue;
+        for (int d = 0; d < bus.romCount; d++) {
+            if (claimed[d]) continue;
+            memcpy(oneWireSensorRom[i], bus.roms[d], 8);
+            oneWireSensorAddressed[i] = true;
+            claimed[d] = true;
+            break;
+        }
+        if (!oneWireSensorAddressed[i]) {
+            Serial.printf("[1-Wire] %s: no unassigned device left on GP%d\n", sensor.name, bus.pin);
+        }
+    }
+}
+
+// DS18B20 conversion time halves with each bit of resolution dropped
+uint32_t ds18b20ConversionTime(uint8_t resolution) {
+    static const uint16_t conversionMs[] = {94, 188, 375, 750};
+    if (resolution < 9 || resolution > 12) resolution = 12;
+    return conversionMs[resolution - 9];
+}
+
+// Match ROM (0x55 + ROM) for an addressed sensor, Skip ROM (0xCC) for a lone device.
+// Returns the number of bytes written to `tx`.
+uint8_t oneWireSelectSensor(uint8_t sensorIndex, uint8_t* tx) {
+    if (!oneWireSensorAddressed[sensorIndex]) {
+        tx[0] = 0xCC;
+        return 1;
+    }
+    tx[0] = 0x55;
+    memcpy(&tx[1], oneWireSensorRom[sensorIndex], 8);
+    return 9;
+}
+
+// Reset, then write `length` bytes, sampling one byte per slot (0xFF to read)
+bool oneWireTransferBlocking(OneWireBus& bus, const uint8_t* tx, uint8_t* rx, uint8_t length) {
+    if (!oneWireResetBlocking(bus)) return false;
+    for (uint8_t i = 0; i < length; i++) {
+        pio_sm_put_blocking(bus.pio, bus.sm, tx[i]);
+        uint8_t value = (uint8_t)(pio_sm_get_blocking(bus.pio, bus.sm) >> 24);
+        if (rx != nullptr) rx[i] = value;
+    }
+    return true;
+}
+
+// Write the configured resolution into a DS18B20's configuration register, keeping
+// its TH/TL alarm bytes, and optionally copy the scratchpad to the device EEPROM
+void ds18b20ApplyResolution(OneWireBus& bus, uint8_t sensorIndex, bool persist) {
+    SensorConfig& sensor = configuredSensors[sensorIndex];
+    uint8_t tx[ONEWIRE_MAX_TRANSFER];
+    uint8_t rx[ONEWIRE_MAX_TRANSFER];
+    uint8_t select = oneWireSelectSensor(sensorIndex, tx);
+    
+    tx[select] = 0xBE;
+    memset(&tx[select + 1], 0xFF, 9);
+    uint8_t* scratchpad = &rx[select + 1];
+    // Bits 0-4 of the configuration register always read 1, which also rejects a shorted bus
+    if (!oneWireTransferBlocking(bus, tx, rx, select + 10) || !validateCRC(scratchpad, 9) ||
+        (scratchpad[4] & 0x1F) != 0x1F) {
+        Serial.printf("[1-Wire] %s: scratchpad read failed, resolution not applied\n", sensor.name);
+        return;
+    }
+    
+    uint8_t config = (uint8_t)(((sensor.oneWireResolution - 9) << 5) | 0x1F);
+    if (scratchpad[4] != config) {
+        // Write Scratchpad (0x4E): TH, TL, configuration
+        tx[select] = 0x4E;
+        tx[select + 1] = scratchpad[2];
+        tx[select + 2] = scratchpad[3];
+        tx[select + 3] = config;
+        oneWireTransferBlocking(bus, tx, nullptr, select + 4);
+        Serial.printf("[1-Wire] %s: resolution set to %d bits\n", sensor.name, sensor.oneWireResolution);
+    }
+    
+    if (persist) {
+        // Copy Scratchpad (0x48) to EEPROM; the device ignores the bus until the write completes
+        tx[select] = 0x48;
+        if (oneWireTransferBlocking(bus, tx, nullptr, select + 1)) {
+            delay(DS18B20_EEPROM_WRITE_MS);
+            logOneWireTransaction(String(bus.pin), "INFO", String(sensor.name) + ": resolution stored in EEPROM");
+        }
+    }
+}
+
+// Apply resolution to every DS18B20 on the pin. Skip ROM writes would reach every
+// device, so an unaddressed sensor is only configured when it is alone on the pin.
+void configureOneWireSensors(OneWireBus& bus, bool persist) {
+    for (int i = 0; i < numConfiguredSensors; i++) {
+        SensorConfig& sensor = configuredSensors[i];
+        if (!sensor.enabled || sensor.oneWirePin != bus.pin || strcmp(sensor.type, "DS18B20") != 0) continue;
+        if (!oneWireSensorAddressed[i] && bus.romCount > 1) continue;
+        ds18b20ApplyResolution(bus, (uint8_t)i, persist);
+    }
+}
+
+// True while another sensor on the same pin is between broadcast Convert T and its read
+bool oneWireConversionPending(int pin, uint8_t sensorIndex) {
+    for (uint8_t i = 0; i < oneWireQueue.count; i++) {
+        const BusOperation& other = oneWireQueue.at(i);
+        if (other.sensorIndex == sensorIndex || configuredSensors[other.sensorIndex].oneWirePin != pin) continue;
+        if (other.state != BusOpState::IDLE) return true;
+    }
+    return false;
+}
+
+// One Skip ROM + Convert T per pin starts every device converting at once; each
+// sensor then reads its own scratchpad with Match ROM. Buses on different pins
+// run their transactions in parallel.
+void processOneWireQueue() {
+    if (oneWireBusesStale) {
+        // Terminal One-Wire commands drive pins with pinMode(); hand them back to PIO
+        for (int i = 0; i < MAX_ONEWIRE_BUSES; i++) {
+            if (oneWireBuses[i].pin < 0) continue;
+            if (oneWireBuses[i].active) oneWireAbort(oneWireBuses[i]);
+            oneWireInitPin(oneWireBuses[i]);
+        }
+        oneWireBusesStale = false;
+    }
+    
+    if (oneWireRescanRequested) {
+        oneWireRescanRequested = false;
+        for (int i = 0; i < numConfiguredSensors; i++) {
+            if (sensorBusForProtocol(configuredSensors[i].protocol) != SensorBus::ONEWIRE) continue;
+            OneWireBus* bus = oneWireBusForPin(configuredSensors[i].oneWirePin);
+            if (bus != nullptr) bus->searched = false;
+        }
+    }
+    if (oneWirePersistRequested) {
+        oneWirePersistRequested = false;
+        for (int i = 0; i < MAX_ONEWIRE_BUSES; i++) {
+            oneWireBuses[i].persistPending = oneWireBuses[i].pin >= 0;
+        }
+    }
+    for (int i = 0; i < MAX_ONEWIRE_BUSES; i++) {
+        OneWireBus& bus = oneWireBuses[i];
+        if (bus.pin < 0 || bus.active) continue;
+        if (!bus.searched) {
+            oneWireSearchBus(bus);
+            assignOneWireDevices(bus);
+            configureOneWireSensors(bus, false);
+        }
+        if (bus.persistPending) {
+            bus.persistPending = false;
+            configureOneWireSensors(bus, true);
+        }
+    }
+    
+    unsigned long currentTime = millis();
+    for (uint8_t opIndex = 0; opIndex < oneWireQueue.count; opIndex++) {
+        BusOperation& op = oneWireQueue.at(opIndex);
+        SensorConfig& sensor = configuredSensors[op.sensorIndex];
+        int owPin = sensor.oneWirePin;
+        OneWireBus* bus = oneWireBusForPin(owPin);
+        if (bus == nullptr) {
+            strcpy(sensor.rawDataString, "INVALID_PIN");
+            finishBusOperation(oneWireQueue, opIndex);
+            return;
+        }
+        
+        // The pin is busy with another sensor's transaction
+        bool ownsBus = bus->active && bus->owner == op.sensorIndex;
+        if (bus->active && !ownsBus) continue;
+        
+        uint8_t rx[ONEWIRE_MAX_TRANSFER];
+        OneWireResult result;
+        
+        switch(op.state) {
+            case BusOpState::IDLE: {
+                if (!ownsBus) {
+                    // Join the next broadcast rather than restarting conversions that are still being read out
+                    if (oneWireConversionPending(owPin, op.sensorIndex)) break;
+                    
+                    // Skip ROM (0xCC) + Convert T (0x44), addressed to every device on the pin
+                    const uint8_t convert[] = {0xCC, 0x44};
+                    oneWireBegin(*bus, convert, sizeof(convert));
+                    bus->owner = op.sensorIndex;
+                    logOneWireTransaction(String(owPin), "TX", "0xCC 0x44 (Skip ROM + Convert T)");
+                    break;
                 }
                 
-                // Read Scratchpad command
-                for (int bit = 0; bit < 8; bit++) {
-                    pinMode(owPin, OUTPUT);
-                    digitalWrite(owPin, LOW);
-                    if ((0xBE >> bit) & 1) {
-                        delayMicroseconds(6);
-                        pinMode(owPin, INPUT_PULLUP);
-                        delayMicroseconds(64);
-                    } else {
-                        delayMicroseconds(60);
-                        pinMode(owPin, INPUT_PULLUP);
-                        delayMicroseconds(10);
+                result = oneWirePoll(*bus, rx);
+                if (result == OneWireResult::DONE) {
+                    // Every sensor queued on this pin is converting now
+                    for (uint8_t i = 0; i < oneWireQueue.count; i++) {
+                        BusOperation& queued = oneWireQueue.at(i);
+                        if (queued.state != BusOpState::IDLE || configuredSensors[queued.sensorIndex].oneWirePin != owPin) continue;
+                        queued.state = BusOpState::WAITING_CONVERSION;
+                        queued.startTime = currentTime;
+                        configuredSensors[queued.sensorIndex].lastOneWireCmd = currentTime;
                     }
-                }
-                
-                // Read scratchpad data
-                for (int i = 0; i < 9 && readOk; i++) {
-                    uint8_t value = 0;
-                    for (int bit = 0; bit < 8; bit++) {
-                        pinMode(owPin, OUTPUT);
-                        digitalWrite(owPin, LOW);
-                        delayMicroseconds(3);
-                        pinMode(owPin, INPUT_PULLUP);
-                        delayMicroseconds(10);
-                        if (digitalRead(owPin)) {
-                            value |= (1 << bit);
-                        }
-                        delayMicroseconds(53);
+                } else if (result != OneWireResult::BUSY) {
+                    logOneWireTransaction(String(owPin), "ERR", result == OneWireResult::NO_PRESENCE ? "No presence pulse" : "Transfer timeout");
+                    if (++op.retryCount >= 3) {
+                        finishBusOperation(oneWireQueue, opIndex);
+                        return;
                     }
-                    scratchpad[i] = value;
                 }
+                break;
+            }
+
+            case BusOpState::REQUEST_SENT:
+            case BusOpState::WAITING_CONVERSION:
+                if (currentTime - op.startTime >= op.conversionTime) {
+                    op.state = BusOpState::READY_TO_READ;
+                }
+                break;
+
+            case BusOpState::READY_TO_READ: {
+                if (!ownsBus) {
+                    // Match ROM or Skip ROM, then Read Scratchpad (0xBE) + 9 read slots
+                    uint8_t readScratchpad[ONEWIRE_MAX_TRANSFER];
+                    uint8_t length = oneWireSelectSensor(op.sensorIndex, readScratchpad);
+                    readScratchpad[length++] = 0xBE;
+                    memset(&readScratchpad[length], 0xFF, 9);
+                    length += 9;
+                    
+                    oneWireBegin(*bus, readScratchpad, length);
+                    bus->owner = op.sensorIndex;
+                    break;
+                }
+                
+                result = oneWirePoll(*bus, rx);
+                if (result == OneWireResult::BUSY) break;
                 
-                // Print scratchpad for debugging
-                // (Disabled for cleaner serial output)
-                /*
-                // Skip CRC validation for now - DS18B20 often has CRC issues with bit-banged implementation
-                // if (op.needsCRC && !validateCRC(scratchpad, 9)) {
-                //     Serial.printf("[DEBUG] One-Wire: CRC failed for sensor %d\n", op.sensorIndex);
-                //     readOk = false;
-                // }
-                */
-
-                if (readOk) {
-                    // Convert raw data to temperature (DS18B20 format)
-                    int16_t raw = (scratchpad[1] << 8) | scratchpad[0];
-                    float temp = raw / 16.0;
+                if (result == OneWireResult::DONE) {
+                    uint8_t* scratchpad = &rx[oneWireSensorAddressed[op.sensorIndex] ? 10 : 2];
+                    
+                    // An all-zero block passes CRC8 trivially (bus held low), so reject it explicitly
+                    bool allZero = true;
+                    for (int i = 0; i < 9; i++) {
+                        if (scratchpad[i] != 0) allZero = false;
+                    }
+                    bool readOk = !allZero && (!op.needsCRC || validateCRC(scratchpad, 9));
                     
                     // Log the One-Wire read for terminal watch
-                    char readData[64];
-                    snprintf(readData, sizeof(readData), "Scratchpad: %02X %02X %02X %02X %02X %02X %02X %02X %02X (%.2f°C)", 
+                    char readData[80];
+                    snprintf(readData, sizeof(readData), "Scratchpad: %02X %02X %02X %02X %02X %02X %02X %02X %02X%s", 
                              scratchpad[0], scratchpad[1], scratchpad[2], scratchpad[3], scratchpad[4], 
-                             scratchpad[5], scratchpad[6], scratchpad[7], scratchpad[8], temp);
+                             scratchpad[5], scratchpad[6], scratchpad[7], scratchpad[8], readOk ? "" : " (CRC error)");
                     logOneWireTransaction(String(owPin), "RX", String(readData));
-                    
-                    // Apply calibration using expression-capable function
-                    float calibratedTemp = applyCalibration(temp, configuredSensors[op.sensorIndex]);
-                    
-                    configuredSensors[op.sensorIndex].rawValue = temp;
-                    configuredSensors[op.sensorIndex].calibratedValue = calibratedTemp;
-                    configuredSensors[op.sensorIndex].modbusValue = (int)(calibratedTemp * 100);
-                    configuredSensors[op.sensorIndex].lastReadTime = currentTime;
 
-
-
-                    // Format raw data string
-                    char dataStr[32];
-                    snprintf(dataStr, sizeof(dataStr), "%.2f°C", temp);
-                    strncpy(configuredSensors[op.sensorIndex].rawDataString, dataStr, 
-                            sizeof(configuredSensors[op.sensorIndex].rawDataString)-1);
+                    if (readOk) {
+                        // Convert raw data to temperature (DS18B20 format)
+                        int16_t raw = (scratchpad[1] << 8) | scratchpad[0];
+                        if (sensor.oneWireResolution >= 9 && sensor.oneWireResolution < 12) {
+                            raw &= ~((1 << (12 - sensor.oneWireResolution)) - 1);  // Low bits are undefined below 12-bit
+                        }
+                        float temp = raw / 16.0;
+                        
+                        // Apply calibration using expression-capable function
+                        float calibratedTemp = applyCalibration(temp, sensor);
+                        
+                        sensor.rawValue = temp;
+                        sensor.calibratedValue = calibratedTemp;
+                        sensor.modbusValue = sensorModbusValue(sensor, 0, calibratedTemp);
+                        recordSensorRead(op.sensorIndex, currentTime);
+
+                        // Format raw data string
+                        char dataStr[32];
+                        snprintf(dataStr, sizeof(dataStr), "%.2f°C", temp);
+                        strncpy(sensor.rawDataString, dataStr, sizeof(sensor.rawDataString)-1);
+                    } else {
+                        strcpy(sensor.rawDataString, "CRC_ERROR");
+                    }
                 } else {
-
+                    logOneWireTransaction(String(owPin), "ERR", result == OneWireResult::NO_PRESENCE ? "No presence pulse" : "Transfer timeout");
                 }
-            } else {
 
+                finishBusOperation(oneWireQueue, opIndex);
+                return;
             }
 
-            // Move to next operation
-            for(int i = 0; i < oneWireQueueSize - 1; i++) {
-                oneWireQueue[i] = oneWireQueue[i + 1];
-            }
-            oneWireQueueSize--;
-            break;
+            case BusOpState::ERROR:
+                finishBusOperation(oneWireQueue, opIndex);
+                return;
+        }
+    }
+}
 
-        case BusOpState::ERROR:
+// Resolve the bus a sensor is polled on from its protocol string
+SensorBus sensorBusForProtocol(const char* protocol) {
+    if (strncmp(protocol, "I2C", 3) == 0) return SensorBus::I2C;
+    if (strncmp(protocol, "UART", 4) == 0) return SensorBus::UART;
+    if (strncmp(protocol, "One-Wire", 8) == 0) return SensorBus::ONEWIRE;
+    return SensorBus::NONE;
+}
 
-            // Move to next operation
-            for(int i = 0; i < oneWireQueueSize - 1; i++) {
-                oneWireQueue[i] = oneWireQueue[i + 1];
-            }
-            oneWireQueueSize--;
-            break;
+// Conversion/settle time between command and read for a sensor type
+uint32_t sensorConversionTime(const SensorConfig& sensor) {
+    if (strcmp(sensor.type, "DS18B20") == 0) {
+        return ds18b20ConversionTime(sensor.oneWireResolution);
+    } else if (sensorBusForProtocol(sensor.protocol) == SensorBus::ONEWIRE) {
+        return sensor.oneWireConversionTime > 0 ? sensor.oneWireConversionTime : 750;
     }
+    return 750; // Default 750ms
+}
+
+// Build the polling schedule from configuredSensors. All string matching on
+// protocol/type happens here, once per configuration change.
+void rebuildSensorSchedule() {
+    sensorSchedule.clear();
+    i2cQueue.clear();
+    uartQueue.clear();
+    oneWireQueue.clear();
+    memset(sensorQueued, 0, sizeof(sensorQueued));
+    oneWireBusesStale = true;       // Drop transactions owned by the old queue entries
+    oneWireRescanRequested = true;  // Pins and ROM assignments may have changed
+    
+    uint32_t now = millis();
+    for (int i = 0; i < numConfiguredSensors; i++) {
+        if (!configuredSensors[i].enabled) continue;
+        
+        SensorBus bus = sensorBusForProtocol(configuredSensors[i].protocol);
+        if (bus == SensorBus::NONE) continue;
+        if (bus == SensorBus::I2C && isEzoType(configuredSensors[i].type)) continue;  // Read by the EZO cycle
+        if (bus == SensorBus::I2C && strcmp(configuredSensors[i].type, "LIS3DH") == 0) continue;  // FIFO stream
+        
+        SensorCommand cmd = {
+            .sensorIndex = (uint8_t)i,
+            .bus = bus,
+            .nextExecutionMs = now,  // First poll immediately
+            .intervalMs = (uint32_t)(configuredSensors[i].updateInterval > 0 ? configuredSensors[i].updateInterval : 1000),
+            .conversionMs = sensorConversionTime(configuredSensors[i])
+        };
+        sensorSchedule.add(cmd);
+    }
+    
+    rebuildEzoCycle();
+    rebuildLIS3DHStreams();
 }
 
-void enqueueBusOperation(uint8_t sensorIndex, const char* protocol) {
-    if (!configuredSensors[sensorIndex].enabled) return;
+void enqueueBusOperation(const SensorCommand& cmd) {
+    if (!configuredSensors[cmd.sensorIndex].enabled) return;
     
-    // Prevent duplicate operations in queue for the same sensor
-    // This avoids queuing up multiple pending reads while one is still processing
-    if (strcmp(protocol, "One-Wire") == 0) {
-        for (int i = 0; i < oneWireQueueSize; i++) {
-            if (oneWireQueue[i].sensorIndex == sensorIndex) {
-                // Operation for this sensor already pending, skip
-                return;
-            }
-        }
-    } else if (strcmp(protocol, "I2C") == 0) {
-        for (int i = 0; i < i2cQueueSize; i++) {
-            if (i2cQueue[i].sensorIndex == sensorIndex) {
-                // Operation for this sensor already pending, skip
-                return;
-            }
-        }
-    } else if (strcmp(protocol, "UART") == 0) {
-        for (int i = 0; i < uartQueueSize; i++) {
-            if (uartQueue[i].sensorIndex == sensorIndex) {
-                // Operation for this sensor already pending, skip
-                return;
-            }
-        }
-    }
+    // Skip if this sensor's previous read is still pending on its bus
+    if (sensorQueued[cmd.sensorIndex]) return;
     
     BusOperation op = {
-        .sensorIndex = sensorIndex,
-            .startTime = millis(),
-        .conversionTime = 750, // Default 750ms, adjust per sensor type
+        .sensorIndex = cmd.sensorIndex,
+        .startTime = millis(),
+        .conversionTime = cmd.conversionMs,
         .state = BusOpState::IDLE,
         .retryCount = 0,
         .needsCRC = true
     };
     
-    // Adjust conversion time based on sensor type
-    if (strcmp(configuredSensors[sensorIndex].type, "EZO-PH") == 0) {
-        op.conversionTime = 900; // Atlas Scientific pH spec: 900ms
-    } else if (strcmp(configuredSensors[sensorIndex].type, "EZO-EC") == 0) {
-        op.conversionTime = 900;
-    } else if (strcmp(configuredSensors[sensorIndex].type, "LIS3DH") == 0) {
-        op.conversionTime = 0; // Direct register read, no conversion time needed (just 1ms in WAITING_CONVERSION state)
-    } else if (strcmp(configuredSensors[sensorIndex].type, "DS18B20") == 0) {
-        op.conversionTime = configuredSensors[sensorIndex].oneWireConversionTime;
-        if (op.conversionTime <= 0) op.conversionTime = 750;
-    }
-    
-    // Add to appropriate queue
-    if (strcmp(protocol, "I2C") == 0 && i2cQueueSize < MAX_SENSORS) {
-        i2cQueue[i2cQueueSize++] = op;
-    } else if (strcmp(protocol, "UART") == 0 && uartQueueSize < MAX_SENSORS) {
-        uartQueue[uartQueueSize++] = op;
-    } else if (strcmp(protocol, "One-Wire") == 0 && oneWireQueueSize < MAX_SENSORS) {
-        oneWireQueue[oneWireQueueSize++] = op;
+    bool queued = false;
+    switch (cmd.bus) {
+        case SensorBus::I2C:     queued = i2cQueue.push(op); break;
+        case SensorBus::UART:    queued = uartQueue.push(op); break;
+        case SensorBus::ONEWIRE: queued = oneWireQueue.push(op); break;
+        default: break;
     }
+    sensorQueued[cmd.sensorIndex] = queued;
 }
 
 void updateBusQueues() {
-    static unsigned long lastQueueUpdate = 0;
-    unsigned long currentTime = millis();
+    uint32_t currentTime = millis();
     
-    // Update every 100ms
-    if (currentTime - lastQueueUpdate < 100) return;
-    lastQueueUpdate = currentTime;
-    
-    // Check each enabled sensor
-    for (int i = 0; i < numConfiguredSensors; i++) {
-        if (!configuredSensors[i].enabled) continue;
-        
-        // Add to queue if it's time for next reading
-        if (currentTime - configuredSensors[i].lastReadTime >= configuredSensors[i].updateInterval) {
-            if (strncmp(configuredSensors[i].protocol, "I2C", 3) == 0) {
-                enqueueBusOperation(i, "I2C");
-            } else if (strncmp(configuredSensors[i].protocol, "UART", 4) == 0) {
-                enqueueBusOperation(i, "UART");
-            } else if (strncmp(configuredSensors[i].protocol, "One-Wire", 8) == 0) {
-                enqueueBusOperation(i, "One-Wire");
-            }
-        }
+    // Release every command whose deadline has passed; the heap top is always the earliest
+    SensorCommand* next;
+    while ((next = sensorSchedule.peek()) != nullptr &&
+           !SensorScheduler::dueBefore(currentTime, next->nextExecutionMs)) {
+        enqueueBusOperation(*next);
+        sensorSchedule.rescheduleTop(currentTime);
     }
     
     // Process queues
@@ -1241,24 +1615,48 @@ void updateBusQueues() {
     processOneWireQueue();
 }
 
-// EZO sensor functionality 
-Ezo_board* ezoSensors[MAX_SENSORS] = {nullptr};
-bool ezoSensorsInitialized = false;
-
 // Terminal monitoring variables
 bool terminalWatchActive = false;
 String watchedPin = "";
 String watchedProtocol = "";
 std::vector<String> terminalBuffer;
+uint32_t terminalLogSequence = 0;  // Entries ever added; /events streams send the ones they have not seen
+
+// Bus traffic is logged from core1 while core0 serves /terminal/* requests;
+// the watch settings and log buffer are only touched with this mutex held
+auto_init_recursive_mutex(terminalLogMutex);
+
+struct TerminalLogLock {
+    TerminalLogLock() { recursive_mutex_enter_blocking(&terminalLogMutex); }
+    ~TerminalLogLock() { recursive_mutex_exit(&terminalLogMutex); }
+};
+
+// Copy a log entry for JSON output (caller holds TerminalLogLock). Line breaks and tabs
+// are shown as \n, \r, \t text; other control bytes are dropped.
+void formatTerminalLogLine(const String& line, char* entry, size_t size) {
+    size_t n = 0;
+    for (unsigned int j = 0; j < line.length() && n < size - 2; j++) {
+        char c = line[j];
+        if (c >= 32 && c <= 126) {
+            entry[n++] = c;
+        } else if (c == '\n' || c == '\r' || c == '\t') {
+            entry[n++] = '\\';
+            entry[n++] = c == '\n' ? 'n' : (c == '\r' ? 'r' : 't');
+        }
+    }
+    entry[n] = '\0';
+}
 
 // Bus traffic logging functions
 void addTerminalLog(String message) {
     if (!terminalWatchActive) return;
+    TerminalLogLock lock;
     
     String timestamp = String(millis());
     String logEntry = "[" + timestamp + "] " + message;
     
     terminalBuffer.push_back(logEntry);
+    terminalLogSequence++;
     if (terminalBuffer.size() > MAX_TERMINAL_BUFFER) {
         terminalBuffer.erase(terminalBuffer.begin());
     }
@@ -1272,6 +1670,7 @@ void logI2CTransaction(int address, String direction, String data, String pin) {
     bool shouldLog = false;
     
     if (terminalWatchActive) {
+        TerminalLogLock lock;
         // Debug what we're checking
         Serial.printf("DEBUG logI2C: addr=0x%02X, dir=%s, pin=%s, watchedPin=%s, watchedProtocol=%s\n", 
                      address, direction.c_str(), pin.c_str(), watchedPin.c_str(), watchedProtocol.c_str());
@@ -1327,6 +1726,7 @@ void logOneWireTransaction(String pin, String direction, String data) {
     bool shouldLog = false;
     
     if (terminalWatchActive) {
+        TerminalLogLock lock;
         // Extract pin number from pin string (handle both "28" and "GP28" formats)
         int pinNumber = pin.toInt();
         if (pinNumber == 0 && pin.startsWith("GP")) {
@@ -1362,6 +1762,7 @@ void logUARTTransaction(String pin, String direction, String data) {
     bool shouldLog = false;
     
     if (terminalWatchActive) {
+        TerminalLogLock lock;
         // Support both pin numbers and sensor names
         if (watchedPin == "all" || watchedPin == pin) {
             shouldLog = true;
@@ -1399,6 +1800,7 @@ void logUARTTransaction(String pin, String direction, String data) {
 // Log network transaction for terminal watch
 void logNetworkTransaction(String protocol, String direction, String localAddr, String remoteAddr, String data) {
     if (!terminalWatchActive) return;
+    TerminalLogLock lock;
     
     // Check protocol (case insensitive)
     String watchedProtocolUpper = watchedProtocol;
@@ -1428,14 +1830,22 @@ void sendJSON(WiFiClient& client, String json) {
     response += "Access-Control-Allow-Origin: *\r\n";
     response += "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n";
     response += "Access-Control-Allow-Headers: Content-Type\r\n";
-    response += "Connection: close\r\n";
+    response += httpConnectionHeader();
+    response += "\r\n";
     response += "Content-Length: " + String(json.length()) + "\r\n";
     response += "\r\n";
     
     // Send headers and body
     client.print(response);
     client.print(json);
-    client.flush();
+}
+
+// Finish a streamed JSON response and log it like sendJSON()
+void endJSONStream(WiFiClient& client, ChunkedResponse& out) {
+    out.end();
+    String remoteIP = client.remoteIP().toString();
+    String localIP = eth.localIP().toString() + ":" + String(HTTP_PORT);
+    logNetworkTransaction("HTTP", "TX", localIP, remoteIP, "200 OK (JSON stream: " + String((unsigned long)out.total) + " bytes)");
 }
 
 // Send 404 response helper
@@ -1452,13 +1862,13 @@ void send404(WiFiClient& client) {
     response += "Access-Control-Allow-Origin: *\r\n";
     response += "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n";
     response += "Access-Control-Allow-Headers: Content-Type\r\n";
-    response += "Connection: close\r\n";
+    response += httpConnectionHeader();
+    response += "\r\n";
     response += "Content-Length: " + String(notFoundBody.length()) + "\r\n";
     response += "\r\n";
     
     client.print(response);
     client.print(notFoundBody);
-    client.flush();
 }
 
 String executeTerminalCommand(String command, String pin, String protocol) {
@@ -1548,7 +1958,8 @@ void setup() {
 
     // Initialize LittleFS for web file serving
     Serial.println("Initializing filesystem...");
-    if (!LittleFS.begin()) {
+    fileSystemMounted = LittleFS.begin();
+    if (!fileSystemMounted) {
         Serial.println("LittleFS mount failed!");
     } else {
         Serial.println("LittleFS mounted successfully");
@@ -1616,41 +2027,16 @@ void setup() {
     // Initialize command queues
     Serial.printf("Sensors: %d configured\n", numConfiguredSensors);
     
-    // Initialize bus queues and command arrays
-    i2cQueueSize = 0;
-    uartQueueSize = 0;
-    oneWireQueueSize = 0;
-    i2cCommands.init();
-    uartCommands.init();
-    oneWireCommands.init();
-    
     for (int i = 0; i < numConfiguredSensors; i++) {
         Serial.printf("Sensor[%d]: %s (%s) - %s\n", i, configuredSensors[i].name, configuredSensors[i].type, configuredSensors[i].enabled ? "ENABLED" : "DISABLED");
-        
-        // Initialize sensor commands
-        if (configuredSensors[i].enabled) {
-            SensorCommand cmd = {
-                .sensorIndex = (uint8_t)i,
-                .nextExecutionMs = millis(),
-                .intervalMs = configuredSensors[i].updateInterval,
-                .command = (strcmp(configuredSensors[i].type, "GENERIC") == 0) ? configuredSensors[i].command : nullptr,
-                .isGeneric = (strcmp(configuredSensors[i].type, "GENERIC") == 0)
-            };
-            
-            // Add to appropriate command array (including SHT30 sensors)
-            if (strncmp(configuredSensors[i].protocol, "I2C", 3) == 0) {
-                i2cCommands.add(cmd);
-                // Queue initial bus operation
-                enqueueBusOperation(i, "I2C");
-            } else if (strncmp(configuredSensors[i].protocol, "UART", 4) == 0) {
-                uartCommands.add(cmd);
-                enqueueBusOperation(i, "UART");
-            } else if (strncmp(configuredSensors[i].protocol, "One-Wire", 8) == 0) {
-                oneWireCommands.add(cmd);
-                enqueueBusOperation(i, "One-Wire");
-            }
-        }
     }
+    
+    // Gateway polls size the image, so they load before the register map is compiled
+    loadGatewayConfig();
+    
+    // Build the polling schedule (initial reads are due immediately)
+    rebuildSensorSchedule();
+    compileRegisterMap();
 
     Serial.println("Setting pin modes...");
     setPinModes();
@@ -1668,6 +2054,7 @@ void setup() {
 
     // Initialize I2C bus with default pins (GP4=SDA, GP5=SCL)
     Wire.begin();
+    Wire.setClock(I2C_BUS_CLOCK_HZ);
     Serial.println("I2C initialized on default pins (GP4=SDA, GP5=SCL)");
     
     // Scan for I2C devices at startup
@@ -1684,82 +2071,11 @@ void setup() {
         Serial.println("No I2C devices found");
     }
     
-    // Initialize any LIS3DH sensors that are configured and enabled
-    for (int i = 0; i < numConfiguredSensors; i++) {
-        if (configuredSensors[i].enabled && strcmp(configuredSensors[i].type, "LIS3DH") == 0) {
-            uint8_t addr = configuredSensors[i].i2cAddress;
-            Serial.printf("[Setup] Initializing LIS3DH at 0x%02X\n", addr);
-            
-            // First verify WHO_AM_I register (0x0F should return 0x33)
-            Wire.beginTransmission(addr);
-            Wire.write(0x0F);  // WHO_AM_I register
-            Wire.endTransmission();
-            delay(5);
-            Wire.requestFrom(addr, 1);
-            if (Wire.available()) {
-                uint8_t whoami = Wire.read();
-                Serial.printf("[Setup] LIS3DH WHO_AM_I = 0x%02X (expect 0x33)\n", whoami);
-                if (whoami != 0x33) {
-                    Serial.printf("[Setup] WARNING: Unexpected WHO_AM_I value! Device may not be LIS3DH\n");
-                }
-            } else {
-                Serial.printf("[Setup] WARNING: Could not read WHO_AM_I from LIS3DH\n");
-            }
-            delay(10);
-            
-            // Configure LIS3DH: CTRL_REG1 (0x20) = 0x96
-            // Bit 7-4: ODR[3:0] = 1001 (1344 Hz, fastest normal mode)
-            // Bit 3: Zen = 1 - Enable Z-axis
-            // Bit 2: Yen = 1 - Enable Y-axis
-            // Bit 1: Xen = 1 - Enable X-axis
-            // Bit 0: LP = 0 - Normal mode (not low power)
-            // 0x96 = 10010110 = 1344 Hz, all axes enabled, normal mode
-            Wire.beginTransmission(addr);
-            Wire.write(0x20);  // CTRL_REG1
-            Wire.write(0x96);  // 1344 Hz, all axes enabled, normal mode
-            if (Wire.endTransmission() == 0) {
-                Serial.printf("[Setup] LIS3DH CTRL_REG1 (0x20) set to 0x96 OK (1344 Hz, all axes, normal mode)\n");
-            } else {
-                Serial.printf("[Setup] LIS3DH CTRL_REG1 config failed\n");
-            }
-            
-            // Configure LIS3DH: CTRL_REG4 (0x23) = 0x80
-            // Bit 7: BDU (1) - Block Data Update (wait for both MSB/LSB before reading)
-            // Bit 6: BLE (0) - Big Endian (0 = Little Endian)
-            // Bits 5-4: FS1, FS0 (00) - Full Scale ±2g (Raspberry Pi reference uses this)
-            // Bit 3: HR (0) - High Resolution disabled (standard 10-bit mode)
-            // 0x80 = 1000 0000 = ±2g range, BDU enabled
-            // Per RP reference: sensitivity = 0.004g per LSB in this standard mode
-            delay(10);
-            Wire.beginTransmission(addr);
-            Wire.write(0x23);  // CTRL_REG4
-            Wire.write(0x80);  // ±2g range with BDU enabled (standard mode, per RP reference)
-            if (Wire.endTransmission() == 0) {
-                Serial.printf("[Setup] LIS3DH CTRL_REG4 (0x23) set to 0x80 OK (±2g, standard mode)\n");
-            } else {
-                Serial.printf("[Setup] LIS3DH CTRL_REG4 config failed\n");
-            }
-            
-            // Turn auxiliary ADC on (for temperature sensing, optional but included per RP reference)
-            delay(10);
-            Wire.beginTransmission(addr);
-            Wire.write(0x1F);  // TEMP_CFG_REG
-            Wire.write(0xC0);  // Temperature sensor enabled
-            if (Wire.endTransmission() == 0) {
-                Serial.printf("[Setup] LIS3DH TEMP_CFG_REG (0x1F) set to 0xC0 OK\n");
-            } else {
-                Serial.printf("[Setup] LIS3DH TEMP_CFG_REG config failed\n");
-            }
-            
-            Serial.printf("[Setup] LIS3DH at 0x%02X initialized successfully\n", addr);
-            
-            // Give sensor time to start outputting data after initialization
-            delay(500);  // Wait 500ms for first data to be available
-        }
-    }
-
     // Start watchdog
     rp2040.wdt_begin(WDT_TIMEOUT);
+    
+    // Buses are initialized; hand sensor polling over to core1
+    core0setupComplete = true;
     Serial.println("Setup complete.");
 }
 
@@ -1839,7 +2155,7 @@ void handlePOSTTerminalCommand(WiFiClient& client, String body) {
                 int pinNum = pin.substring(2).toInt();
                 if (pinNum >= 0 && pinNum < 8) {
                     bool state = digitalRead(DIGITAL_INPUTS[pinNum]);
-                    bool raw = ioStatus.dInRaw[pinNum];
+                    bool raw = ioBit(ioStatus.dInRaw, pinNum);
                     response = pin + " = " + (state ? "HIGH" : "LOW") + " (Raw: " + (raw ? "HIGH" : "LOW") + ")";
                 } else {
                     success = false;
@@ -1848,7 +2164,7 @@ void handlePOSTTerminalCommand(WiFiClient& client, String body) {
             } else if (pin.startsWith("DO")) {
                 int pinNum = pin.substring(2).toInt();
                 if (pinNum >= 0 && pinNum < 8) {
-                    bool state = ioStatus.dOut[pinNum];
+                    bool state = ioBit(ioStatus.dOut, pinNum);
                     response = pin + " = " + (state ? "HIGH" : "LOW");
                 } else {
                     success = false;
@@ -1865,15 +2181,10 @@ void handlePOSTTerminalCommand(WiFiClient& client, String body) {
                 int pinNum = pin.substring(2).toInt();
                 if (pinNum >= 0 && pinNum < 8) {
                     bool state = (value == "1" || value.equalsIgnoreCase("HIGH"));
-                    ioStatus.dOut[pinNum] = state;
-                    digitalWrite(DIGITAL_OUTPUTS[pinNum], config.doInvert[pinNum] ? !state : state);
+                    setDigitalOutput(pinNum, state);
                     
-                    // Update all connected Modbus clients
-                    for (int i = 0; i < MAX_MODBUS_CLIENTS; i++) {
-                        if (modbusClients[i].connected) {
-                            modbusClients[i].server.coilWrite(pinNum, state);
-                        }
-                    }
+                    // Update the shared Modbus coil so every client sees it
+                    modbusImage.coilWrite(pinNum, state);
                     
                     response = pin + " set to " + (state ? "HIGH" : "LOW");
                 } else {
@@ -1896,9 +2207,11 @@ void handlePOSTTerminalCommand(WiFiClient& client, String body) {
                         response = pin + " pullup " + (config.diPullup[pinNum] ? "ENABLED" : "DISABLED");
                     } else if (option == "invert") {
                         config.diInvert[pinNum] = !config.diInvert[pinNum];
+                        rebuildIOMasks();
                         response = pin + " invert " + (config.diInvert[pinNum] ? "ENABLED" : "DISABLED");
                     } else if (option == "latch") {
                         config.diLatch[pinNum] = !config.diLatch[pinNum];
+                        rebuildIOMasks();
                         response = pin + " latch " + (config.diLatch[pinNum] ? "ENABLED" : "DISABLED");
                     } else {
                         success = false;
@@ -2184,9 +2497,13 @@ void handlePOSTTerminalCommand(WiFiClient& client, String body) {
         } else if (command == "clients") {
             response = "Modbus Clients:\\n";
             response += "Connected: " + String(connectedClients) + "\\n";
+            response += "Pool: " + String(config.modbusMaxClients) + ", evicted: " + String(modbusPoolStats.evicted) +
+                        ", idle closed: " + String(modbusPoolStats.idleClosed) + ", rejected: " + String(modbusPoolStats.rejected) + "\\n";
             for (int i = 0; i < MAX_MODBUS_CLIENTS; i++) {
                 if (modbusClients[i].connected) {
-                    response += "Slot " + String(i) + ": " + modbusClients[i].clientIP.toString() + "\\n";
+                    response += "Slot " + String(i) + ": " + modbusClients[i].clientIP.toString() +
+                                " age " + String((millis() - modbusClients[i].connectionTime) / 1000) + "s, idle " +
+                                String((millis() - modbusClients[i].lastActivity) / 1000) + "s\\n";
                 }
             }
         } else if (command == "link") {
@@ -2538,6 +2855,9 @@ void handlePOSTTerminalCommand(WiFiClient& client, String body) {
         if (txPin < 0 || rxPin < 0 || txPin > 28 || rxPin > 28) {
             success = false;
             response = "Error: Invalid UART pins. Use 'GP<tx>,GP<rx>' format or configured sensor name";
+        } else if (modbusRtu.port == 0 && command != "info" && command != "config") {
+            success = false;
+            response = "Error: UART0 (Serial1) is in use by the Modbus RTU server";
         } else if (command == "info") {
             response = "UART Information for TX:GP" + String(txPin) + ", RX:GP" + String(rxPin) + ":\\n";
             response += "Protocol: Universal Asynchronous Receiver-Transmitter\\n";
@@ -2715,120 +3035,68 @@ void handlePOSTTerminalCommand(WiFiClient& client, String body) {
     client.print(jsonResp);
 }
 void loop() {
-    static unsigned long lastWebCheck = 0;
     static unsigned long lastStats = 0;
-    static unsigned long webRequests = 0;
+    static uint32_t lastHttpRequests = 0;
     static unsigned long loopCount = 0;
     unsigned long now = millis();
     
-    // Process web requests more frequently
-    if (now - lastWebCheck >= 1) {  // Check every 1ms
-        handleSimpleHTTP();
-        lastWebCheck = now;
-    }
+    pollHttpServer();
     
     // Print stats every 5 seconds
     if (now - lastStats >= 5000) {
         Serial.print("Loop frequency: ");
         Serial.print(loopCount / 5);
         Serial.println(" Hz");
-        Serial.print("Web requests/5s: ");
-        Serial.println(webRequests);
+        Serial.printf("Web requests/5s: %lu (%lu on reused connections, %lu connections accepted)\n",
+                      (unsigned long)(httpServerStats.requests - lastHttpRequests),
+                      (unsigned long)httpServerStats.reused, (unsigned long)httpServerStats.accepted);
         Serial.print("Free RAM: ");
         Serial.println(rp2040.getFreeHeap());
         loopCount = 0;
-        webRequests = 0;
+        lastHttpRequests = httpServerStats.requests;
         lastStats = now;
     }
     
-    // Update bus operation queues
-    updateBusQueues();
-
     // Check for new client connections on the WiFi server (actually Ethernet via W5500lwIP)
     WiFiClient newClient = modbusServer.accept();
     loopCount++;
     
     if (newClient) {
-        // Find an available slot for the new client
-        bool clientAdded = false;
-        for (int i = 0; i < MAX_MODBUS_CLIENTS; i++) {
-            if (!modbusClients[i].connected) {
-                Serial.print("New client connected to slot ");
-                Serial.println(i);
-                
-                // Store the client and mark as connected
-                modbusClients[i].client = newClient;
-                modbusClients[i].connected = true;
-                modbusClients[i].clientIP = newClient.remoteIP();
-                modbusClients[i].connectionTime = millis();
-                
-                // Accept the connection on this server instance
-                modbusClients[i].server.accept(modbusClients[i].client);
-                Serial.println("Modbus server accepted client connection");
-                
-                // Log Modbus connection for network monitoring
-                String remoteIP = modbusClients[i].clientIP.toString();
-                String localIP = eth.localIP().toString() + ":" + String(config.modbusPort);
-                logNetworkTransaction("MODBUS", "CONNECT", localIP, remoteIP, "New Modbus TCP connection established");
-                
-                // Initialize coil states for this client to match current output states
-                for (int j = 0; j < 8; j++) {
-                    modbusClients[i].server.coilWrite(j, ioStatus.dOut[j]);
-                }
-                
-                connectedClients++;
-                clientAdded = true;
-                digitalWrite(LED_BUILTIN, HIGH);  // Turn on LED when at least one client is connected
-                break;
-            }
-        }
-        
-        if (!clientAdded) {
-            Serial.println("No available slots for new client");
-            newClient.stop();
-        }
+        acceptModbusClient(newClient);
     }
     
     // Poll all connected clients
     for (int i = 0; i < MAX_MODBUS_CLIENTS; i++) {
-        if (modbusClients[i].connected) {
-            if (modbusClients[i].client.connected()) {
-                // Poll this client's Modbus server
-                if (modbusClients[i].server.poll()) {
-                    Serial.println("Modbus server recieved new request");
-                    
-                    // Log Modbus request for network monitoring
-                    String remoteIP = modbusClients[i].clientIP.toString();
-                    String localIP = eth.localIP().toString() + ":" + String(config.modbusPort);
-                    logNetworkTransaction("MODBUS", "RX", localIP, remoteIP, "Modbus Request (Function Code Processing)");
-                }
-                // Update IO for this specific client
-                updateIOForClient(i);
-            } else {
-                // Client disconnected
-                Serial.print("Client disconnected from slot ");
-                Serial.println(i);
-                
-                // Log Modbus disconnection for network monitoring
-                String remoteIP = modbusClients[i].clientIP.toString();
-                String localIP = eth.localIP().toString() + ":" + String(config.modbusPort);
-                logNetworkTransaction("MODBUS", "DISCONNECT", localIP, remoteIP, "Modbus TCP connection closed");
-                
-                modbusClients[i].connected = false;
-                modbusClients[i].client.stop();
-                connectedClients--;
-                
-                if (connectedClients == 0) {
-                    digitalWrite(LED_BUILTIN, LOW);  // Turn off LED when no clients are connected
-                }
-            }
+        if (!modbusClients[i].connected) continue;
+        
+        if (!modbusClients[i].client.connected()) {
+            // Closed by the peer, or by lwIP after unanswered keepalive probes
+            modbusPoolStats.disconnected++;
+            closeModbusClient(i, "Modbus TCP connection closed");
+            continue;
+        }
+        
+        // Poll this client's Modbus server; answers every complete request already buffered
+        int handled = modbusClients[i].server.poll();
+        if (handled > 0) {
+            modbusClients[i].lastActivity = millis();
+            
+            // Log Modbus requests for network monitoring
+            String remoteIP = modbusClients[i].clientIP.toString();
+            String localIP = eth.localIP().toString() + ":" + String(config.modbusPort);
+            logNetworkTransaction("MODBUS", "RX", localIP, remoteIP, "Modbus Request x" + String(handled) + " (Function Code Processing)");
+        } else if (config.modbusIdleTimeout > 0 &&
+                   millis() - modbusClients[i].lastActivity > (unsigned long)config.modbusIdleTimeout * 1000UL) {
+            modbusPoolStats.idleClosed++;
+            closeModbusClient(i, "Modbus TCP connection closed (idle timeout)");
         }
     }
     
+    pollModbusRTU();
+    
     updateIOpins();
-    // updateSensorReadings();  // DISABLED - SHT30 sensors now handled in queue system
-    handleEzoSensors(); // Handle EZO sensor communications with logging
-    handleLIS3DHSensors(); // Handle LIS3DH accelerometer polling using Adafruit library (low-freq, non-blocking)
+    updateModbusImage();  // Once per pass, shared by all clients
+    // Sensor buses (queues, EZO, LIS3DH, analog sensors) are serviced by loop1() on core1
     
     // Debug: Web server check (every 30 seconds)
     static unsigned long lastWebDebug = 0;
@@ -2864,19 +3132,24 @@ void loop() {
         } else if (cmd.equalsIgnoreCase("sensors")) {
             Serial.println("=== SENSOR STATUS ===");
             Serial.printf("Configured sensors: %d\n", numConfiguredSensors);
-            Serial.printf("Queue sizes - I2C: %d, UART: %d, One-Wire: %d\n", i2cQueueSize, uartQueueSize, oneWireQueueSize);
+            Serial.printf("Queue sizes - I2C: %d, UART: %d, One-Wire: %d\n", i2cQueue.count, uartQueue.count, oneWireQueue.count);
             for (int i = 0; i < numConfiguredSensors; i++) {
+                SensorValues values;
+                readSensorValues(i, values);
                 Serial.printf("[%d] %s (%s): enabled=%s, lastRead=%lu, interval=%d\n", 
                              i, configuredSensors[i].name, configuredSensors[i].type,
                              configuredSensors[i].enabled ? "YES" : "NO",
-                             configuredSensors[i].lastReadTime, configuredSensors[i].updateInterval);
+                             values.lastReadTime, configuredSensors[i].updateInterval);
+                Serial.printf("    Reads: %lu, measured interval: %.1f ms (configured %d ms)\n",
+                             values.readCount, values.measuredIntervalMs,
+                             configuredSensors[i].updateInterval);
                 Serial.printf("    Protocol: %s, I2C: 0x%02X, ModbusReg: %d\n",
                              configuredSensors[i].protocol, configuredSensors[i].i2cAddress, configuredSensors[i].modbusRegister);
                 Serial.printf("    Raw: %.2f, Calibrated: %.2f, Modbus: %d\n",
-                             configuredSensors[i].rawValue, configuredSensors[i].calibratedValue, configuredSensors[i].modbusValue);
+                             values.rawValue, values.calibratedValue, values.modbusValue);
                 if (strcmp(configuredSensors[i].type, "SHT30") == 0) {
                     Serial.printf("    Secondary - Raw: %.2f, Calibrated: %.2f, Modbus: %d\n",
-                                 configuredSensors[i].rawValueB, configuredSensors[i].calibratedValueB, configuredSensors[i].modbusValueB);
+                                 values.rawValueB, values.calibratedValueB, values.modbusValueB);
                 }
             }
             Serial.println("====================");
@@ -2896,160 +3169,575 @@ void loop() {
     rp2040.wdt_reset();
 }
 
-void initializeEzoSensors() {
-    if (ezoSensorsInitialized) return;
-    
+// ============================================================================
+// Sensor engine on core1
+// ============================================================================
+// Core1 owns all sensor bus I/O, parsing and calibration. Core0 (HTTP, Modbus,
+// GPIO) only reads the per-sensor snapshots published at the end of each pass,
+// so a slow bus transaction never delays a Modbus response and a blocking web
+// handler never disturbs sensor timing.
+
+volatile bool sensorCorePauseRequested = false;
+volatile bool sensorCorePaused = false;
+int sensorCorePauseDepth = 0;  // Core0 only
+
+// Read ANALOG_CUSTOM sensors (analog voltage sensors configured in sensors.json)
+void updateAnalogSensors() {
     for (int i = 0; i < numConfiguredSensors; i++) {
-        if (configuredSensors[i].enabled && strncmp(configuredSensors[i].type, "EZO-", 4) == 0) {
-            ezoSensors[i] = new Ezo_board(configuredSensors[i].i2cAddress, configuredSensors[i].name);
-            configuredSensors[i].cmdPending = false;
-            configuredSensors[i].lastCmdSent = 0;
-            memset(configuredSensors[i].response, 0, sizeof(configuredSensors[i].response));
-            Serial.printf("Initialized EZO sensor %s at I2C address 0x%02X\n", 
-                configuredSensors[i].name, configuredSensors[i].i2cAddress);
+        if (!configuredSensors[i].enabled) continue;
+        
+        // Check if sensor should be read based on updateInterval
+        unsigned long currentTime = millis();
+        if (currentTime - configuredSensors[i].lastReadTime >= configuredSensors[i].updateInterval) {
+            
+            if (strncmp(configuredSensors[i].protocol, "Analog", 6) == 0) {
+                // Read analog voltage sensor
+                int pin = configuredSensors[i].analogPin;
+                if (pin >= 0 && pin < 32) {
+                    mutex_enter_blocking(&adcMutex);
+                    uint32_t rawADC = analogRead(pin);
+                    mutex_exit(&adcMutex);
+                    float voltage = (rawADC * 3.3) / 4095.0;
+                    
+                    // ioStatus.aIn belongs to core0 (updateIOpins); the sensor values reach
+                    // the web UI and Modbus through the snapshot
+                    configuredSensors[i].rawValue = voltage;
+                    float calibrated = applyCalibration(voltage, configuredSensors[i]);
+                    configuredSensors[i].calibratedValue = calibrated;
+                    configuredSensors[i].modbusValue = sensorModbusValue(configuredSensors[i], 0, calibrated);
+                    recordSensorRead(i, currentTime);
+                }
+            }
         }
     }
-    ezoSensorsInitialized = true;
 }
 
-// Handle LIS3DH sensor polling (separate from I2C queue to use Adafruit library)
-// Non-blocking, low-frequency polling to avoid interfering with web server
-void handleLIS3DHSensors() {
-    static unsigned long lastLIS3DHCheck = 0;
-    unsigned long currentTime = millis();
+// Copy the live values of one sensor into snapshot form
+void captureSensorValues(const SensorConfig& sensor, SensorValues& values) {
+    values.rawValue = sensor.rawValue;
+    values.rawValueB = sensor.rawValueB;
+    values.rawValueC = sensor.rawValueC;
+    values.calibratedValue = sensor.calibratedValue;
+    values.calibratedValueB = sensor.calibratedValueB;
+    values.calibratedValueC = sensor.calibratedValueC;
+    values.modbusValue = sensor.modbusValue;
+    values.modbusValueB = sensor.modbusValueB;
+    values.modbusValueC = sensor.modbusValueC;
+    memcpy(values.vibrationRegisters, sensor.vibrationRegisters, sizeof(values.vibrationRegisters));
+    values.lastReadTime = sensor.lastReadTime;
+    values.readCount = sensor.readCount;
+    values.measuredIntervalMs = sensor.measuredIntervalMs;
+    strncpy(values.rawDataString, sensor.rawDataString, sizeof(values.rawDataString) - 1);
+    strncpy(values.response, sensor.response, sizeof(values.response) - 1);
+}
+
+// Publish sensors whose values changed since the last pass (core1)
+void publishSensorSnapshots() {
+    for (int i = 0; i < MAX_SENSORS; i++) {
+        // memset() (not = {}) zeroes the padding too, so memcmp() only sees field changes
+        SensorValues current;
+        memset(&current, 0, sizeof(current));
+        captureSensorValues(configuredSensors[i], current);
+        // Core1 is the only writer, so it can compare against the published copy directly
+        if (memcmp(&current, &sensorSnapshots[i].values, sizeof(SensorValues)) != 0) {
+            sensorSnapshots[i].publish(current);
+            sensorRegistersDirty[i] = true;
+        }
+    }
+}
+
+// Consistent copy of a sensor's latest values (core0)
+void readSensorValues(int sensorIndex, SensorValues& values) {
+    sensorSnapshots[sensorIndex].read(values);
+}
+
+// Park core1 at the top of loop1() so core0 can reconfigure sensors or use a
+// sensor bus directly. Calls nest; core1 resumes when the outermost caller resumes.
+void pauseSensorCore() {
+    if (!core0setupComplete) return;  // Core1 has not started polling yet
+    if (sensorCorePauseDepth++ > 0) return;
+    sensorCorePauseRequested = true;
+    while (!sensorCorePaused) {
+        rp2040.wdt_reset();  // Core1 may be finishing a bus transaction (bounded by bus timeouts)
+    }
+}
+
+void resumeSensorCore() {
+    if (!core0setupComplete || sensorCorePauseDepth == 0) return;
+    if (--sensorCorePauseDepth > 0) return;
+    uartPortsStale = true;  // Parked sections may have reconfigured Serial1 or the sensor list
+    oneWireBusesStale = true;
+    sensorCorePauseRequested = false;
+    while (sensorCorePaused) {
+        // Wait for core1 to leave the parked state before the caller continues
+    }
+}
+
+void setup1() {
+    // Config and Wire init are done by setup() on core0; LIS3DH streams start lazily in loop1()
+    while (!core0setupComplete) {
+        delay(1);
+    }
+}
+
+void loop1() {
+    if (sensorCorePauseRequested) {
+        sensorCorePaused = true;
+        while (sensorCorePauseRequested) {
+            delayMicroseconds(50);
+        }
+        sensorCorePaused = false;
+        return;
+    }
+    
+    updateBusQueues();
+    updateAnalogSensors();
+    processEzoCycle();
+    processLIS3DHStreams();
+    publishSensorSnapshots();
+}
+
+// LIS3DH vibration engine. The accelerometer runs its 32-level FIFO in stream
+// mode; when INT1 signals the watermark (or the FIFO status poll sees samples
+// without an INT1 pin) the whole backlog is fetched in one auto-incrementing
+// burst. Samples are accumulated per axis and, once per updateInterval window,
+// reduced to mean (A/B/C values), RMS, peak and crest factor.
+struct LIS3DHOdrSetting {
+    uint16_t hz;
+    uint8_t odrBits;     // CTRL_REG1 ODR[3:0]
+    bool lowPower;       // 8-bit samples; required for 1620 Hz
+};
+
+const LIS3DHOdrSetting LIS3DH_ODRS[] = {
+    {1, 0x1, false}, {10, 0x2, false}, {25, 0x3, false}, {50, 0x4, false},
+    {100, 0x5, false}, {200, 0x6, false}, {400, 0x7, false}, {1344, 0x9, false},
+    {1620, 0x8, true}
+};
+
+struct LIS3DHStream {
+    bool started;
+    bool failed;              // Not answering; retried after the next reconfiguration
+    int attachedPin;          // INT1 GPIO with our handler attached (-1 = none)
+    volatile bool watermark;  // Set from the INT1 interrupt
+    float mgPerDigit;
+    uint8_t shift;            // Left-justified sample: 12-bit (HR) or 8-bit (low power)
+    uint32_t lastFifoCheckMs;
+    uint32_t windowStartMs;
+    uint32_t overruns;        // FIFO overflowed before it was drained
+    // Window accumulators in raw digits (exact integer sums)
+    uint32_t samples;
+    int32_t sum[3];
+    int64_t sumSquares[3];
+    int16_t minimum[3];
+    int16_t maximum[3];
+};
+
+LIS3DHStream lis3dhStreams[MAX_SENSORS];
+volatile bool lis3dhStreamsStale = true;  // Set by rebuildLIS3DHStreams(); handled on core1
+
+void lis3dhWatermarkHandler(void* param) {
+    ((LIS3DHStream*)param)->watermark = true;
+}
+
+bool lis3dhWriteRegister(uint8_t address, uint8_t reg, uint8_t value) {
+    Wire.beginTransmission(address);
+    Wire.write(reg);
+    Wire.write(value);
+    return Wire.endTransmission() == 0;
+}
+
+bool lis3dhReadRegisters(uint8_t address, uint8_t reg, uint8_t* data, size_t length) {
+    Wire.beginTransmission(address);
+    Wire.write(length > 1 ? (reg | 0x80) : reg);  // MSB set = auto-increment
+    if (Wire.endTransmission(false) != 0) return false;
+    if (Wire.requestFrom((int)address, length) != length) return false;
+    for (size_t i = 0; i < length; i++) {
+        data[i] = Wire.read();
+    }
+    return true;
+}
+
+void resetLIS3DHWindow(LIS3DHStream& stream, uint32_t now) {
+    stream.samples = 0;
+    for (int axis = 0; axis < 3; axis++) {
+        stream.sum[axis] = 0;
+        stream.sumSquares[axis] = 0;
+        stream.minimum[axis] = INT16_MAX;
+        stream.maximum[axis] = INT16_MIN;
+    }
+    stream.windowStartMs = now;
+}
+
+// Called on core0 with core1 parked; the interrupt handlers are re-attached from core1
+void rebuildLIS3DHStreams() {
+    lis3dhStreamsStale = true;
+}
+
+// Put the accelerometer in FIFO stream mode at the configured rate and range
+bool startLIS3DHStream(int sensorIndex, uint32_t now) {
+    SensorConfig& sensor = configuredSensors[sensorIndex];
+    LIS3DHStream& stream = lis3dhStreams[sensorIndex];
+    uint8_t address = sensor.i2cAddress;
+    
+    uint8_t whoAmI = 0;
+    if (!lis3dhReadRegisters(address, 0x0F, &whoAmI, 1) || whoAmI != 0x33) {
+        Serial.printf("[LIS3DH] %s: no device at 0x%02X (WHO_AM_I 0x%02X)\n", sensor.name, address, whoAmI);
+        return false;
+    }
+    
+    const LIS3DHOdrSetting* odr = &LIS3DH_ODRS[6];  // 400 Hz default
+    for (size_t i = 0; i < sizeof(LIS3DH_ODRS) / sizeof(LIS3DH_ODRS[0]); i++) {
+        if (LIS3DH_ODRS[i].hz == sensor.lis3dhOdr) odr = &LIS3DH_ODRS[i];
+    }
+    
+    uint8_t rangeBits;
+    switch (sensor.lis3dhRange) {
+        case 4:  rangeBits = 1; break;
+        case 8:  rangeBits = 2; break;
+        case 16: rangeBits = 3; break;
+        default: rangeBits = 0; break;  // ±2g
+    }
+    // Sensitivity per datasheet table 4: high-resolution (12-bit) or low-power (8-bit) mode
+    const float hrSensitivity[] = {1.0f, 2.0f, 4.0f, 12.0f};
+    const float lpSensitivity[] = {16.0f, 32.0f, 64.0f, 192.0f};
+    stream.mgPerDigit = odr->lowPower ? lpSensitivity[rangeBits] : hrSensitivity[rangeBits];
+    stream.shift = odr->lowPower ? 8 : 4;
+    
+    bool ok = lis3dhWriteRegister(address, 0x24, 0x80);  // CTRL_REG5: reboot memory content
+    delay(5);
+    ok = ok && lis3dhWriteRegister(address, 0x20, (odr->odrBits << 4) | (odr->lowPower ? 0x08 : 0x00) | 0x07);  // CTRL_REG1: ODR, LPen, XYZ
+    ok = ok && lis3dhWriteRegister(address, 0x23, 0x80 | (rangeBits << 4) | (odr->lowPower ? 0x00 : 0x08));    // CTRL_REG4: BDU, FS, HR
+    ok = ok && lis3dhWriteRegister(address, 0x24, 0x40);                                  // CTRL_REG5: FIFO_EN
+    ok = ok && lis3dhWriteRegister(address, 0x2E, 0x80 | LIS3DH_FIFO_WATERMARK);          // FIFO_CTRL_REG: stream mode + watermark
+    ok = ok && lis3dhWriteRegister(address, 0x22, sensor.lis3dhIntPin >= 0 ? 0x04 : 0x00); // CTRL_REG3: I1_WTM on INT1
+    if (!ok) {
+        Serial.printf("[LIS3DH] %s: configuration write failed\n", sensor.name);
+        return false;
+    }
+    
+    if (sensor.lis3dhIntPin >= 0) {
+        pinMode(sensor.lis3dhIntPin, INPUT);
+        attachInterruptParam(sensor.lis3dhIntPin, lis3dhWatermarkHandler, RISING, &stream);
+        stream.attachedPin = sensor.lis3dhIntPin;
+    }
+    
+    stream.started = true;
+    stream.watermark = true;  // Drain whatever is already queued (INT1 may already be high)
+    stream.overruns = 0;
+    resetLIS3DHWindow(stream, now);
+    Serial.printf("[LIS3DH] %s: FIFO stream at %d Hz, ±%dg, %s\n", sensor.name, odr->hz, 2 << rangeBits,
+                  sensor.lis3dhIntPin >= 0 ? "INT1 watermark" : "polled");
+    return true;
+}
+
+// Read every sample queued in the FIFO in one burst and fold it into the window
+void drainLIS3DHFifo(int sensorIndex) {
+    SensorConfig& sensor = configuredSensors[sensorIndex];
+    LIS3DHStream& stream = lis3dhStreams[sensorIndex];
+    
+    uint8_t fifoSource;
+    if (!lis3dhReadRegisters(sensor.i2cAddress, 0x2F, &fifoSource, 1)) return;  // FIFO_SRC_REG
+    
+    bool overrun = fifoSource & 0x40;
+    uint8_t count = overrun ? 32 : (fifoSource & 0x1F);
+    if (overrun) stream.overruns++;
+    if (count == 0) return;
+    
+    // OUT_X_L..OUT_Z_H roll over to OUT_X_L in FIFO mode, so one read returns `count` samples
+    uint8_t data[32 * 6];
+    Wire.setClock(I2C_BURST_CLOCK_HZ);
+    bool ok = lis3dhReadRegisters(sensor.i2cAddress, 0x28, data, count * 6);
+    Wire.setClock(I2C_BUS_CLOCK_HZ);
+    if (!ok) {
+        logI2CTransaction(sensor.i2cAddress, "ERR", "LIS3DH FIFO burst read failed", String(sensor.name));
+        return;
+    }
+    
+    for (uint8_t sample = 0; sample < count; sample++) {
+        for (int axis = 0; axis < 3; axis++) {
+            int16_t value = (int16_t)(data[sample * 6 + axis * 2] | (data[sample * 6 + axis * 2 + 1] << 8)) >> stream.shift;
+            stream.sum[axis] += value;
+            stream.sumSquares[axis] += (int32_t)value * value;
+            if (value < stream.minimum[axis]) stream.minimum[axis] = value;
+            if (value > stream.maximum[axis]) stream.maximum[axis] = value;
+        }
+    }
+    stream.samples += count;
+}
+
+int16_t clampToRegister(float value) {
+    if (value > 32767.0f) return 32767;
+    if (value < -32768.0f) return -32768;
+    return (int16_t)lroundf(value);
+}
+
+// Reduce the window to features and publish them
+void publishLIS3DHWindow(int sensorIndex, uint32_t now) {
+    SensorConfig& sensor = configuredSensors[sensorIndex];
+    LIS3DHStream& stream = lis3dhStreams[sensorIndex];
+    
+    float mean[3];
+    for (int axis = 0; axis < 3; axis++) {
+        double n = stream.samples;
+        double meanDigits = stream.sum[axis] / n;
+        // RMS about the window mean, so gravity and static tilt do not count as vibration
+        double variance = stream.sumSquares[axis] / n - meanDigits * meanDigits;
+        float rms = sqrt(variance > 0 ? variance : 0) * stream.mgPerDigit;
+        float peak = max(stream.maximum[axis] - meanDigits, meanDigits - stream.minimum[axis]) * stream.mgPerDigit;
+        float crest = rms > 0.0f ? peak / rms : 0.0f;
+        mean[axis] = meanDigits * stream.mgPerDigit;
+        
+        sensor.vibrationRegisters[axis] = clampToRegister(rms);
+        sensor.vibrationRegisters[3 + axis] = clampToRegister(peak);
+        sensor.vibrationRegisters[6 + axis] = clampToRegister(crest * 100);
+    }
+    
+    sensor.rawValue = mean[0];
+    sensor.rawValueB = mean[1];
+    sensor.rawValueC = mean[2];
+    sensor.calibratedValue = applyCalibration(mean[0], sensor);
+    sensor.calibratedValueB = applyCalibrationB(mean[1], sensor);
+    sensor.calibratedValueC = applyCalibrationC(mean[2], sensor);
+    sensor.modbusValue = sensorModbusValue(sensor, 0, sensor.calibratedValue);
+    sensor.modbusValueB = sensorModbusValue(sensor, 1, sensor.calibratedValueB);
+    sensor.modbusValueC = sensorModbusValue(sensor, 2, sensor.calibratedValueC);
+    recordSensorRead(sensorIndex, now);
+    
+    char summary[96];
+    snprintf(summary, sizeof(summary), "%lu samples, RMS X/Y/Z: %d/%d/%d mg, overruns: %lu",
+             (unsigned long)stream.samples, sensor.vibrationRegisters[0], sensor.vibrationRegisters[1],
+             sensor.vibrationRegisters[2], (unsigned long)stream.overruns);
+    logI2CTransaction(sensor.i2cAddress, "VAL", summary, String(sensor.name));
+    resetLIS3DHWindow(stream, now);
+}
+
+void processLIS3DHStreams() {
+    uint32_t now = millis();
     
-    // Poll at very low frequency - only every 5 seconds max to avoid I2C contention
-    if (currentTime - lastLIS3DHCheck < 5000) return;
-    lastLIS3DHCheck = currentTime;
+    if (lis3dhStreamsStale) {
+        for (int i = 0; i < MAX_SENSORS; i++) {
+            if (lis3dhStreams[i].started && lis3dhStreams[i].attachedPin >= 0) detachInterrupt(lis3dhStreams[i].attachedPin);
+            lis3dhStreams[i] = LIS3DHStream();
+            lis3dhStreams[i].attachedPin = -1;
+        }
+        lis3dhStreamsStale = false;
+    }
     
-    // Poll each enabled LIS3DH sensor
     for (int i = 0; i < numConfiguredSensors; i++) {
-        if (!configuredSensors[i].enabled) continue;
-        if (strcmp(configuredSensors[i].type, "LIS3DH") != 0) continue;
+        SensorConfig& sensor = configuredSensors[i];
+        if (!sensor.enabled || strcmp(sensor.type, "LIS3DH") != 0) continue;
+        LIS3DHStream& stream = lis3dhStreams[i];
         
-        // Check if it's time for next reading based on updateInterval
-        if (currentTime - configuredSensors[i].lastReadTime < configuredSensors[i].updateInterval) {
+        if (!stream.started) {
+            if (stream.failed) continue;
+            stream.failed = !startLIS3DHStream(i, now);
             continue;
         }
         
-        // Initialize Adafruit_LIS3DH if not already done for this sensor
-        if (lis3dhSensors[i] == nullptr) {
-            lis3dhSensors[i] = new Adafruit_LIS3DH();
-            
-            // Non-blocking initialization check
-            noInterrupts();  // Briefly disable interrupts for I2C
-            bool initOk = lis3dhSensors[i]->begin(configuredSensors[i].i2cAddress);
-            interrupts();
-            
-            if (!initOk) {
-                Serial.printf("[LIS3DH] Failed to init sensor %d (%s) at 0x%02X\n", 
-                             i, configuredSensors[i].name, configuredSensors[i].i2cAddress);
-                delete lis3dhSensors[i];
-                lis3dhSensors[i] = nullptr;
-                continue;
-            }
-            Serial.printf("[LIS3DH] Initialized sensor %d (%s) at 0x%02X\n", 
-                         i, configuredSensors[i].name, configuredSensors[i].i2cAddress);
+        // The watermark interrupt is edge-triggered; polling also catches an edge missed while draining
+        uint32_t pollInterval = sensor.lis3dhIntPin >= 0 ? LIS3DH_FIFO_POLL_MS * 10 : LIS3DH_FIFO_POLL_MS;
+        if (stream.watermark || now - stream.lastFifoCheckMs >= pollInterval) {
+            stream.watermark = false;
+            stream.lastFifoCheckMs = now;
+            drainLIS3DHFifo(i);
         }
         
-        if (lis3dhSensors[i] == nullptr) continue;
-        
-        // Read accelerometer data - brief I2C transaction
-        noInterrupts();  // Disable interrupts during I2C read to prevent contention
-        lis3dhSensors[i]->read();
-        float x_mg = lis3dhSensors[i]->x;
-        float y_mg = lis3dhSensors[i]->y;
-        float z_mg = lis3dhSensors[i]->z;
-        interrupts();  // Re-enable interrupts
-        
-        // Store raw values (in milligravity)
-        configuredSensors[i].rawValue = x_mg;
-        configuredSensors[i].rawValueB = y_mg;
-        configuredSensors[i].rawValueC = z_mg;
-        
-        // Apply calibration to all three axes
-        float calibratedX = applyCalibration(x_mg, configuredSensors[i]);
-        float calibratedY = applyCalibrationB(y_mg, configuredSensors[i]);
-        float calibratedZ = applyCalibrationC(z_mg, configuredSensors[i]);
-        
-        configuredSensors[i].calibratedValue = calibratedX;
-        configuredSensors[i].calibratedValueB = calibratedY;
-        configuredSensors[i].calibratedValueC = calibratedZ;
-        
-        // Convert to Modbus values (scaled by 100 for decimal precision)
-        configuredSensors[i].modbusValue = (int)(calibratedX * 100);
-        configuredSensors[i].modbusValueB = (int)(calibratedY * 100);
-        configuredSensors[i].modbusValueC = (int)(calibratedZ * 100);
-        
-        // Update timestamp
-        configuredSensors[i].lastReadTime = currentTime;
+        uint32_t window = sensor.updateInterval > 0 ? sensor.updateInterval : 1000;
+        if (now - stream.windowStartMs >= window && stream.samples > 0) {
+            publishLIS3DHWindow(i, now);
+        }
     }
 }
 
+// Atlas Scientific EZO engine. Every enabled probe gets its read command in one
+// burst, then each is collected as soon as its status byte stops reporting 254
+// (still processing), so a full refresh costs one conversion window regardless
+// of probe count. pH/EC probes read with "RT,<temp>", compensated by the latest
+// RTD reading.
+enum class EzoKind : uint8_t {
+    OTHER,
+    PH,
+    EC,
+    DO,
+    RTD
+};
 
-void handleEzoSensors() {
-    static bool initialized = false;
-    
-    if (!initialized) {
-        initializeEzoSensors();
-        initialized = true;
+struct EzoProbe {
+    uint8_t sensorIndex;
+    EzoKind kind;
+    uint32_t nextPollMs;  // When to read the status byte next
+};
+
+EzoProbe ezoProbes[MAX_SENSORS];
+uint8_t ezoProbeCount = 0;
+uint8_t ezoPendingCount = 0;        // Probes that have not answered this cycle
+uint32_t ezoCycleIntervalMs = 5000;
+uint32_t ezoNextCycleMs = 0;
+float ezoCompensationTemp = NAN;    // Latest RTD reading in °C (NAN until one arrives)
+
+bool isEzoType(const char* type) {
+    return strncmp(type, "EZO-", 4) == 0 || strncmp(type, "EZO_", 4) == 0;
+}
+
+EzoKind ezoKindForType(const char* type) {
+    const char* suffix = type + 4;
+    if (strcasecmp(suffix, "PH") == 0) return EzoKind::PH;
+    if (strcasecmp(suffix, "EC") == 0) return EzoKind::EC;
+    if (strcasecmp(suffix, "DO") == 0) return EzoKind::DO;
+    if (strcasecmp(suffix, "RTD") == 0) return EzoKind::RTD;
+    return EzoKind::OTHER;
+}
+
+// Typical single-reading processing time from the EZO datasheets
+uint32_t ezoReadTime(EzoKind kind) {
+    switch (kind) {
+        case EzoKind::EC:
+        case EzoKind::DO:
+        case EzoKind::RTD:
+            return 600;
+        default:
+            return 900;
     }
+}
+
+// Collect the EZO probes from configuredSensors. One cycle runs at the shortest
+// updateInterval among them.
+void rebuildEzoCycle() {
+    ezoProbeCount = 0;
+    ezoPendingCount = 0;
+    uint32_t interval = 0;
     
     for (int i = 0; i < numConfiguredSensors; i++) {
-        if (!configuredSensors[i].enabled || strncmp(configuredSensors[i].type, "EZO-", 4) != 0) {
-            continue;
+        SensorConfig& sensor = configuredSensors[i];
+        if (!sensor.enabled || !isEzoType(sensor.type) || sensorBusForProtocol(sensor.protocol) != SensorBus::I2C) continue;
+        
+        ezoProbes[ezoProbeCount++] = {(uint8_t)i, ezoKindForType(sensor.type), 0};
+        sensor.cmdPending = false;
+        sensor.lastCmdSent = 0;
+        if (sensor.updateInterval > 0 && (interval == 0 || (uint32_t)sensor.updateInterval < interval)) {
+            interval = sensor.updateInterval;
         }
+    }
+    
+    ezoCycleIntervalMs = interval > 0 ? interval : 5000;
+    ezoNextCycleMs = millis();
+}
+
+// Send the read command to every probe back to back
+void startEzoCycle(uint32_t now) {
+    ezoNextCycleMs += ezoCycleIntervalMs;
+    if (SensorScheduler::dueBefore(ezoNextCycleMs, now)) {
+        ezoNextCycleMs = now + ezoCycleIntervalMs;  // Skip cycles missed while core1 was parked
+    }
+    
+    for (uint8_t p = 0; p < ezoProbeCount; p++) {
+        EzoProbe& probe = ezoProbes[p];
+        SensorConfig& sensor = configuredSensors[probe.sensorIndex];
         
-        if (ezoSensors[i] == nullptr) {
-            continue;
+        char command[16];
+        if ((probe.kind == EzoKind::PH || probe.kind == EzoKind::EC) && !isnan(ezoCompensationTemp)) {
+            snprintf(command, sizeof(command), "RT,%.2f", ezoCompensationTemp);
+        } else {
+            strcpy(command, "R");
         }
         
-        unsigned long currentTime = millis();
+        Wire.beginTransmission(sensor.i2cAddress);
+        Wire.write((const uint8_t*)command, strlen(command));
+        int result = Wire.endTransmission();
         
-        // Check if we should log for terminal watch
-        bool shouldLog = terminalWatchActive && 
-                        (watchedProtocol.equalsIgnoreCase("I2C") || watchedProtocol.equalsIgnoreCase("EZO")) &&
-                        (watchedPin == "all" || watchedPin == String(configuredSensors[i].i2cAddress, HEX) || 
-                         watchedPin == String(configuredSensors[i].name));
+        if (result == 0) {
+            logI2CTransaction(sensor.i2cAddress, "TX", "CMD: \"" + String(command) + "\" (EZO)", String(sensor.name));
+            sensor.cmdPending = true;
+            sensor.lastCmdSent = now;
+            probe.nextPollMs = now + ezoReadTime(probe.kind);
+            ezoPendingCount++;
+        } else {
+            logI2CTransaction(sensor.i2cAddress, "NACK", "Error code: " + String(result), String(sensor.name));
+        }
+    }
+}
+
+// Read one probe's status byte and, once it is done processing, its reading
+void collectEzoProbe(EzoProbe& probe, uint32_t now) {
+    SensorConfig& sensor = configuredSensors[probe.sensorIndex];
+    
+    Wire.requestFrom((int)sensor.i2cAddress, 32);
+    int statusCode = Wire.available() ? Wire.read() : -1;
+    
+    if (statusCode == 254) {
+        if (now - sensor.lastCmdSent < EZO_RESPONSE_TIMEOUT_MS) {
+            probe.nextPollMs = now + EZO_POLL_INTERVAL_MS;
+            while (Wire.available()) Wire.read();
+            return;
+        }
+        sensor.rawValue = -996.0;
+        logI2CTransaction(sensor.i2cAddress, "ERR", "EZO: Processing timeout", String(sensor.name));
+    } else if (statusCode == 1) {
+        // ASCII reading, NUL terminated; multi-parameter probes separate fields with commas
+        char data[32];
+        int length = 0;
+        while (Wire.available()) {
+            char c = (char)Wire.read();
+            if (c == '\0') break;
+            if (c >= 32 && c <= 126 && length < (int)sizeof(data) - 1) data[length++] = c;
+        }
+        data[length] = '\0';
+        while (Wire.available()) Wire.read();
         
-        if (configuredSensors[i].cmdPending && (currentTime - configuredSensors[i].lastCmdSent > 1000)) {
-            ezoSensors[i]->receive_read_cmd();
-            
-            if (ezoSensors[i]->get_error() == Ezo_board::SUCCESS) {
-                float reading = ezoSensors[i]->get_last_received_reading();
-                snprintf(configuredSensors[i].response, sizeof(configuredSensors[i].response), "%.2f", reading);
-                Serial.printf("EZO sensor %s reading: %s\n", configuredSensors[i].name, configuredSensors[i].response);
-                
-                // Log for terminal watch
-                if (shouldLog) {
-                    logI2CTransaction(configuredSensors[i].i2cAddress, "RX", 
-                                    String(reading), String(configuredSensors[i].i2cAddress, HEX));
-                }
-            } else {
-                Serial.printf("EZO sensor %s error: %d\n", configuredSensors[i].name, ezoSensors[i]->get_error());
-                
-                // Log error for terminal watch
-                if (shouldLog) {
-                    logI2CTransaction(configuredSensors[i].i2cAddress, "ERR", 
-                                    "Error: " + String(ezoSensors[i]->get_error()), 
-                                    String(configuredSensors[i].i2cAddress, HEX));
-                }
-            }
+        if (length > 0) {
+            float reading = atof(data);
+            float calibratedValue = applyCalibration(reading, sensor);
+            sensor.rawValue = reading;
+            sensor.calibratedValue = calibratedValue;
+            sensor.modbusValue = sensorModbusValue(sensor, 0, calibratedValue);
+            strncpy(sensor.response, data, sizeof(sensor.response) - 1);
+            sensor.response[sizeof(sensor.response) - 1] = '\0';
+            recordSensorRead(probe.sensorIndex, now);
             
-            configuredSensors[i].cmdPending = false;
-        } 
-        else if (!configuredSensors[i].cmdPending && (currentTime - configuredSensors[i].lastCmdSent > 5000)) {
-            // Log command being sent for terminal watch
-            if (shouldLog) {
-                logI2CTransaction(configuredSensors[i].i2cAddress, "TX", 
-                                "READ", String(configuredSensors[i].i2cAddress, HEX));
+            // EZO-RTD reports -1023 with no probe attached
+            if (probe.kind == EzoKind::RTD && reading > -126.0f) {
+                ezoCompensationTemp = calibratedValue;
             }
-            
-            ezoSensors[i]->send_read_cmd();
-            configuredSensors[i].lastCmdSent = currentTime;
-            configuredSensors[i].cmdPending = true;
-            Serial.printf("Sent read command to EZO sensor %s\n", configuredSensors[i].name);
-        }
+            logI2CTransaction(sensor.i2cAddress, "VAL", "EZO Success: '" + String(data) + "', Calibrated: " + String(calibratedValue), String(sensor.name));
+        } else {
+            sensor.rawValue = -998.0;
+            logI2CTransaction(sensor.i2cAddress, "ERR", "EZO: Empty data after success code", String(sensor.name));
+        }
+    } else if (statusCode == 2) {
+        sensor.rawValue = -997.0;
+        logI2CTransaction(sensor.i2cAddress, "ERR", "EZO: Syntax error", String(sensor.name));
+    } else if (statusCode == 255) {
+        sensor.rawValue = -995.0;
+        logI2CTransaction(sensor.i2cAddress, "WARN", "EZO: No data available", String(sensor.name));
+    } else if (statusCode < 0) {
+        sensor.rawValue = -993.0;
+        logI2CTransaction(sensor.i2cAddress, "ERR", "EZO: No response data", String(sensor.name));
+    } else {
+        sensor.rawValue = -994.0;
+        logI2CTransaction(sensor.i2cAddress, "ERR", "EZO: Unknown status " + String(statusCode), String(sensor.name));
+    }
+    
+    while (Wire.available()) Wire.read();
+    sensor.cmdPending = false;
+    ezoPendingCount--;
+}
+
+void processEzoCycle() {
+    if (ezoProbeCount == 0) return;
+    uint32_t now = millis();
+    
+    if (ezoPendingCount == 0) {
+        if (!SensorScheduler::dueBefore(now, ezoNextCycleMs)) startEzoCycle(now);
+        return;
+    }
+    
+    // One probe per pass so the other buses keep their turn
+    for (uint8_t p = 0; p < ezoProbeCount; p++) {
+        EzoProbe& probe = ezoProbes[p];
+        if (!configuredSensors[probe.sensorIndex].cmdPending) continue;
+        if (SensorScheduler::dueBefore(now, probe.nextPollMs)) continue;
+        collectEzoProbe(probe, now);
+        return;
     }
 }
 
@@ -3079,7 +3767,7 @@ void loadConfig() {
     }
     
     // Parse JSON from file
-    StaticJsonDocument<1024> doc;
+    StaticJsonDocument<2048> doc;
     DeserializationError err = deserializeJson(doc, file);
     file.close();
     
@@ -3164,6 +3852,35 @@ void loadConfig() {
         }
     }
     
+    // Load packed sensor register block
+    config.modbusPackedEnabled = doc["modbusPackedEnabled"] | false;
+    config.modbusPackedBase = doc["modbusPackedBase"] | MODBUS_PACKED_DEFAULT_BASE;
+    if (config.modbusPackedBase > MODBUS_PACKED_MAX_BASE) config.modbusPackedBase = MODBUS_PACKED_DEFAULT_BASE;
+    
+    // Load Modbus connection pool
+    config.modbusMaxClients = constrain(doc["modbusMaxClients"] | MODBUS_DEFAULT_CLIENTS, 1, MAX_MODBUS_CLIENTS);
+    config.modbusIdleTimeout = doc["modbusIdleTimeout"] | MODBUS_DEFAULT_IDLE_TIMEOUT;
+    
+    // Load Modbus RTU server
+    config.modbusRtuEnabled = doc["modbusRtuEnabled"] | false;
+    config.modbusRtuUnitId = doc["modbusRtuUnitId"] | MODBUS_RTU_DEFAULT_UNIT_ID;
+    config.modbusRtuBaud = doc["modbusRtuBaud"] | MODBUS_RTU_DEFAULT_BAUD;
+    strncpy(config.modbusRtuFraming, doc["modbusRtuFraming"] | MODBUS_RTU_DEFAULT_FRAMING, sizeof(config.modbusRtuFraming) - 1);
+    config.modbusRtuFraming[sizeof(config.modbusRtuFraming) - 1] = '\0';
+    config.modbusRtuTxPin = doc["modbusRtuTxPin"] | MODBUS_RTU_DEFAULT_TX_PIN;
+    config.modbusRtuRxPin = doc["modbusRtuRxPin"] | MODBUS_RTU_DEFAULT_RX_PIN;
+    config.modbusRtuDePin = doc["modbusRtuDePin"] | MODBUS_RTU_DEFAULT_DE_PIN;
+    config.modbusRtuGateway = doc["modbusRtuGateway"] | false;
+    if (!modbusRTUPinsUsable(config.modbusRtuTxPin, config.modbusRtuRxPin, config.modbusRtuDePin)) {
+        // e.g. the former GP24/25 default, which are not on the Pico header
+        config.modbusRtuTxPin = MODBUS_RTU_DEFAULT_TX_PIN;
+        config.modbusRtuRxPin = MODBUS_RTU_DEFAULT_RX_PIN;
+        config.modbusRtuDePin = MODBUS_RTU_DEFAULT_DE_PIN;
+    }
+    
+    // Load /events coalescing interval
+    config.eventInterval = constrain(doc["eventInterval"] | HTTP_EVENT_DEFAULT_INTERVAL_MS, HTTP_EVENT_MIN_INTERVAL_MS, HTTP_EVENT_MAX_INTERVAL_MS);
+    
     Serial.println("Network configuration loaded successfully");
     Serial.print("  DHCP: "); Serial.println(config.dhcpEnabled ? "enabled" : "disabled");
     Serial.print("  IP: "); Serial.print(config.ip[0]); Serial.print("."); Serial.print(config.ip[1]); Serial.print("."); Serial.print(config.ip[2]); Serial.print("."); Serial.println(config.ip[3]);
@@ -3174,7 +3891,7 @@ void saveConfig() {
     Serial.println("Saving network configuration to LittleFS...");
     
     // Create JSON document
-    StaticJsonDocument<1024> doc;
+    StaticJsonDocument<2048> doc;
     
     doc["version"] = config.version;
     doc["dhcpEnabled"] = config.dhcpEnabled;
@@ -3225,6 +3942,20 @@ void saveConfig() {
         doInitialArray.add(config.doInitialState[i]);
     }
     
+    doc["modbusPackedEnabled"] = config.modbusPackedEnabled;
+    doc["modbusPackedBase"] = config.modbusPackedBase;
+    doc["modbusMaxClients"] = config.modbusMaxClients;
+    doc["modbusIdleTimeout"] = config.modbusIdleTimeout;
+    doc["modbusRtuEnabled"] = config.modbusRtuEnabled;
+    doc["modbusRtuUnitId"] = config.modbusRtuUnitId;
+    doc["modbusRtuBaud"] = config.modbusRtuBaud;
+    doc["modbusRtuFraming"] = config.modbusRtuFraming;
+    doc["modbusRtuTxPin"] = config.modbusRtuTxPin;
+    doc["modbusRtuRxPin"] = config.modbusRtuRxPin;
+    doc["modbusRtuDePin"] = config.modbusRtuDePin;
+    doc["modbusRtuGateway"] = config.modbusRtuGateway;
+    doc["eventInterval"] = config.eventInterval;
+    
     // Write to file
     File file = LittleFS.open(CONFIG_FILE, "w");
     if (!file) {
@@ -3308,6 +4039,7 @@ void loadSensorConfig() {
 
         cfg.i2cAddress = sensor["i2cAddress"] | 0;
         cfg.modbusRegister = sensor["modbusRegister"] | 0;
+        readModbusEncoding(sensor, cfg);
 
         // command may be string or object
         const char* command = "";
@@ -3331,8 +4063,12 @@ void loadSensorConfig() {
         cfg.dataPin = sensor["dataPin"] | -1;
         cfg.uartTxPin = sensor["uartTxPin"] | -1;
         cfg.uartRxPin = sensor["uartRxPin"] | -1;
+        cfg.uartBaud = readUartBaud(sensor);
+        strncpy(cfg.uartFraming, sensor["uartFraming"] | "8N1", sizeof(cfg.uartFraming)-1);
+        cfg.uartFraming[sizeof(cfg.uartFraming)-1] = '\0';
         cfg.analogPin = sensor["analogPin"] | -1;
         cfg.oneWirePin = sensor["oneWirePin"] | -1;
+        normalizeOneWireRom(sensor["oneWireRom"] | "", cfg.oneWireRom);
         cfg.digitalPin = sensor["digitalPin"] | -1;
 
         const char* owCommand = sensor["oneWireCommand"] | "0x44";
@@ -3340,7 +4076,12 @@ void loadSensorConfig() {
         cfg.oneWireCommand[sizeof(cfg.oneWireCommand)-1] = '\0';
         cfg.oneWireInterval = sensor["oneWireInterval"] | 5;
         cfg.oneWireConversionTime = sensor["oneWireConversionTime"] | 750;
+        cfg.oneWireResolution = constrain((int)(sensor["oneWireResolution"] | 12), 9, 12);
         cfg.oneWireAutoMode = sensor["oneWireAutoMode"] | true;
+        
+        cfg.lis3dhOdr = sensor["lis3dhOdr"] | 400;
+        cfg.lis3dhRange = sensor["lis3dhRange"] | 2;
+        cfg.lis3dhIntPin = sensor["lis3dhIntPin"] | -1;
 
         // Calibration nested or flat
         if (sensor.containsKey("calibration") && sensor["calibration"].is<JsonObject>()) {
@@ -3430,6 +4171,7 @@ void saveSensorConfig() {
         sensor["protocol"] = configuredSensors[i].protocol;
         sensor["i2cAddress"] = configuredSensors[i].i2cAddress;
         sensor["modbusRegister"] = configuredSensors[i].modbusRegister;
+        writeModbusEncoding(sensor, configuredSensors[i]);
         sensor["command"] = configuredSensors[i].command;
         sensor["updateInterval"] = configuredSensors[i].updateInterval;
         sensor["delayBeforeRead"] = configuredSensors[i].delayBeforeRead;
@@ -3440,16 +4182,25 @@ void saveSensorConfig() {
         sensor["dataPin"] = configuredSensors[i].dataPin;
         sensor["uartTxPin"] = configuredSensors[i].uartTxPin;
         sensor["uartRxPin"] = configuredSensors[i].uartRxPin;
+        sensor["uartBaud"] = configuredSensors[i].uartBaud;
+        sensor["uartFraming"] = configuredSensors[i].uartFraming;
         sensor["analogPin"] = configuredSensors[i].analogPin;
         sensor["oneWirePin"] = configuredSensors[i].oneWirePin;
+        sensor["oneWireRom"] = configuredSensors[i].oneWireRom;
         sensor["digitalPin"] = configuredSensors[i].digitalPin;
         
         // One-Wire specific configuration
         sensor["oneWireCommand"] = configuredSensors[i].oneWireCommand;
         sensor["oneWireInterval"] = configuredSensors[i].oneWireInterval;
         sensor["oneWireConversionTime"] = configuredSensors[i].oneWireConversionTime;
+        sensor["oneWireResolution"] = configuredSensors[i].oneWireResolution;
         sensor["oneWireAutoMode"] = configuredSensors[i].oneWireAutoMode;
         
+        // LIS3DH FIFO streaming configuration
+        sensor["lis3dhOdr"] = configuredSensors[i].lis3dhOdr;
+        sensor["lis3dhRange"] = configuredSensors[i].lis3dhRange;
+        sensor["lis3dhIntPin"] = configuredSensors[i].lis3dhIntPin;
+        
         // Calibration data
         sensor["calibrationOffset"] = configuredSensors[i].calibrationOffset;
         sensor["calibrationSlope"] = configuredSensors[i].calibrationSlope;
@@ -3497,12 +4248,134 @@ void saveSensorConfig() {
     applySensorPresets();
 }
 
+// Parse and validate a gateway poll list (GATEWAY_FILE or POST body); returns
+// an error message, or NULL with cfg filled in
+const char* parseGatewayConfig(JsonObject root, GatewayConfig& cfg) {
+    cfg.responseTimeoutMs = constrain(root["responseTimeoutMs"] | MODBUS_GATEWAY_DEFAULT_TIMEOUT_MS, 10, 5000);
+    cfg.pollCount = 0;
+    JsonArray polls = root["polls"];
+    if (polls.size() > MODBUS_GATEWAY_MAX_POLLS) return "At most 16 gateway polls are supported";
+    
+    for (JsonObject entry : polls) {
+        int unitId = entry["unitId"] | 0;
+        int function = entry["function"] | 0;
+        long remoteAddress = entry["remoteAddress"] | -1L;
+        int count = entry["count"] | 0;
+        long localAddress = entry["localAddress"] | -1L;
+        long intervalMs = entry["intervalMs"] | 1000L;
+        int maxCount = function <= MODBUS_FC_READ_DISCRETE_INPUTS ? MODBUS_MAX_READ_BITS : MODBUS_MAX_READ_REGISTERS;
+        
+        if (unitId < 1 || unitId > 247) return "Gateway unit ID must be between 1 and 247";
+        if (function < MODBUS_FC_READ_COILS || function > MODBUS_FC_READ_INPUT_REGISTERS) return "Gateway function must be 1, 2, 3 or 4";
+        if (count < 1 || count > maxCount) return "Gateway count must be 1-2000 (FC01/FC02) or 1-125 (FC03/FC04)";
+        if (remoteAddress < 0 || remoteAddress + count > 65536) return "Gateway remote range must lie within 0-65535";
+        if (localAddress < MODBUS_GATEWAY_BASE || localAddress + count > MODBUS_GATEWAY_END) return "Gateway local range must lie within 1000-3999";
+        if (intervalMs < MODBUS_GATEWAY_MIN_INTERVAL_MS) return "Gateway interval must be at least 20 ms";
+        for (int i = 0; i < cfg.pollCount; i++) {
+            const GatewayPoll& other = cfg.polls[i];
+            if (other.function == function && localAddress < other.localAddress + other.count &&
+                other.localAddress < localAddress + count) {
+                return "Gateway local ranges of the same function overlap";
+            }
+        }
+        
+        GatewayPoll& poll = cfg.polls[cfg.pollCount++];
+        poll.unitId = unitId;
+        poll.function = function;
+        poll.remoteAddress = remoteAddress;
+        poll.count = count;
+        poll.localAddress = localAddress;
+        poll.intervalMs = intervalMs;
+    }
+    return NULL;
+}
+
+void loadGatewayConfig() {
+    gatewayConfig.responseTimeoutMs = MODBUS_GATEWAY_DEFAULT_TIMEOUT_MS;
+    gatewayConfig.pollCount = 0;
+    
+    if (!LittleFS.exists(GATEWAY_FILE)) {
+        return;
+    }
+    File file = LittleFS.open(GATEWAY_FILE, "r");
+    if (!file) {
+        return;
+    }
+    
+    StaticJsonDocument<4096> doc;
+    DeserializationError err = deserializeJson(doc, file);
+    file.close();
+    if (err) {
+        Serial.printf("Gateway JSON parse error: %s\n", err.c_str());
+        return;
+    }
+    
+    GatewayConfig loaded;
+    const char* error = parseGatewayConfig(doc.as<JsonObject>(), loaded);
+    if (error) {
+        Serial.printf("Gateway configuration ignored: %s\n", error);
+        return;
+    }
+    gatewayConfig = loaded;
+    Serial.printf("Gateway: %d polls configured\n", gatewayConfig.pollCount);
+}
+
+void saveGatewayConfig() {
+    StaticJsonDocument<4096> doc;
+    doc["responseTimeoutMs"] = gatewayConfig.responseTimeoutMs;
+    JsonArray polls = doc.createNestedArray("polls");
+    for (int i = 0; i < gatewayConfig.pollCount; i++) {
+        const GatewayPoll& poll = gatewayConfig.polls[i];
+        JsonObject entry = polls.createNestedObject();
+        entry["unitId"] = poll.unitId;
+        entry["function"] = poll.function;
+        entry["remoteAddress"] = poll.remoteAddress;
+        entry["count"] = poll.count;
+        entry["localAddress"] = poll.localAddress;
+        entry["intervalMs"] = poll.intervalMs;
+    }
+    
+    File file = LittleFS.open(GATEWAY_FILE, "w");
+    if (!file) {
+        Serial.println("Failed to open gateway file for writing");
+        return;
+    }
+    if (serializeJson(doc, file) == 0) {
+        Serial.println("Failed to write gateway JSON");
+    } else {
+        Serial.println("Gateway configuration saved successfully");
+    }
+    file.close();
+}
+
+// Rebuild the per-channel bit masks from config.diInvert/diLatch/doInvert
+void rebuildIOMasks() {
+    ioMasks = {};
+    for (int i = 0; i < 8; i++) {
+        if (config.diInvert[i]) ioMasks.diInvert |= 1 << i;
+        if (config.diLatch[i]) ioMasks.diLatch |= 1 << i;
+        if (config.doInvert[i]) ioMasks.doInvert |= 1 << i;
+    }
+}
+
+// Drive all outputs from a logical bit mask with one masked SIO write (doInvert applied)
+void writeDigitalOutputs(uint8_t logicalStates) {
+    uint32_t physical = (uint32_t)(uint8_t)(logicalStates ^ ioMasks.doInvert) << DIGITAL_OUTPUT_SHIFT;
+    gpio_put_masked(DIGITAL_OUTPUT_PIN_MASK, physical);
+}
+
+// Set a single output's logical state and pin, leaving the other outputs untouched
+void setDigitalOutput(int index, bool state) {
+    setIoBit(ioStatus.dOut, index, state);
+    uint32_t pinBit = 1u << (DIGITAL_OUTPUT_SHIFT + index);
+    if (state != ioBit(ioMasks.doInvert, index)) gpio_set_mask(pinBit);
+    else gpio_clr_mask(pinBit);
+}
+
 // Reset all latched inputs
 void resetLatches() {
     Serial.println("Resetting all latched inputs");
-    for (int i = 0; i < 8; i++) {
-        ioStatus.dInLatched[i] = false;
-    }
+    ioStatus.dInLatched = 0;
 }
 
 // ...existing code...
@@ -3511,16 +4384,15 @@ void setPinModes() {
     for (int i = 0; i < sizeof(DIGITAL_INPUTS)/sizeof(DIGITAL_INPUTS[0]); i++) {
         pinMode(DIGITAL_INPUTS[i], config.diPullup[i] ? INPUT_PULLUP : INPUT);
     }
+    rebuildIOMasks();
+
+    // Set the digital outputs to their initial state from config (inversion applied by the mask)
+    ioStatus.dOut = 0;
     for (int i = 0; i < sizeof(DIGITAL_OUTPUTS)/sizeof(DIGITAL_OUTPUTS[0]); i++) {
         pinMode(DIGITAL_OUTPUTS[i], OUTPUT);
-
-        // Set the digital output to its initial state from config
-        ioStatus.dOut[i] = config.doInitialState[i];
-
-        // Apply any inversion logic
-        bool physicalState = config.doInvert[i] ? !ioStatus.dOut[i] : ioStatus.dOut[i];
-        digitalWrite(DIGITAL_OUTPUTS[i], physicalState);
+        if (config.doInitialState[i]) ioStatus.dOut |= 1 << i;
     }
+    writeDigitalOutputs(ioStatus.dOut);
     // --- I2C pull-up logic for all configured sensors ---
     bool i2cPinsSet[32] = {false}; // Avoid duplicate pinMode calls
     for (int i = 0; i < numConfiguredSensors; i++) {
@@ -3669,57 +4541,19 @@ void setupUSBNetwork() {
 // Called after sensor config changes to reload sensors and restart polling queues
 void reapplySensorConfig() {
     Serial.println("\n=== Reapplying Sensor Configuration ===");
-    
-    // Stop EZO sensors and clear polling state
-    Serial.println("Stopping EZO sensor polling...");
-    for (int i = 0; i < numConfiguredSensors; i++) {
-        if (ezoSensors[i] != nullptr) {
-            delete ezoSensors[i];
-            ezoSensors[i] = nullptr;
-        }
-    }
-    
-    // Clear all queues
-    Serial.println("Clearing polling queues...");
-    i2cQueueSize = 0;
-    uartQueueSize = 0;
-    oneWireQueueSize = 0;
-    i2cCommands.clear();
-    uartCommands.clear();
-    oneWireCommands.clear();
+    pauseSensorCore();  // Configuration and schedule are rebuilt under core1's feet otherwise
     
     // Reload sensor configuration from file
     Serial.println("Reloading sensor configuration from file...");
     loadSensorConfig();
     applySensorPresets();
     
-    // Reinitialize command queues
-    for (int i = 0; i < numConfiguredSensors; i++) {
-        if (configuredSensors[i].enabled) {
-            SensorCommand cmd = {
-                .sensorIndex = (uint8_t)i,
-                .nextExecutionMs = millis(),
-                .intervalMs = configuredSensors[i].updateInterval,
-                .command = (strcmp(configuredSensors[i].type, "GENERIC") == 0) ? configuredSensors[i].command : nullptr,
-                .isGeneric = (strcmp(configuredSensors[i].type, "GENERIC") == 0)
-            };
-            
-            // Add to appropriate command array
-            if (strncmp(configuredSensors[i].protocol, "I2C", 3) == 0) {
-                i2cCommands.add(cmd);
-                enqueueBusOperation(i, "I2C");
-            } else if (strncmp(configuredSensors[i].protocol, "UART", 4) == 0) {
-                uartCommands.add(cmd);
-                enqueueBusOperation(i, "UART");
-            } else if (strncmp(configuredSensors[i].protocol, "One-Wire", 8) == 0) {
-                oneWireCommands.add(cmd);
-                enqueueBusOperation(i, "One-Wire");
-            }
-        }
-    }
+    // Rebuild polling schedule (also clears pending bus operations and the EZO cycle)
+    rebuildSensorSchedule();
+    compileRegisterMap();
+    sensorConfigGeneration++;
     
-    // Reinitialize EZO sensors if needed
-    initializeEzoSensors();
+    resumeSensorCore();
     
     Serial.printf("Sensor configuration reapplied. %d sensors configured.\n", numConfiguredSensors);
     Serial.println("=== Sensor Configuration Reapplied Successfully ===\n");
@@ -3742,7 +4576,7 @@ void reapplyNetworkConfig() {
     // Restart Modbus server with new port
     Serial.println("Restarting Modbus server with new port...");
     for (int i = 0; i < MAX_MODBUS_CLIENTS; i++) {
-        modbusClients[i].connected = false;
+        closeModbusClient(i, "Modbus server restarting");
         modbusClients[i].server.end();
     }
     delay(200);
@@ -3754,32 +4588,796 @@ void reapplyNetworkConfig() {
     Serial.println("=== Network Configuration Reapplied Successfully ===\n");
 }
 
-void setupModbus() {
-    // Begin the modbus server with the configured port
-    modbusServer.begin(config.modbusPort);
+// Release a pool slot and log why it was closed
+void closeModbusClient(int slot, const char* reason) {
+    ModbusClientConnection& conn = modbusClients[slot];
+    if (!conn.connected) return;
     
-    Serial.print("Starting Modbus server on port: ");
-    Serial.println(config.modbusPort);
+    Serial.printf("Client disconnected from slot %d: %s\n", slot, reason);
+    String remoteIP = conn.clientIP.toString();
+    String localIP = eth.localIP().toString() + ":" + String(config.modbusPort);
+    logNetworkTransaction("MODBUS", "DISCONNECT", localIP, remoteIP, reason);
     
-    // Initialize all ModbusTCPServer instances
-    for (int i = 0; i < MAX_MODBUS_CLIENTS; i++) {
-        modbusClients[i].connected = false;
-        
-        // Initialize each ModbusTCPServer with the same unit ID (1)
+    conn.connected = false;
+    conn.client.stop();
+    connectedClients--;
+    if (connectedClients == 0) {
+        digitalWrite(LED_BUILTIN, LOW);  // Turn off LED when no clients are connected
+    }
+}
+
+// Place a new connection in a free slot of the active pool; when the pool is full,
+// evict the least recently active connection if it has been idle long enough
+void acceptModbusClient(WiFiClient& newClient) {
+    unsigned long now = millis();
+    int poolSize = constrain((int)config.modbusMaxClients, 1, MAX_MODBUS_CLIENTS);
+    int slot = -1;
+    int lruSlot = -1;
+    for (int i = 0; i < poolSize; i++) {
+        if (!modbusClients[i].connected) {
+            slot = i;
+            break;
+        }
+        if (lruSlot < 0 || now - modbusClients[i].lastActivity > now - modbusClients[lruSlot].lastActivity) {
+            lruSlot = i;
+        }
+    }
+    
+    if (slot < 0 && lruSlot >= 0 && now - modbusClients[lruSlot].lastActivity >= MODBUS_EVICT_MIN_IDLE_MS) {
+        modbusPoolStats.evicted++;
+        closeModbusClient(lruSlot, "Modbus TCP connection evicted (least recently used)");
+        slot = lruSlot;
+    }
+    
+    if (slot < 0) {
+        Serial.println("No available slots for new client");
+        modbusPoolStats.rejected++;
+        newClient.stop();
+        return;
+    }
+    
+    ModbusClientConnection& conn = modbusClients[slot];
+    conn.client = newClient;
+    conn.connected = true;
+    conn.clientIP = newClient.remoteIP();
+    conn.clientPort = newClient.remotePort();
+    conn.connectionTime = now;
+    conn.lastActivity = now;
+    conn.stats = {};
+    
+    // Half-open peers (e.g. a rebooted PLC) are detected by lwIP instead of holding the slot
+    conn.client.keepAlive(MODBUS_KEEPALIVE_IDLE_S, MODBUS_KEEPALIVE_INTERVAL_S, MODBUS_KEEPALIVE_COUNT);
+    conn.client.setNoDelay(true);
+    
+    // Accept the connection on this server instance
+    conn.server.accept(conn.client);
+    Serial.printf("New client connected to slot %d\n", slot);
+    
+    // Log Modbus connection for network monitoring
+    String remoteIP = conn.clientIP.toString();
+    String localIP = eth.localIP().toString() + ":" + String(config.modbusPort);
+    logNetworkTransaction("MODBUS", "CONNECT", localIP, remoteIP, "New Modbus TCP connection established");
+    
+    connectedClients++;
+    modbusPoolStats.accepted++;
+    if (connectedClients > modbusPoolStats.peak) modbusPoolStats.peak = connectedClients;
+    digitalWrite(LED_BUILTIN, HIGH);  // Turn on LED when at least one client is connected
+}
+
+void recordLatency(ModbusLatencyHistogram& histogram, uint32_t latencyUs) {
+    int bucket = 0;
+    while (latencyUs > MODBUS_LATENCY_BOUNDS_US[bucket]) bucket++;  // Last bound is UINT32_MAX
+    histogram.buckets[bucket]++;
+    histogram.count++;
+    histogram.totalUs += latencyUs;
+    if (latencyUs > histogram.maxUs) histogram.maxUs = latencyUs;
+}
+
+// Upper bound of the bucket holding the given fraction of requests (max for the open bucket)
+uint32_t latencyPercentile(const ModbusLatencyHistogram& histogram, float fraction) {
+    if (histogram.count == 0) return 0;
+    uint32_t target = (uint32_t)ceilf(histogram.count * fraction);
+    uint32_t seen = 0;
+    for (int b = 0; b < MODBUS_LATENCY_BUCKETS - 1; b++) {
+        seen += histogram.buckets[b];
+        if (seen >= target) return min(MODBUS_LATENCY_BOUNDS_US[b], histogram.maxUs);
+    }
+    return histogram.maxUs;
+}
+
+uint32_t latencyMean(const ModbusLatencyHistogram& histogram) {
+    return histogram.count ? (uint32_t)(histogram.totalUs / histogram.count) : 0;
+}
+
+void recordTraffic(ModbusTrafficStats& stats, const ModbusRequestInfo& info) {
+    stats.bytesIn += info.requestLength;
+    stats.bytesOut += info.responseLength;
+    if (info.malformed) {
+        stats.malformed++;
+        return;
+    }
+    stats.requests++;
+    if (info.exception) stats.exceptions++;
+    if (info.responseLength == 0) stats.noResponse++;
+    recordLatency(stats.latency, info.latencyUs);
+}
+
+// ModbusServer::onRequest() callback; context is the connection slot
+// Totals, FC08 counters and per-function statistics shared by TCP and RTU
+void recordModbusTotals(const ModbusRequestInfo& info) {
+    recordTraffic(modbusTotals, info);
+    
+    modbusDiagCounters.busMessages++;
+    if (info.malformed) {
+        modbusDiagCounters.commErrors++;
+        return;
+    }
+    modbusDiagCounters.serverMessages++;
+    if (info.exception) modbusDiagCounters.exceptions++;
+    if (info.responseLength == 0) modbusDiagCounters.noResponse++;
+    
+    int f = 0;
+    while (f < MODBUS_STAT_FUNCTIONS - 1 && MODBUS_STAT_FUNCTION_CODES[f] != info.function) f++;
+    ModbusFunctionStats& fs = modbusFunctionStats[f];
+    fs.requests++;
+    if (info.exception) fs.exceptions++;
+    recordLatency(fs.latency, info.latencyUs);
+}
+
+// ModbusServer::onRequest() callback for TCP connections (context = pool slot)
+void recordModbusRequest(void* context, const ModbusRequestInfo& info) {
+    recordTraffic(modbusClients[(intptr_t)context].stats, info);
+    recordModbusTotals(info);
+}
+
+// ModbusServer::onRequest() callback for the RTU server
+void recordModbusRTURequest(void* context, const ModbusRequestInfo& info) {
+    recordTraffic(modbusRtuStats.traffic, info);
+    recordModbusTotals(info);
+}
+
+// ModbusServer::onCoilWrite() callback: drive written outputs during request processing
+// instead of on the next updateIOpins() pass
+void applyModbusCoilWrite(void* context, int address, int count, uint32_t startedUs) {
+    if (address + count > MODBUS_GATEWAY_BASE) queueGatewayWrites(MODBUS_FC_READ_COILS, address, count);
+    if (address >= 8 || address + count <= 0) return;  // Latch reset coils (100-107) are handled by updateModbusImage()
+    
+    // One masked SIO write drives every output, so an FC15 write lands on all pins together
+    ioStatus.dOut = modbusImage.readCoilBits(0, 8);
+    writeDigitalOutputs(ioStatus.dOut);
+    recordLatency(coilProcessingLatency, micros() - startedUs);
+}
+
+// FC08 Diagnostics (ModbusServer::onFunction handler): echo, counter reads and clears
+int handleModbusDiagnostics(void* context, const uint8_t* pdu, int pduLength, uint8_t* rsp) {
+    if (pduLength < 5) return -MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+    uint16_t subFunction = (pdu[1] << 8) | pdu[2];
+    uint16_t data = (pdu[3] << 8) | pdu[4];
+    uint16_t value;
+    
+    switch (subFunction) {
+        case 0x00:  // Return Query Data
+            memcpy(rsp, pdu, pduLength);
+            return pduLength;
+        case 0x01:  // Restart Communications Option (only the counters are reset)
+            if (data != 0x0000 && data != 0xFF00) return -MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+            modbusDiagCounters = {};
+            memcpy(rsp, pdu, 5);
+            return 5;
+        case 0x0A:  // Clear Counters and Diagnostic Register
+            if (data != 0) return -MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+            modbusDiagCounters = {};
+            memcpy(rsp, pdu, 5);
+            return 5;
+        case 0x02: value = 0; break;                                   // Diagnostic Register
+        case 0x0B: value = modbusDiagCounters.busMessages; break;      // Bus Message Count
+        case 0x0C: value = modbusDiagCounters.commErrors; break;       // Bus Communication Error Count
+        case 0x0D: value = modbusDiagCounters.exceptions; break;       // Bus Exception Error Count
+        case 0x0E: value = modbusDiagCounters.serverMessages; break;   // Server Message Count
+        case 0x0F: value = modbusDiagCounters.noResponse; break;       // Server No Response Count
+        case 0x10:                                                     // Server NAK Count
+        case 0x11:                                                     // Server Busy Count
+        case 0x12: value = 0; break;                                   // Bus Character Overrun Count
+        default:
+            return -MODBUS_EXCEPTION_ILLEGAL_FUNCTION;
+    }
+    if (data != 0) return -MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+    
+    rsp[0] = pdu[0];
+    rsp[1] = pdu[1];
+    rsp[2] = pdu[2];
+    rsp[3] = value >> 8;
+    rsp[4] = value & 0xFF;
+    return 5;
+}
+
+void putRegister32(uint16_t* regs, int offset, uint32_t value) {
+    regs[offset] = (uint16_t)(value >> 16);
+    regs[offset + 1] = (uint16_t)value;
+}
+
+// Reserved statistics block at MODBUS_DIAG_BASE; 32-bit values high word first
+void writeModbusDiagnosticRegisters() {
+    uint16_t regs[MODBUS_DIAG_REGISTERS] = {};
+    putRegister32(regs, 0, modbusTotals.requests);
+    putRegister32(regs, 2, modbusTotals.exceptions);
+    putRegister32(regs, 4, modbusTotals.malformed);
+    putRegister32(regs, 6, modbusTotals.bytesIn);
+    putRegister32(regs, 8, modbusTotals.bytesOut);
+    putRegister32(regs, 10, latencyPercentile(modbusTotals.latency, 0.50f));
+    putRegister32(regs, 12, latencyPercentile(modbusTotals.latency, 0.99f));
+    putRegister32(regs, 14, modbusTotals.latency.maxUs);
+    putRegister32(regs, 16, latencyMean(modbusTotals.latency));
+    regs[18] = connectedClients;
+    regs[19] = modbusPoolStats.peak;
+    putRegister32(regs, 20, modbusPoolStats.accepted);
+    for (int f = 0; f < MODBUS_STAT_FUNCTIONS; f++) {
+        regs[22 + f] = (uint16_t)modbusFunctionStats[f].requests;
+    }
+    modbusImage.writeInputRegisters(MODBUS_DIAG_BASE, regs, MODBUS_DIAG_REGISTERS);
+}
+
+void setupModbus() {
+    // Begin the modbus server with the configured port
+    modbusServer.begin(config.modbusPort);
+    
+    Serial.print("Starting Modbus server on port: ");
+    Serial.println(config.modbusPort);
+    
+    // Configure the register image once; every client connection serves it
+    modbusImage.configureInputRegisters(0x00, modbusInputRegisterCount);  // 32, or up to the end of the packed block
+    modbusHoldingRegisterCount = modbusCoilCount = modbusDiscreteInputCount = 0;
+    resizeModbusImage();  // 16 holding registers, 128 coils, 16 discrete inputs, plus the gateway window
+    
+    // Sensor registers are rewritten from the map
+    registerImageStale = true;
+    updateModbusImage();
+    
+    // Initialize all ModbusTCPServer instances
+    for (int i = 0; i < MAX_MODBUS_CLIENTS; i++) {
+        modbusClients[i].connected = false;
+        
+        // Initialize each ModbusTCPServer with the same unit ID (1)
         if (!modbusClients[i].server.begin(1)) {
             Serial.print("Failed to start Modbus TCP Server for client ");
             Serial.println(i);
             continue;
         }
         
-        // Configure Modbus registers for each client server
-        modbusClients[i].server.configureHoldingRegisters(0x00, 16);  // 16 holding registers
-        modbusClients[i].server.configureInputRegisters(0x00, 32);    // 32 input registers
-        modbusClients[i].server.configureCoils(0x00, 128);           // 128 coils (0-127)
-        modbusClients[i].server.configureDiscreteInputs(0x00, 16);   // 16 discrete inputs
+        modbusClients[i].server.shareMapping(modbusImage);
+        modbusClients[i].server.onRequest(recordModbusRequest, (void*)(intptr_t)i);
+        modbusClients[i].server.onFunction(MODBUS_FC_DIAGNOSTICS, handleModbusDiagnostics, NULL);
+        modbusClients[i].server.onCoilWrite(applyModbusCoilWrite, NULL);
+        modbusClients[i].server.onRegisterWrite(forwardModbusRegisterWrite, NULL);
     }
     
     Serial.println("Modbus TCP Servers started");
+    
+    openModbusRTU();
+}
+
+// Modbus RTU server (RS485). The RX interrupt timestamps each character and
+// closes a frame when the next one arrives after t3.5 of silence; loop() closes
+// a trailing frame once t3.5 has passed. Framing therefore never depends on how
+// late loop() runs. Replies are sent by DMA, and a timer alarm drops DE after
+// the last stop bit, so neither direction waits in loop().
+
+// Hand the filled receive buffer over as a frame; drops it if the previous
+// frame has not been handled yet. Runs in the RX interrupt or with it masked.
+void closeModbusRTUFrame() {
+    ModbusRTULink& link = modbusRtu;
+    modbusRtuStats.frames++;
+    if (link.frameReady || link.rxOverflow) {
+        modbusRtuStats.overruns++;
+    } else {
+        link.frameLength = link.rxLength;
+        link.frameStartedUs = link.firstByteUs;
+        link.rxBuffer ^= 1;
+        link.frameReady = true;
+    }
+    link.rxLength = 0;
+    link.rxOverflow = false;
+}
+
+// UART RX interrupt (FIFO disabled, so one interrupt per character)
+void modbusRTUIrqHandler() {
+    ModbusRTULink& link = modbusRtu;
+    uart_hw_t* hw = uart_get_hw(link.uart);
+    while (!(hw->fr & UART_UARTFR_RXFE_BITS)) {
+        uint32_t data = hw->dr;
+        uint32_t now = micros();
+        if (link.transmitting) continue;  // Own reply echoed by a transceiver with /RE held low
+        
+        if (data & (UART_UARTDR_OE_BITS | UART_UARTDR_BE_BITS | UART_UARTDR_PE_BITS | UART_UARTDR_FE_BITS)) {
+            modbusRtuStats.lineErrors++;  // Byte is kept; the frame CRC rejects it
+        }
+        if (link.rxLength > 0 && now - link.lastByteUs >= link.t35Us) {
+            closeModbusRTUFrame();
+        }
+        if (link.rxLength == 0) link.firstByteUs = now;
+        if (link.rxLength < MODBUS_RTU_MAX_ADU_LENGTH) {
+            link.rx[link.rxBuffer][link.rxLength++] = (uint8_t)data;
+        } else {
+            link.rxOverflow = true;
+        }
+        link.lastByteUs = now;
+    }
+}
+
+// Timer alarm: release the bus once DMA and the UART shift register are empty
+int64_t finishModbusRTUTransmit(alarm_id_t id, void* userData) {
+    ModbusRTULink& link = modbusRtu;
+    if (link.port < 0) return 0;
+    uart_hw_t* hw = uart_get_hw(link.uart);
+    if (dma_channel_is_busy(link.dmaTx) || (hw->fr & UART_UARTFR_BUSY_BITS)) {
+        return link.charUs / 4 + 1;  // Check again shortly
+    }
+    if (link.dePin >= 0) gpio_put(link.dePin, 0);
+    while (!(hw->fr & UART_UARTFR_RXFE_BITS)) (void)hw->dr;  // Discard the echo of the last character
+    link.transmitting = false;
+    return 0;
+}
+
+// modbus_rtu_frame_send_t for ModbusRTUServer: queue the reply ADU on the DMA channel
+int sendModbusRTUFrame(void* context, const uint8_t* adu, int length) {
+    ModbusRTULink& link = modbusRtu;
+    if (link.port < 0 || link.transmitting || length > MODBUS_RTU_MAX_ADU_LENGTH) return -1;
+    
+    memcpy(link.tx, adu, length);
+    link.transmitting = true;
+    if (link.dePin >= 0) gpio_put(link.dePin, 1);
+    
+    dma_channel_config c = dma_channel_get_default_config(link.dmaTx);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, uart_get_dreq(link.uart, true));
+    dma_channel_configure(link.dmaTx, &c, &uart_get_hw(link.uart)->dr, link.tx, length, true);
+    
+    // First check when the last character should have left; the alarm re-arms if not
+    add_alarm_in_us((uint64_t)link.charUs * length + link.charUs / 2, finishModbusRTUTransmit, NULL, true);
+    return length;
+}
+
+// Split a UART_FRAMINGS name ("8E1") into SDK format arguments
+bool parseModbusRTUFraming(const char* framing, uint& dataBits, uart_parity_t& parity, uint& stopBits) {
+    if (strlen(framing) != 3) return false;
+    dataBits = framing[0] - '0';
+    stopBits = framing[2] - '0';
+    switch (toupper(framing[1])) {
+        case 'N': parity = UART_PARITY_NONE; break;
+        case 'E': parity = UART_PARITY_EVEN; break;
+        case 'O': parity = UART_PARITY_ODD; break;
+        default: return false;
+    }
+    return (dataBits == 7 || dataBits == 8) && (stopBits == 1 || stopBits == 2);
+}
+
+// (Re)start the RTU server from config; safe to call at any time on core0
+bool openModbusRTU() {
+    closeModbusRTU();
+    if (!config.modbusRtuEnabled) return false;
+    
+    int port = uartPortForPins(config.modbusRtuTxPin, config.modbusRtuRxPin);
+    uint dataBits, stopBits;
+    uart_parity_t parity;
+    if (port < 0 || !parseModbusRTUFraming(config.modbusRtuFraming, dataBits, parity, stopBits) ||
+        config.modbusRtuBaud == 0) {
+        Serial.println("Modbus RTU: invalid UART pins or framing, server not started");
+        return false;
+    }
+    
+    // Reserve the port before core1 can reopen it, then have core1 release it
+    // (SerialUART must end on the core that enabled its interrupt)
+    modbusRtu.port = port;
+    if (core0setupComplete && uartPorts[port].open) {
+        uartPortsStale = true;
+        while (uartPortsStale) {
+            rp2040.wdt_reset();  // Core1 closes its ports on its next pass
+        }
+    }
+    
+    ModbusRTULink& link = modbusRtu;
+    link.gateway = config.modbusRtuGateway;
+    link.uart = port == 0 ? uart0 : uart1;
+    link.dePin = config.modbusRtuDePin;
+    uint32_t bitsPerChar = 1 + dataBits + (parity == UART_PARITY_NONE ? 0 : 1) + stopBits;
+    link.charUs = (bitsPerChar * 1000000UL + config.modbusRtuBaud - 1) / config.modbusRtuBaud;
+    link.t35Us = config.modbusRtuBaud > 19200 ? MODBUS_RTU_T35_FIXED_US : (link.charUs * 7 + 1) / 2;
+    link.rxBuffer = 0;
+    link.rxLength = 0;
+    link.rxOverflow = false;
+    link.frameReady = false;
+    link.transmitting = false;
+    if (link.dmaTx < 0) link.dmaTx = dma_claim_unused_channel(true);
+    
+    if (link.dePin >= 0) {
+        gpio_init(link.dePin);
+        gpio_set_dir(link.dePin, true);
+        gpio_put(link.dePin, 0);
+    }
+    uart_init(link.uart, config.modbusRtuBaud);
+    uart_set_format(link.uart, dataBits, stopBits, parity);
+    uart_set_hw_flow(link.uart, false, false);
+    uart_set_fifo_enabled(link.uart, false);  // Interrupt per character for exact timestamps
+    gpio_set_function(config.modbusRtuTxPin, GPIO_FUNC_UART);
+    gpio_set_function(config.modbusRtuRxPin, GPIO_FUNC_UART);
+    
+    int irq = port == 0 ? UART0_IRQ : UART1_IRQ;
+    irq_set_exclusive_handler(irq, modbusRTUIrqHandler);
+    irq_set_enabled(irq, true);
+    uart_set_irq_enables(link.uart, true, false);
+    
+    if (link.gateway) {
+        if (!ModbusRTUClient.begin(sendModbusRTUFrame, NULL)) {
+            Serial.println("Failed to start Modbus RTU gateway");
+            closeModbusRTU();
+            return false;
+        }
+        compileGatewayReads();
+        Serial.printf("Modbus RTU gateway: UART%d TX=%d RX=%d DE=%d, %lu %s, %d polls in %d reads, timeout %dms\n",
+                      port, config.modbusRtuTxPin, config.modbusRtuRxPin, link.dePin,
+                      (unsigned long)config.modbusRtuBaud, config.modbusRtuFraming,
+                      gatewayConfig.pollCount, modbusGateway.readCount, gatewayConfig.responseTimeoutMs);
+        return true;
+    }
+    
+    if (!ModbusRTUServer.begin(config.modbusRtuUnitId, sendModbusRTUFrame, NULL)) {
+        Serial.println("Failed to start Modbus RTU server");
+        closeModbusRTU();
+        return false;
+    }
+    ModbusRTUServer.shareMapping(modbusImage);
+    ModbusRTUServer.onRequest(recordModbusRTURequest, NULL);
+    ModbusRTUServer.onFunction(MODBUS_FC_DIAGNOSTICS, handleModbusDiagnostics, NULL);
+    ModbusRTUServer.onCoilWrite(applyModbusCoilWrite, NULL);
+    ModbusRTUServer.onRegisterWrite(forwardModbusRegisterWrite, NULL);
+    
+    Serial.printf("Modbus RTU server: unit %d, UART%d TX=%d RX=%d DE=%d, %lu %s, t3.5=%luus\n",
+                  config.modbusRtuUnitId, port, config.modbusRtuTxPin, config.modbusRtuRxPin, link.dePin,
+                  (unsigned long)config.modbusRtuBaud, config.modbusRtuFraming, (unsigned long)link.t35Us);
+    return true;
+}
+
+void closeModbusRTU() {
+    ModbusRTULink& link = modbusRtu;
+    if (link.port < 0) return;
+    
+    uart_set_irq_enables(link.uart, false, false);
+    int irq = link.port == 0 ? UART0_IRQ : UART1_IRQ;
+    irq_set_enabled(irq, false);
+    irq_remove_handler(irq, modbusRTUIrqHandler);
+    dma_channel_abort(link.dmaTx);
+    uart_deinit(link.uart);
+    if (link.dePin >= 0) gpio_put(link.dePin, 0);
+    
+    link.port = -1;  // Also cancels a pending finishModbusRTUTransmit()
+    link.transmitting = false;
+    link.frameReady = false;
+    if (link.gateway) {
+        ModbusRTUClient.end();
+        modbusGateway.waiting = false;
+        modbusGateway.writeCount = 0;
+    } else {
+        ModbusRTUServer.end();
+    }
+}
+
+// Called from loop(): close a trailing frame after t3.5 and answer it
+void pollModbusRTU() {
+    ModbusRTULink& link = modbusRtu;
+    if (link.port < 0) return;
+    
+    if (!link.frameReady && link.rxLength > 0) {
+        uint32_t irqState = save_and_disable_interrupts();
+        if (!link.frameReady && link.rxLength > 0 && micros() - link.lastByteUs >= link.t35Us) {
+            closeModbusRTUFrame();
+        }
+        restore_interrupts(irqState);
+    }
+    if (link.gateway) {
+        pollModbusGateway();
+        return;
+    }
+    if (!link.frameReady || link.transmitting) return;
+    
+    if (ModbusRTUServer.handleFrame(link.rx[link.rxBuffer ^ 1], link.frameLength, link.frameStartedUs) == 0) {
+        modbusRtuStats.otherUnit++;
+    }
+    link.frameReady = false;
+}
+
+// Modbus RTU gateway: the RS485 port runs as master and polls downstream
+// devices into the gateway window (1000-3999) of the shared image, so a TCP
+// read there is answered from memory instead of a serial round trip. Polls of
+// one unit and function with touching ranges are coalesced into one request.
+// Writes to mapped coils and holding registers are queued and forwarded ahead
+// of polls. One request is outstanding at a time and nothing waits on the bus.
+
+// End of the local range the gateway maps into a table (by read function), 0 when the gateway is off
+int gatewayTableEnd(uint8_t function) {
+    if (!config.modbusRtuEnabled || !config.modbusRtuGateway) return 0;
+    int end = 0;
+    for (int i = 0; i < gatewayConfig.pollCount; i++) {
+        const GatewayPoll& poll = gatewayConfig.polls[i];
+        if (poll.function == function) end = max(end, poll.localAddress + poll.count);
+    }
+    return end;
+}
+
+// Size holding registers, coils and discrete inputs to cover the gateway
+// window (input registers follow compileRegisterMap()). A resized table is
+// cleared, so coils are re-synced to the outputs.
+void resizeModbusImage() {
+    int holdingRegisters = max(MODBUS_HOLDING_REGISTERS, gatewayTableEnd(MODBUS_FC_READ_HOLDING_REGISTERS));
+    int coils = max(MODBUS_COILS, gatewayTableEnd(MODBUS_FC_READ_COILS));
+    int discreteInputs = max(MODBUS_DISCRETE_INPUTS, gatewayTableEnd(MODBUS_FC_READ_DISCRETE_INPUTS));
+    
+    if (holdingRegisters != modbusHoldingRegisterCount) {
+        // configureHoldingRegisters() zeroes the table, so carry the client-written values over
+        int kept = min(holdingRegisters, modbusHoldingRegisterCount);
+        uint16_t* saved = kept > 0 ? (uint16_t*)malloc(kept * sizeof(uint16_t)) : NULL;
+        if (saved) {
+            for (int i = 0; i < kept; i++) saved[i] = modbusImage.holdingRegisterRead(i);
+        }
+        modbusHoldingRegisterCount = holdingRegisters;
+        modbusImage.configureHoldingRegisters(0x00, modbusHoldingRegisterCount);
+        if (saved) {
+            for (int i = 0; i < kept; i++) modbusImage.holdingRegisterWrite(i, saved[i]);
+            free(saved);
+        }
+    }
+    if (coils != modbusCoilCount) {
+        modbusCoilCount = coils;
+        modbusImage.configureCoils(0x00, modbusCoilCount);
+        modbusImage.writeCoilBits(0, ioStatus.dOut, 8);
+    }
+    if (discreteInputs != modbusDiscreteInputCount) {
+        modbusDiscreteInputCount = discreteInputs;
+        modbusImage.configureDiscreteInputs(0x00, modbusDiscreteInputCount);
+        modbusImage.writeDiscreteInputBits(0, ioStatus.dIn, 8);
+    }
+}
+
+bool gatewayPollBefore(uint8_t a, uint8_t b) {
+    const GatewayPoll& pa = gatewayConfig.polls[a];
+    const GatewayPoll& pb = gatewayConfig.polls[b];
+    if (pa.unitId != pb.unitId) return pa.unitId < pb.unitId;
+    if (pa.function != pb.function) return pa.function < pb.function;
+    return pa.remoteAddress < pb.remoteAddress;
+}
+
+// Coalesce the poll list into the fewest reads: polls sorted by unit, function
+// and remote address merge while their ranges touch or overlap and the span
+// stays within the protocol limit. A read runs at its fastest poll's interval.
+void compileGatewayReads() {
+    ModbusGateway& gw = modbusGateway;
+    uint8_t order[MODBUS_GATEWAY_MAX_POLLS];
+    int pollCount = gatewayConfig.pollCount;
+    for (int i = 0; i < pollCount; i++) {
+        uint8_t key = i;
+        int j = i - 1;
+        while (j >= 0 && gatewayPollBefore(key, order[j])) {
+            order[j + 1] = order[j];
+            j--;
+        }
+        order[j + 1] = key;
+    }
+    
+    gw.readCount = 0;
+    for (int k = 0; k < pollCount; k++) {
+        const GatewayPoll& poll = gatewayConfig.polls[order[k]];
+        int limit = poll.function <= MODBUS_FC_READ_DISCRETE_INPUTS ? MODBUS_MAX_READ_BITS : MODBUS_MAX_READ_REGISTERS;
+        GatewayRead* read = gw.readCount > 0 ? &gw.reads[gw.readCount - 1] : NULL;
+        int end = read ? max(read->address + read->count, poll.remoteAddress + poll.count) : 0;
+        
+        if (read && read->unitId == poll.unitId && read->function == poll.function &&
+            poll.remoteAddress <= read->address + read->count && end - read->address <= limit) {
+            read->count = end - read->address;
+            read->intervalMs = min(read->intervalMs, poll.intervalMs);
+        } else {
+            read = &gw.reads[gw.readCount++];
+            *read = {};
+            read->unitId = poll.unitId;
+            read->function = poll.function;
+            read->address = poll.remoteAddress;
+            read->count = poll.count;
+            read->intervalMs = poll.intervalMs;
+        }
+        read->polls |= 1 << order[k];
+    }
+    
+    uint32_t now = millis();
+    for (int r = 0; r < gw.readCount; r++) {
+        gw.reads[r].lastStartMs = now - gw.reads[r].intervalMs;  // Due immediately
+    }
+    gw.waiting = false;
+    gw.writeHead = 0;
+    gw.writeCount = 0;
+}
+
+// A local write to this poll's range is still waiting to be forwarded
+bool gatewayWritePending(int pollIndex) {
+    const ModbusGateway& gw = modbusGateway;
+    for (int q = 0; q < gw.writeCount; q++) {
+        if (gw.writes[(gw.writeHead + q) % MODBUS_GATEWAY_WRITE_QUEUE].poll == pollIndex) return true;
+    }
+    return false;
+}
+
+// Queue forwarding of locally written coils (FC01 polls) or holding registers
+// (FC03 polls), split per poll and per protocol write limit. A range already
+// queued is not queued twice: values are read from the image when sent.
+void queueGatewayWrites(uint8_t function, int address, int count) {
+    ModbusGateway& gw = modbusGateway;
+    if (modbusRtu.port < 0 || !modbusRtu.gateway) return;
+    int limit = function == MODBUS_FC_READ_COILS ? MODBUS_MAX_WRITE_BITS : MODBUS_MAX_WRITE_REGISTERS;
+    
+    for (int p = 0; p < gatewayConfig.pollCount; p++) {
+        const GatewayPoll& poll = gatewayConfig.polls[p];
+        if (poll.function != function) continue;
+        int start = max(address, (int)poll.localAddress);
+        int end = min(address + count, poll.localAddress + poll.count);
+        
+        for (; start < end; start += limit) {
+            GatewayWrite write = {(uint8_t)p, (uint16_t)start, (uint16_t)min(end - start, limit)};
+            bool queued = false;
+            for (int q = 0; q < gw.writeCount && !queued; q++) {
+                if (q == 0 && gw.waiting && gw.activeRead < 0) continue;  // Head is on the wire with older values
+                const GatewayWrite& pending = gw.writes[(gw.writeHead + q) % MODBUS_GATEWAY_WRITE_QUEUE];
+                queued = pending.poll == write.poll && pending.localAddress == write.localAddress && pending.count == write.count;
+            }
+            if (queued) continue;
+            if (gw.writeCount == MODBUS_GATEWAY_WRITE_QUEUE) {
+                modbusGatewayStats.writesDropped++;
+                continue;
+            }
+            gw.writes[(gw.writeHead + gw.writeCount++) % MODBUS_GATEWAY_WRITE_QUEUE] = write;
+        }
+    }
+}
+
+// ModbusServer::onRegisterWrite() callback: forward writes into the gateway window
+void forwardModbusRegisterWrite(void* context, int address, int count, uint32_t startedUs) {
+    if (address + count > MODBUS_GATEWAY_BASE) queueGatewayWrites(MODBUS_FC_READ_HOLDING_REGISTERS, address, count);
+}
+
+// Copy a read's response into the image at each poll's local address
+void scatterGatewayRead(const GatewayRead& read) {
+    ModbusGateway& gw = modbusGateway;
+    for (int p = 0; p < gatewayConfig.pollCount; p++) {
+        if (!(read.polls & (1 << p)) || gatewayWritePending(p)) continue;  // A local write not yet forwarded wins
+        const GatewayPoll& poll = gatewayConfig.polls[p];
+        uint16_t* values = gw.values + (poll.remoteAddress - read.address);
+        switch (poll.function) {
+            case MODBUS_FC_READ_COILS:
+                for (int i = 0; i < poll.count; i++) modbusImage.coilWrite(poll.localAddress + i, values[i]);
+                break;
+            case MODBUS_FC_READ_DISCRETE_INPUTS:
+                for (int i = 0; i < poll.count; i++) modbusImage.discreteInputWrite(poll.localAddress + i, values[i]);
+                break;
+            case MODBUS_FC_READ_HOLDING_REGISTERS:
+                for (int i = 0; i < poll.count; i++) modbusImage.holdingRegisterWrite(poll.localAddress + i, values[i]);
+                break;
+            default:
+                modbusImage.writeInputRegisters(poll.localAddress, values, poll.count);
+                break;
+        }
+    }
+}
+
+// Close the outstanding request; a failed read leaves the last values in place
+void completeGatewayTransaction(GatewayStatus status, uint8_t exception) {
+    ModbusGateway& gw = modbusGateway;
+    gw.waiting = false;
+    switch (status) {
+        case GatewayStatus::OK: modbusGatewayStats.responses++; break;
+        case GatewayStatus::TIMEOUT: modbusGatewayStats.timeouts++; break;
+        case GatewayStatus::EXCEPTION: modbusGatewayStats.exceptions++; break;
+        default: modbusGatewayStats.invalid++; break;
+    }
+    
+    if (gw.activeRead < 0) {
+        // A failed write is not retried; the next poll shows the device's value again
+        if (status == GatewayStatus::OK) modbusGatewayStats.writes++;
+        else modbusGatewayStats.writeFailures++;
+        gw.writeHead = (gw.writeHead + 1) % MODBUS_GATEWAY_WRITE_QUEUE;
+        gw.writeCount--;
+        return;
+    }
+    
+    GatewayRead& read = gw.reads[gw.activeRead];
+    read.status = status;
+    read.exception = exception;
+    if (status != GatewayStatus::OK) {
+        read.failures++;
+        return;
+    }
+    read.responses++;
+    scatterGatewayRead(read);
+}
+
+// Send the next request: queued writes first, then the most overdue read
+void startGatewayTransaction() {
+    ModbusGateway& gw = modbusGateway;
+    uint32_t now = millis();
+    int unitId, function, address, count;
+    
+    if (gw.writeCount > 0) {
+        const GatewayWrite& write = gw.writes[gw.writeHead];
+        const GatewayPoll& poll = gatewayConfig.polls[write.poll];
+        bool coils = poll.function == MODBUS_FC_READ_COILS;
+        for (int i = 0; i < write.count; i++) {
+            gw.values[i] = coils ? modbusImage.coilRead(write.localAddress + i) : modbusImage.holdingRegisterRead(write.localAddress + i);
+        }
+        unitId = poll.unitId;
+        if (coils) function = write.count == 1 ? MODBUS_FC_WRITE_SINGLE_COIL : MODBUS_FC_WRITE_MULTIPLE_COILS;
+        else function = write.count == 1 ? MODBUS_FC_WRITE_SINGLE_REGISTER : MODBUS_FC_WRITE_MULTIPLE_REGISTERS;
+        address = poll.remoteAddress + (write.localAddress - poll.localAddress);
+        count = write.count;
+        gw.activeRead = -1;
+    } else {
+        int next = -1;
+        uint32_t nextLateMs = 0;
+        for (int r = 0; r < gw.readCount; r++) {
+            uint32_t elapsed = now - gw.reads[r].lastStartMs;
+            if (elapsed < gw.reads[r].intervalMs) continue;
+            if (next < 0 || elapsed - gw.reads[r].intervalMs > nextLateMs) {
+                next = r;
+                nextLateMs = elapsed - gw.reads[r].intervalMs;
+            }
+        }
+        if (next < 0) return;
+        
+        GatewayRead& read = gw.reads[next];
+        read.lastStartMs = now;
+        unitId = read.unitId;
+        function = read.function;
+        address = read.address;
+        count = read.count;
+        gw.activeRead = next;
+    }
+    
+    modbusGatewayStats.requests++;
+    if (!ModbusRTUClient.sendRequest(unitId, function, address, count, gw.values)) {
+        completeGatewayTransaction(GatewayStatus::INVALID, 0);
+        return;
+    }
+    gw.waiting = true;
+    gw.sentMs = now;
+}
+
+// Called from pollModbusRTU() in gateway mode: match a response, time out a
+// silent device, then start the next request
+void pollModbusGateway() {
+    ModbusRTULink& link = modbusRtu;
+    ModbusGateway& gw = modbusGateway;
+    
+    if (link.frameReady) {
+        if (gw.waiting) {
+            int rc = ModbusRTUClient.handleResponse(link.rx[link.rxBuffer ^ 1], link.frameLength, gw.values);
+            if (rc > 0) {
+                completeGatewayTransaction(GatewayStatus::OK, 0);
+            } else if (rc == 0) {
+                modbusGatewayStats.otherUnit++;  // Keep waiting for the unit that was asked
+            } else if (errno > MODBUS_ENOBASE && errno < MODBUS_ENOBASE + MODBUS_EXCEPTION_MAX) {
+                completeGatewayTransaction(GatewayStatus::EXCEPTION, errno - MODBUS_ENOBASE);
+            } else {
+                completeGatewayTransaction(GatewayStatus::INVALID, 0);
+            }
+        }
+        link.frameReady = false;  // Frames with no request outstanding are dropped
+    }
+    
+    if (link.transmitting) {
+        gw.sentMs = millis();  // The response timeout runs from the last stop bit
+        return;
+    }
+    if (gw.waiting) {
+        if (millis() - gw.sentMs < gatewayConfig.responseTimeoutMs) return;
+        completeGatewayTransaction(GatewayStatus::TIMEOUT, 0);
+    }
+    startGatewayTransaction();
 }
 
 void setupWebServer() {
@@ -3793,92 +5391,385 @@ void setupWebServer() {
     Serial.println("================================");
 }
 
-void handleSimpleHTTP() {
-    static unsigned long lastDebugPrint = 0;
-    static unsigned long requestCount = 0;
+// HTTP/1.1 server: a fixed pool of connections serviced from the main loop. Bytes are
+// parsed as they arrive and nothing here waits on the network, so a slow or idle
+// browser never holds up Modbus.
+char httpBody[HTTP_MAX_BODY + 1];
+int httpBodyOwner = -1;  // Connection reading into httpBody, -1 when free
+
+const char* httpConnectionHeader() {
+    httpExchange.framed = httpExchange.keepAlive;
+    return httpExchange.keepAlive ? "Connection: keep-alive" : "Connection: close";
+}
+
+void closeHttpConnection(int slot) {
+    HttpConnection& conn = httpConnections[slot];
+    if (conn.state == HttpConnectionState::FREE) return;
+    if (httpBodyOwner == slot) httpBodyOwner = -1;
+    conn.client.stop();
+    conn.state = HttpConnectionState::FREE;
+}
+
+// Stop reading and close once the response already written has been acknowledged
+void finishHttpConnection(int slot) {
+    HttpConnection& conn = httpConnections[slot];
+    if (httpBodyOwner == slot) httpBodyOwner = -1;
+    conn.state = HttpConnectionState::CLOSING;
+    conn.closeStarted = millis();
+}
+
+void rejectHttpRequest(int slot, int status) {
+    const char* reason = "Bad Request";
+    switch (status) {
+        case 408: reason = "Request Timeout"; break;
+        case 413: reason = "Payload Too Large"; break;
+        case 414: reason = "URI Too Long"; break;
+        case 431: reason = "Request Header Fields Too Large"; break;
+        case 501: reason = "Not Implemented"; break;
+        case 505: reason = "HTTP Version Not Supported"; break;
+    }
+    HttpConnection& conn = httpConnections[slot];
+    conn.client.printf("HTTP/1.1 %d %s\r\nContent-Type: text/plain\r\nContent-Length: %u\r\nConnection: close\r\n\r\n%s",
+                       status, reason, (unsigned)strlen(reason), reason);
+    httpServerStats.errors++;
+    Serial.printf("HTTP slot %d: %d %s\n", slot, status, reason);
+    finishHttpConnection(slot);
+}
+
+// Parse the request head buffered in conn.head. Returns its length once the blank line
+// has arrived, 0 while it is incomplete, or -status for a request that is refused.
+int parseHttpHead(HttpConnection& conn) {
+    // Stray CRLF between pipelined requests is ignored (RFC 9112 2.2)
+    int skip = 0;
+    while (skip < conn.headLength && (conn.head[skip] == '\r' || conn.head[skip] == '\n')) skip++;
+    if (skip > 0) {
+        memmove(conn.head, conn.head + skip, conn.headLength - skip);
+        conn.headLength -= skip;
+    }
+    
+    int end = 0;
+    for (int i = 1; i < conn.headLength; i++) {
+        if (conn.head[i] != '\n') continue;
+        if (conn.head[i - 1] == '\n' || (i > 1 && conn.head[i - 1] == '\r' && conn.head[i - 2] == '\n')) {
+            end = i + 1;
+            break;
+        }
+    }
+    if (end == 0) return 0;
+    
+    // The head is consumed after parsing, so lines are terminated in place
+    for (int i = 0; i < end; i++) {
+        if (conn.head[i] == '\r' || conn.head[i] == '\n') conn.head[i] = '\0';
+    }
+    
+    // Request line: METHOD SP target SP HTTP/1.x
+    char* line = conn.head;
+    char* target = strchr(line, ' ');
+    if (!target) return -400;
+    *target++ = '\0';
+    char* version = strchr(target, ' ');
+    if (!version) return -400;
+    *version++ = '\0';
+    if (strlen(line) >= sizeof(conn.method)) return -501;
+    if (strlen(target) >= sizeof(conn.target)) return -414;
+    if (strcmp(version, "HTTP/1.1") == 0) {
+        conn.keepAlive = true;
+        conn.http11 = true;
+    } else if (strcmp(version, "HTTP/1.0") == 0) {
+        conn.keepAlive = false;
+        conn.http11 = false;
+    } else {
+        return -505;
+    }
+    strcpy(conn.method, line);
+    strcpy(conn.target, target);
+    conn.contentLength = 0;
+    conn.acceptGzip = false;
+    conn.ifNoneMatch[0] = '\0';
+    
+    // Header lines, up to the blank line
+    line = version + strlen(version) + 1;
+    while (line < conn.head + end) {
+        if (*line == '\0') {
+            line++;
+            continue;
+        }
+        char* value = strchr(line, ':');
+        if (value) {
+            *value++ = '\0';
+            while (*value == ' ' || *value == '\t') value++;
+            if (strcasecmp(line, "Content-Length") == 0) {
+                char* digitsEnd;
+                unsigned long length = strtoul(value, &digitsEnd, 10);
+                if (digitsEnd == value) return -400;
+                if (length > HTTP_MAX_BODY) return -413;
+                conn.contentLength = length;
+            } else if (strcasecmp(line, "Transfer-Encoding") == 0) {
+                return -501;  // Chunked request bodies are not accepted; every client here sends Content-Length
+            } else if (strcasecmp(line, "Connection") == 0) {
+                if (strcasestr(value, "close")) conn.keepAlive = false;
+                else if (strcasestr(value, "keep-alive")) conn.keepAlive = true;
+            } else if (strcasecmp(line, "Accept-Encoding") == 0) {
+                conn.acceptGzip = strcasestr(value, "gzip") != NULL;
+            } else if (strcasecmp(line, "If-None-Match") == 0) {
+                strncpy(conn.ifNoneMatch, value, sizeof(conn.ifNoneMatch) - 1);
+                conn.ifNoneMatch[sizeof(conn.ifNoneMatch) - 1] = '\0';
+            }
+            line = value;
+        }
+        line += strlen(line) + 1;
+    }
+    return end;
+}
+
+// Drop the first count bytes of the head buffer (a parsed head, or body bytes that arrived with it)
+void consumeHttpHead(HttpConnection& conn, int count) {
+    memmove(conn.head, conn.head + count, conn.headLength - count);
+    conn.headLength -= count;
+}
+
+void dispatchHttpRequest(int slot, const char* body) {
+    HttpConnection& conn = httpConnections[slot];
+    char* query = strchr(conn.target, '?');
+    if (query) *query++ = '\0';
+    
+    httpExchange.keepAlive = conn.keepAlive;
+    httpExchange.framed = false;
+    httpExchange.chunked = conn.http11;
+    httpExchange.acceptGzip = conn.acceptGzip;
+    httpExchange.ifNoneMatch = conn.ifNoneMatch;
+    httpExchange.query = query ? query : "";
+    
+    String method = conn.method;
+    String path = conn.target;
+    String requestBody = body;
+    Serial.println("HTTP Request: " + method + " " + path);
+    
+    // Log HTTP request for network monitoring
+    String remoteIP = conn.client.remoteIP().toString();
+    String localIP = eth.localIP().toString() + ":" + String(HTTP_PORT);
+    String requestData = method + " " + path;
+    if (requestBody.length() > 0) {
+        requestData += " (Body: " + requestBody.substring(0, min(50, (int)requestBody.length())) + (requestBody.length() > 50 ? "..." : "") + ")";
+    }
+    logNetworkTransaction("HTTP", "RX", localIP, remoteIP, requestData);
+    
+    routeRequest(conn.client, method, path, requestBody);
+    
+    httpServerStats.requests++;
+    if (conn.requests++ > 0) httpServerStats.reused++;
+    conn.lastActivity = millis();
+    conn.requestStarted = conn.lastActivity;  // For a pipelined request already in head
+    
+    // Responses without Content-Length, or written by a handler that asked for close,
+    // end the connection; everything else waits for the next request
+    bool keepOpen = httpExchange.framed && conn.client.connected();
+    if (httpExchange.eventStream) {
+        conn.state = HttpConnectionState::EVENTS;
+        conn.events = {};
+        conn.events.sensorGeneration = sensorConfigGeneration - 1;  // First push sends every sensor
+        conn.events.logSequence = terminalLogSequence;               // Only lines logged from now on
+        conn.events.lastWrite = conn.lastActivity;
+    } else if (httpExchange.pendingLength > 0) {
+        conn.sendData = httpExchange.pendingData;
+        conn.sendRemaining = httpExchange.pendingLength;
+        conn.keepAlive = keepOpen;
+        conn.state = HttpConnectionState::SEND;
+    } else if (keepOpen) {
+        conn.state = HttpConnectionState::HEAD;
+    } else {
+        finishHttpConnection(slot);
+    }
+    httpExchange = {};
+}
+
+// Read and answer whatever this connection has buffered, up to HTTP_MAX_REQUESTS_PER_PASS requests
+void serviceHttpConnection(int slot) {
+    HttpConnection& conn = httpConnections[slot];
+    unsigned long now = millis();
     
-    WiFiClient client = httpServer.accept();
-    if (client) {
-        requestCount++;
-        if (millis() - lastDebugPrint > 5000) { // Print debug every 5 seconds
-            Serial.print("=== WEB STATS: Requests/5s: ");
-            Serial.println(requestCount);
-            requestCount = 0;
-            lastDebugPrint = millis();
+    if (conn.state == HttpConnectionState::CLOSING) {
+        // Send buffer back to its idle size means the peer has acknowledged the whole response
+        if (!conn.client.connected() || conn.client.availableForWrite() >= conn.idleSendBuffer ||
+            now - conn.closeStarted >= HTTP_CLOSE_TIMEOUT_MS) {
+            closeHttpConnection(slot);
+        }
+        return;
+    }
+    if (!conn.client.connected() && conn.client.available() == 0) {
+        closeHttpConnection(slot);
+        return;
+    }
+    
+    if (conn.state == HttpConnectionState::EVENTS) {
+        pumpEventStream(slot);
+        return;
+    }
+    
+    // A body from flash goes out as fast as the send buffer drains; requests pipelined
+    // behind it wait in the socket so responses stay in order
+    if (conn.state == HttpConnectionState::SEND) {
+        int space = conn.client.availableForWrite();
+        if (space > 0) {
+            size_t n = conn.client.write(conn.sendData, min((uint32_t)space, conn.sendRemaining));
+            conn.sendData += n;
+            conn.sendRemaining -= n;
+            if (n > 0) conn.lastActivity = now;
+        }
+        if (conn.sendRemaining > 0) {
+            if (now - conn.lastActivity >= HTTP_REQUEST_TIMEOUT_MS) {
+                httpServerStats.timeouts++;
+                closeHttpConnection(slot);
+            }
+            return;
+        }
+        if (!conn.keepAlive) {
+            finishHttpConnection(slot);
+            return;
+        }
+        conn.state = HttpConnectionState::HEAD;
+        conn.requestStarted = now;
+    }
+    
+    for (int handled = 0; handled < HTTP_MAX_REQUESTS_PER_PASS; handled++) {
+        if (conn.state == HttpConnectionState::HEAD) {
+            int space = HTTP_HEAD_BUFFER - conn.headLength;
+            int available = conn.client.available();
+            if (space > 0 && available > 0) {
+                int n = conn.client.read((uint8_t*)conn.head + conn.headLength, min(space, available));
+                if (n > 0) {
+                    if (conn.headLength == 0) conn.requestStarted = now;
+                    conn.headLength += n;
+                    conn.lastActivity = now;
+                }
+            }
+            
+            int headEnd = parseHttpHead(conn);
+            if (headEnd < 0) {
+                rejectHttpRequest(slot, -headEnd);
+                return;
+            }
+            if (headEnd == 0) {
+                if (conn.headLength >= HTTP_HEAD_BUFFER) {
+                    rejectHttpRequest(slot, 431);
+                } else if (conn.headLength == 0 && now - conn.lastActivity >= HTTP_KEEPALIVE_TIMEOUT_MS) {
+                    httpServerStats.timeouts++;
+                    closeHttpConnection(slot);
+                } else if (conn.headLength > 0 && now - conn.requestStarted >= HTTP_REQUEST_TIMEOUT_MS) {
+                    httpServerStats.timeouts++;
+                    rejectHttpRequest(slot, 408);
+                }
+                return;
+            }
+            consumeHttpHead(conn, headEnd);
+            
+            if (conn.contentLength == 0) {
+                dispatchHttpRequest(slot, "");
+                if (conn.state != HttpConnectionState::HEAD) return;
+                continue;
+            }
+            conn.bodyLength = 0;
+            conn.state = HttpConnectionState::BODY;
         }
         
-        Serial.print("Client Connected - Free RAM: ");
-        Serial.println(rp2040.getFreeHeap());
-        
-        String request = "";
-        String method = "";
-        String path = "";
-        String body = "";
-        bool inBody = false;
-        int contentLength = 0;
-
-        // Read the HTTP request headers
-        while (client.connected() && client.available()) {
-            String line = client.readStringUntil('\n');
-            line.trim();
-
-            if (line.length() == 0) {
-                inBody = true;
-                break; // End of headers
-            }
-            if (request.length() == 0) {
-                // First line: method and path
-                int firstSpace = line.indexOf(' ');
-                int secondSpace = line.indexOf(' ', firstSpace + 1);
-                if (firstSpace > 0 && secondSpace > firstSpace) {
-                    method = line.substring(0, firstSpace);
-                    String fullPath = line.substring(firstSpace + 1, secondSpace);
-                    // Strip query string if present
-                    int queryPos = fullPath.indexOf('?');
-                    if (queryPos > 0) {
-                        path = fullPath.substring(0, queryPos);
-                    } else {
-                        path = fullPath;
-                    }
+        // Body: one connection at a time fills httpBody; others leave theirs in the socket
+        if (httpBodyOwner != slot) {
+            if (httpBodyOwner >= 0) {
+                if (now - conn.requestStarted >= HTTP_REQUEST_TIMEOUT_MS) {
+                    httpServerStats.timeouts++;
+                    rejectHttpRequest(slot, 408);
+                }
+                return;
+            }
+            httpBodyOwner = slot;
+            int buffered = min((uint32_t)conn.headLength, conn.contentLength);
+            memcpy(httpBody, conn.head, buffered);
+            consumeHttpHead(conn, buffered);
+            conn.bodyLength = buffered;
+        }
+        if (conn.bodyLength < conn.contentLength) {
+            int available = conn.client.available();
+            if (available > 0) {
+                int n = conn.client.read((uint8_t*)httpBody + conn.bodyLength, min((uint32_t)available, conn.contentLength - conn.bodyLength));
+                if (n > 0) {
+                    conn.bodyLength += n;
+                    conn.lastActivity = now;
                 }
-                request = line;
-                Serial.println("HTTP Request: " + method + " " + path);
             }
-            if (line.startsWith("Content-Length:")) {
-                contentLength = line.substring(15).toInt();
+            if (conn.bodyLength < conn.contentLength) {
+                if (now - conn.requestStarted >= HTTP_REQUEST_TIMEOUT_MS) {
+                    httpServerStats.timeouts++;
+                    rejectHttpRequest(slot, 408);
+                }
+                return;
             }
         }
+        httpBody[conn.contentLength] = '\0';
+        dispatchHttpRequest(slot, httpBody);
+        if (httpBodyOwner == slot) httpBodyOwner = -1;
+        if (conn.state != HttpConnectionState::HEAD) return;
+    }
+}
 
-        // Read body if present
-        if (inBody && contentLength > 0) {
-            char bodyBuffer[contentLength + 1];
-            int bytesRead = client.readBytes(bodyBuffer, contentLength);
-            bodyBuffer[bytesRead] = '\0';
-            body = String(bodyBuffer);
+// Slot for a new connection: a free one, else the longest idle keep-alive connection.
+// With neither, the connection is left in the listen queue until one frees up.
+int findHttpSlot() {
+    unsigned long now = millis();
+    int idleSlot = -1;
+    for (int i = 0; i < MAX_HTTP_CONNECTIONS; i++) {
+        HttpConnection& conn = httpConnections[i];
+        if (conn.state == HttpConnectionState::FREE) return i;
+        if (conn.state != HttpConnectionState::HEAD || conn.headLength > 0) continue;
+        if (now - conn.lastActivity < HTTP_EVICT_MIN_IDLE_MS) continue;
+        if (idleSlot < 0 || now - conn.lastActivity > now - httpConnections[idleSlot].lastActivity) {
+            idleSlot = i;
         }
+    }
+    return idleSlot;
+}
 
-        // Log HTTP request for network monitoring
-        String remoteIP = client.remoteIP().toString();
-        String localIP = eth.localIP().toString() + ":" + String(HTTP_PORT);
-        String requestData = method + " " + path;
-        if (body.length() > 0) {
-            requestData += " (Body: " + body.substring(0, min(50, (int)body.length())) + (body.length() > 50 ? "..." : "") + ")";
+void pollHttpServer() {
+    int slot = findHttpSlot();
+    if (slot >= 0) {
+        WiFiClient newClient = httpServer.accept();
+        if (newClient) {
+            if (httpConnections[slot].state != HttpConnectionState::FREE) {
+                httpServerStats.evicted++;
+                closeHttpConnection(slot);
+            }
+            HttpConnection& conn = httpConnections[slot];
+            conn.client = newClient;
+            conn.client.setNoDelay(true);  // Headers and body go out as separate writes
+            conn.state = HttpConnectionState::HEAD;
+            conn.headLength = 0;
+            conn.keepAlive = false;
+            conn.idleSendBuffer = conn.client.availableForWrite();
+            conn.lastActivity = millis();
+            conn.requestStarted = conn.lastActivity;
+            conn.requests = 0;
+            httpServerStats.accepted++;
+            
+            uint8_t open = 0;
+            for (int i = 0; i < MAX_HTTP_CONNECTIONS; i++) {
+                if (httpConnections[i].state != HttpConnectionState::FREE) open++;
+            }
+            if (open > httpServerStats.peak) httpServerStats.peak = open;
         }
-        logNetworkTransaction("HTTP", "RX", localIP, remoteIP, requestData);
-
-        // Route the request to existing handlers
-        Serial.println("Routing request...");
-        Serial.println("DEBUG: Method='" + method + "' Path='" + path + "'");
-        routeRequest(client, method, path, body);
-        delay(50);  // Give W5500 time to buffer response
-        client.stop();
-        Serial.println("=== WEB CLIENT DISCONNECTED ===");
+    }
+    
+    for (int i = 0; i < MAX_HTTP_CONNECTIONS; i++) {
+        if (httpConnections[i].state != HttpConnectionState::FREE) serviceHttpConnection(i);
     }
 }
 
 // Forward declarations
 void sendJSONPinMap(WiFiClient& client);
 void sendJSONSensorPinStatus(WiFiClient& client);
+void sendJSONOneWireDevices(WiFiClient& client);
+void sendJSONModbusLayout(WiFiClient& client);
+void sendJSONModbusConnections(WiFiClient& client);
+void sendJSONModbusStats(WiFiClient& client);
+void sendJSONModbusGateway(WiFiClient& client);
 void sendJSON(WiFiClient& client, String json); // Ensure sendJSON is declared
 
 // Implementation: Return available pins for each protocol
@@ -3920,10 +5811,307 @@ void sendJSONSensorPinStatus(WiFiClient& client) {
     serializeJson(doc, response);
     sendJSON(client, response);
 }
+// Implementation: Return the ROM IDs found by the last search on each One-Wire pin
+void sendJSONOneWireDevices(WiFiClient& client) {
+    StaticJsonDocument<4096> doc;
+    JsonArray buses = doc.createNestedArray("buses");
+    
+    pauseSensorCore();  // Search results and assignments are written on core1
+    for (int b = 0; b < MAX_ONEWIRE_BUSES; b++) {
+        const OneWireBus& bus = oneWireBuses[b];
+        if (bus.pin < 0) continue;
+        
+        JsonObject busObj = buses.createNestedObject();
+        busObj["pin"] = bus.pin;
+        busObj["searched"] = bus.searched;
+        JsonArray devices = busObj.createNestedArray("devices");
+        for (int d = 0; d < bus.romCount; d++) {
+            char romHex[17];
+            oneWireRomToHex(bus.roms[d], romHex);
+            JsonObject device = devices.createNestedObject();
+            device["rom"] = romHex;
+            device["family"] = bus.roms[d][0];
+            
+            // Which configured sensor reads this device, if any
+            for (int i = 0; i < numConfiguredSensors; i++) {
+                if (configuredSensors[i].oneWirePin != bus.pin) continue;
+                bool matches = oneWireSensorAddressed[i] ? memcmp(oneWireSensorRom[i], bus.roms[d], 8) == 0 : bus.romCount == 1;
+                if (matches) {
+                    device["sensor"] = configuredSensors[i].name;
+                    break;
+                }
+            }
+        }
+    }
+    resumeSensorCore();
+    
+    String response;
+    serializeJson(doc, response);
+    sendJSON(client, response);
+}
+
+const char* const REGISTER_SOURCE_NAMES[] = {"a", "b", "c", "vibration", "quality", "timestamp"};
+
+// Implementation: Return the compiled input register layout, including the packed block
+void sendJSONModbusLayout(WiFiClient& client) {
+    StaticJsonDocument<8192> doc;
+    doc["input_registers"] = modbusInputRegisterCount;
+    JsonObject packed = doc.createNestedObject("packed");
+    packed["enabled"] = packedRegisterCount > 0;
+    packed["base"] = config.modbusPackedBase;
+    packed["length"] = packedRegisterCount;
+    packed["sensor_count"] = packedSensorCount;
+    packed["uptime_register"] = config.modbusPackedBase;
+    packed["sensor_count_register"] = config.modbusPackedBase + 2;
+    doc["statistics_base"] = MODBUS_DIAG_BASE;
+    doc["conflicts"] = registerMapConflictCount;
+    
+    // Outputs as [register, source, encoding(, feature)] to keep large maps within the document
+    JsonArray sensors = doc.createNestedArray("sensors");
+    for (int i = 0; i < numConfiguredSensors; i++) {
+        if (registerMapCount[i] == 0 && !registerMapConflict[i]) continue;
+        JsonObject sensorObj = sensors.createNestedObject();
+        sensorObj["index"] = i;
+        sensorObj["name"] = configuredSensors[i].name;
+        if (registerMapConflict[i]) {
+            // Left out of the fixed window; "span" is what it would have taken
+            sensorObj["error"] = registerMapConflict[i];
+            sensorObj["register"] = configuredSensors[i].modbusRegister;
+            sensorObj["span"] = sensorRegisterSpan(configuredSensors[i].type, configuredSensors[i].modbusEncoding);
+        }
+        sensorObj["word_order"] = configuredSensors[i].modbusWordSwap ? "low" : "high";
+        sensorObj["byte_swap"] = configuredSensors[i].modbusByteSwap;
+        JsonArray registers = sensorObj.createNestedArray("registers");
+        JsonArray packedRegisters = sensorObj.createNestedArray("packed");
+        for (int e = registerMapStart[i]; e < registerMapStart[i] + registerMapCount[i]; e++) {
+            const RegisterMapEntry& entry = registerMap[e];
+            JsonArray out = (entry.packed ? packedRegisters : registers).createNestedArray();
+            out.add(entry.address);
+            out.add(REGISTER_SOURCE_NAMES[(uint8_t)entry.source]);
+            out.add(registerEncodingName(entry.encoding));
+            if (entry.source == RegisterSource::VIBRATION) out.add(entry.feature);
+        }
+    }
+    if (doc.overflowed()) doc["truncated"] = true;
+    
+    String response;
+    serializeJson(doc, response);
+    sendJSON(client, response);
+}
+
+// Implementation: Return connection pool counters and each open connection
+void sendJSONModbusConnections(WiFiClient& client) {
+    StaticJsonDocument<2048> doc;
+    unsigned long now = millis();
+    doc["max_clients"] = config.modbusMaxClients;
+    doc["idle_timeout"] = config.modbusIdleTimeout;
+    doc["active"] = connectedClients;
+    doc["peak"] = modbusPoolStats.peak;
+    doc["accepted"] = modbusPoolStats.accepted;
+    doc["rejected"] = modbusPoolStats.rejected;
+    doc["evicted"] = modbusPoolStats.evicted;
+    doc["idle_closed"] = modbusPoolStats.idleClosed;
+    doc["disconnected"] = modbusPoolStats.disconnected;
+    
+    JsonArray connections = doc.createNestedArray("connections");
+    for (int i = 0; i < MAX_MODBUS_CLIENTS; i++) {
+        const ModbusClientConnection& conn = modbusClients[i];
+        if (!conn.connected) continue;
+        JsonObject connObj = connections.createNestedObject();
+        connObj["slot"] = i;
+        connObj["ip"] = conn.clientIP.toString();
+        connObj["port"] = conn.clientPort;
+        connObj["age_ms"] = now - conn.connectionTime;
+        connObj["idle_ms"] = now - conn.lastActivity;
+        connObj["requests"] = conn.stats.requests;
+    }
+    
+    String response;
+    serializeJson(doc, response);
+    sendJSON(client, response);
+}
+
+void addLatencySummary(JsonObject obj, const ModbusLatencyHistogram& histogram) {
+    obj["latency_p50_us"] = latencyPercentile(histogram, 0.50f);
+    obj["latency_p99_us"] = latencyPercentile(histogram, 0.99f);
+    obj["latency_max_us"] = histogram.maxUs;
+    obj["latency_mean_us"] = latencyMean(histogram);
+}
+
+void addTrafficStats(JsonObject obj, const ModbusTrafficStats& stats) {
+    obj["requests"] = stats.requests;
+    obj["exceptions"] = stats.exceptions;
+    obj["malformed"] = stats.malformed;
+    obj["no_response"] = stats.noResponse;
+    obj["bytes_in"] = stats.bytesIn;
+    obj["bytes_out"] = stats.bytesOut;
+    addLatencySummary(obj, stats.latency);
+}
+
+// Implementation: Return request counters and receive-to-reply latency by function code and client
+void sendJSONModbusStats(WiFiClient& client) {
+    StaticJsonDocument<8192> doc;
+    JsonArray bounds = doc.createNestedArray("latency_bounds_us");
+    for (int b = 0; b < MODBUS_LATENCY_BUCKETS - 1; b++) bounds.add(MODBUS_LATENCY_BOUNDS_US[b]);
+    
+    JsonObject totals = doc.createNestedObject("totals");
+    addTrafficStats(totals, modbusTotals);
+    JsonArray totalBuckets = totals.createNestedArray("latency_buckets");
+    for (int b = 0; b < MODBUS_LATENCY_BUCKETS; b++) totalBuckets.add(modbusTotals.latency.buckets[b]);
+    
+    JsonArray functions = doc.createNestedArray("functions");
+    for (int f = 0; f < MODBUS_STAT_FUNCTIONS; f++) {
+        const ModbusFunctionStats& fs = modbusFunctionStats[f];
+        if (fs.requests == 0) continue;
+        JsonObject fnObj = functions.createNestedObject();
+        if (MODBUS_STAT_FUNCTION_CODES[f]) fnObj["function"] = MODBUS_STAT_FUNCTION_CODES[f];
+        else fnObj["function"] = "other";
+        fnObj["requests"] = fs.requests;
+        fnObj["exceptions"] = fs.exceptions;
+        addLatencySummary(fnObj, fs.latency);
+        JsonArray buckets = fnObj.createNestedArray("latency_buckets");
+        for (int b = 0; b < MODBUS_LATENCY_BUCKETS; b++) buckets.add(fs.latency.buckets[b]);
+    }
+    
+    JsonArray clients = doc.createNestedArray("clients");
+    for (int i = 0; i < MAX_MODBUS_CLIENTS; i++) {
+        if (!modbusClients[i].connected) continue;
+        JsonObject clientObj = clients.createNestedObject();
+        clientObj["slot"] = i;
+        clientObj["ip"] = modbusClients[i].clientIP.toString();
+        addTrafficStats(clientObj, modbusClients[i].stats);
+    }
+    
+    JsonObject rtu = doc.createNestedObject("rtu");  // RS485 server, also counted in totals/functions
+    rtu["active"] = modbusRtu.port >= 0;
+    rtu["unit_id"] = config.modbusRtuUnitId;
+    rtu["t35_us"] = modbusRtu.t35Us;
+    rtu["frames"] = modbusRtuStats.frames;
+    rtu["other_unit"] = modbusRtuStats.otherUnit;
+    rtu["overruns"] = modbusRtuStats.overruns;
+    rtu["line_errors"] = modbusRtuStats.lineErrors;
+    addTrafficStats(rtu, modbusRtuStats.traffic);
+    rtu["gateway"] = modbusRtu.gateway;  // Master mode: traffic above stays zero, see /api/modbus/gateway
+    
+    JsonObject coilProcessing = doc.createNestedObject("coil_processing");  // FC05/FC15 first byte read to output written
+    coilProcessing["writes"] = coilProcessingLatency.count;
+    addLatencySummary(coilProcessing, coilProcessingLatency);
+    JsonArray coilBuckets = coilProcessing.createNestedArray("latency_buckets");
+    for (int b = 0; b < MODBUS_LATENCY_BUCKETS; b++) coilBuckets.add(coilProcessingLatency.buckets[b]);
+    
+    JsonObject diagnostics = doc.createNestedObject("diagnostics");  // FC08 counters
+    diagnostics["bus_messages"] = modbusDiagCounters.busMessages;
+    diagnostics["comm_errors"] = modbusDiagCounters.commErrors;
+    diagnostics["exceptions"] = modbusDiagCounters.exceptions;
+    diagnostics["server_messages"] = modbusDiagCounters.serverMessages;
+    diagnostics["no_response"] = modbusDiagCounters.noResponse;
+    doc["register_base"] = MODBUS_DIAG_BASE;
+    if (doc.overflowed()) doc["truncated"] = true;
+    
+    String response;
+    serializeJson(doc, response);
+    sendJSON(client, response);
+}
+
+// Gateway poll list, the coalesced reads it compiles to and their last result
+void sendJSONModbusGateway(WiFiClient& client) {
+    static const char* const STATUS_NAMES[] = {"pending", "ok", "timeout", "exception", "invalid"};
+    StaticJsonDocument<8192> doc;
+    doc["active"] = modbusRtu.port >= 0 && modbusRtu.gateway;
+    doc["local_base"] = MODBUS_GATEWAY_BASE;
+    doc["local_end"] = MODBUS_GATEWAY_END - 1;
+    doc["responseTimeoutMs"] = gatewayConfig.responseTimeoutMs;
+    
+    JsonArray polls = doc.createNestedArray("polls");
+    for (int i = 0; i < gatewayConfig.pollCount; i++) {
+        const GatewayPoll& poll = gatewayConfig.polls[i];
+        JsonObject entry = polls.createNestedObject();
+        entry["unitId"] = poll.unitId;
+        entry["function"] = poll.function;
+        entry["remoteAddress"] = poll.remoteAddress;
+        entry["count"] = poll.count;
+        entry["localAddress"] = poll.localAddress;
+        entry["intervalMs"] = poll.intervalMs;
+    }
+    
+    JsonArray reads = doc.createNestedArray("reads");
+    for (int r = 0; r < modbusGateway.readCount; r++) {
+        const GatewayRead& read = modbusGateway.reads[r];
+        JsonObject readObj = reads.createNestedObject();
+        readObj["unit_id"] = read.unitId;
+        readObj["function"] = read.function;
+        readObj["address"] = read.address;
+        readObj["count"] = read.count;
+        readObj["interval_ms"] = read.intervalMs;
+        JsonArray members = readObj.createNestedArray("polls");
+        for (int p = 0; p < gatewayConfig.pollCount; p++) {
+            if (read.polls & (1 << p)) members.add(p);
+        }
+        readObj["responses"] = read.responses;
+        readObj["failures"] = read.failures;
+        readObj["status"] = STATUS_NAMES[(int)read.status];
+        if (read.status == GatewayStatus::EXCEPTION) readObj["exception"] = read.exception;
+    }
+    
+    JsonObject stats = doc.createNestedObject("stats");
+    stats["requests"] = modbusGatewayStats.requests;
+    stats["responses"] = modbusGatewayStats.responses;
+    stats["timeouts"] = modbusGatewayStats.timeouts;
+    stats["exceptions"] = modbusGatewayStats.exceptions;
+    stats["invalid"] = modbusGatewayStats.invalid;
+    stats["other_unit"] = modbusGatewayStats.otherUnit;
+    stats["writes"] = modbusGatewayStats.writes;
+    stats["write_failures"] = modbusGatewayStats.writeFailures;
+    stats["writes_dropped"] = modbusGatewayStats.writesDropped;
+    stats["writes_queued"] = modbusGateway.writeCount;
+    if (doc.overflowed()) doc["truncated"] = true;
+    
+    String response;
+    serializeJson(doc, response);
+    sendJSON(client, response);
+}
+
+// Replace the gateway poll list; the link restarts so reads are recompiled
+void handlePOSTModbusGateway(WiFiClient& client, String body) {
+    StaticJsonDocument<4096> doc;
+    DeserializationError error = deserializeJson(doc, body);
+    if (error) {
+        client.println("HTTP/1.1 400 Bad Request");
+        client.println("Content-Type: application/json");
+        client.println("Connection: close");
+        client.println();
+        client.println("{\"success\":false,\"error\":\"Invalid JSON\"}");
+        return;
+    }
+    
+    GatewayConfig parsed;
+    const char* gatewayError = parseGatewayConfig(doc.as<JsonObject>(), parsed);
+    if (gatewayError) {
+        client.println("HTTP/1.1 400 Bad Request");
+        client.println("Content-Type: application/json");
+        client.println("Connection: close");
+        client.println();
+        client.println(String("{\"success\":false,\"message\":\"") + gatewayError + "\"}");
+        return;
+    }
+    
+    gatewayConfig = parsed;
+    saveGatewayConfig();
+    if (modbusRtu.port >= 0 && modbusRtu.gateway) openModbusRTU();
+    resizeModbusImage();
+    compileRegisterMap();
+    
+    client.println("HTTP/1.1 200 OK");
+    client.println("Content-Type: application/json");
+    client.println("Connection: close");
+    client.println();
+    client.println("{\"success\":true}");
+}
+
 void sendJSON(WiFiClient& client, String json); // Ensure sendJSON is declared
 
 void sendJSONConfig(WiFiClient& client) {
-    StaticJsonDocument<1024> doc;
+    StaticJsonDocument<2048> doc;
     
     // Network configuration
     doc["dhcpEnabled"] = config.dhcpEnabled;
@@ -3948,6 +6136,20 @@ void sendJSONConfig(WiFiClient& client) {
     
     // Modbus and hostname
     doc["modbusPort"] = config.modbusPort;
+    doc["modbusPackedEnabled"] = config.modbusPackedEnabled;
+    doc["modbusPackedBase"] = config.modbusPackedBase;
+    doc["modbusMaxClients"] = config.modbusMaxClients;
+    doc["modbusIdleTimeout"] = config.modbusIdleTimeout;
+    doc["modbusRtuEnabled"] = config.modbusRtuEnabled;
+    doc["modbusRtuUnitId"] = config.modbusRtuUnitId;
+    doc["modbusRtuBaud"] = config.modbusRtuBaud;
+    doc["modbusRtuFraming"] = config.modbusRtuFraming;
+    doc["modbusRtuTxPin"] = config.modbusRtuTxPin;
+    doc["modbusRtuRxPin"] = config.modbusRtuRxPin;
+    doc["modbusRtuDePin"] = config.modbusRtuDePin;
+    doc["modbusRtuGateway"] = config.modbusRtuGateway;
+    doc["eventInterval"] = config.eventInterval;
+    doc["modbusRtuActive"] = modbusRtu.port >= 0;
     doc["hostname"] = config.hostname;
     
     // Current network status - use string conversion to avoid issues
@@ -3972,7 +6174,8 @@ void routeRequest(WiFiClient& client, String method, String path, String body) {
         client.println("Access-Control-Allow-Origin: *");
         client.println("Access-Control-Allow-Methods: GET, POST, OPTIONS");
         client.println("Access-Control-Allow-Headers: Content-Type");
-        client.println("Connection: close");
+        client.println("Content-Length: 0");
+        client.println(httpConnectionHeader());
         client.println();
         return;
     }
@@ -4007,6 +6210,8 @@ void routeRequest(WiFiClient& client, String method, String path, String body) {
             sendFile(client, "/logo.png", "image/png");
         } else if (path == "/config") {
             sendJSONConfig(client);
+        } else if (path == "/events") {
+            startEventStream(client);
         } else if (path == "/iostatus") {
             Serial.println("DEBUG: Routing to sendJSONIOStatus");
             sendJSONIOStatus(client);
@@ -4021,38 +6226,47 @@ void routeRequest(WiFiClient& client, String method, String path, String body) {
             sendJSONPinMap(client);
         } else if (path == "/api/sensors/status") {
             sendJSONSensorPinStatus(client);
+        } else if (path == "/api/onewire/devices") {
+            sendJSONOneWireDevices(client);
+        } else if (path == "/api/modbus/layout") {
+            sendJSONModbusLayout(client);
+        } else if (path == "/api/modbus/connections") {
+            sendJSONModbusConnections(client);
+        } else if (path == "/api/modbus/stats") {
+            sendJSONModbusStats(client);
+        } else if (path == "/api/modbus/gateway") {
+            sendJSONModbusGateway(client);
         } else if (path == "/terminal/logs") {
-            // Send terminal buffer for bus traffic monitoring
-            StaticJsonDocument<2048> terminalDoc;
-            JsonArray terminalArray = terminalDoc.to<JsonArray>();
-            
-            for (size_t i = 0; i < terminalBuffer.size(); i++) {
-                // Clean each log entry to prevent JSON corruption
-                String cleanEntry = "";
-                for (int j = 0; j < terminalBuffer[i].length(); j++) {
-                    char c = terminalBuffer[i][j];
-                    if (c >= 32 && c <= 126) { // Only printable ASCII
-                        cleanEntry += c;
-                    } else if (c == '\n') {
-                        cleanEntry += "\\n";
-                    } else if (c == '\r') {
-                        cleanEntry += "\\r";
-                    } else if (c == '\t') {
-                        cleanEntry += "\\t";
-                    }
+            // Send terminal buffer for bus traffic monitoring. Each entry is copied out under
+            // the lock, so core1 logging never waits on the socket.
+            ChunkedResponse out(client);
+            out.begin("application/json");
+            out.write('[');
+            char entry[256];
+            for (size_t i = 0; ; i++) {
+                {
+                    TerminalLogLock lock;
+                    if (i >= terminalBuffer.size()) break;
+                    formatTerminalLogLine(terminalBuffer[i], entry, sizeof(entry));
                 }
-                terminalArray.add(cleanEntry);
-            }
-            
-            String response;
-            serializeJson(terminalDoc, response);
-            sendJSON(client, response);
+                if (i > 0) out.write(',');
+                out.printJsonString(entry);
+            }
+            out.write(']');
+            endJSONStream(client, out);
+        } else if (const WebAsset* asset = findWebAsset(path.c_str())) {
+            // Content-hashed names referenced by the embedded index.html
+            sendWebAsset(client, *asset);
         } else {
             Serial.printf("[HTTP 404] No handler for GET %s\n", path.c_str());
             send404(client);
         }
     } else if (method == "POST") {
-
+        // Handlers that reconfigure sensors or drive a sensor bus directly must not
+        // race the sensor engine on core1, so park it for the duration of the request
+        bool parkSensorCore = path == "/sensors/config" || path.startsWith("/api/sensor/") ||
+                              path == "/terminal/command" || path == "/terminal/send-command";
+        if (parkSensorCore) pauseSensorCore();
 
         if (path == "/config") {
             handlePOSTConfig(client, body);
@@ -4072,12 +6286,23 @@ void routeRequest(WiFiClient& client, String method, String path, String body) {
             handlePOSTSensorCalibration(client, body);
         } else if (path == "/api/sensor/poll") {
             handlePOSTSensorPoll(client, body);
+        } else if (path == "/api/modbus/gateway") {
+            handlePOSTModbusGateway(client, body);
+        } else if (path == "/api/onewire/scan") {
+            // Core1 re-runs the ROM search on every configured pin on its next pass
+            oneWireRescanRequested = true;
+            sendJSON(client, "{\"status\":\"scan_scheduled\"}");
+        } else if (path == "/api/onewire/persist") {
+            // Core1 copies each DS18B20's scratchpad (resolution) to its EEPROM on its next pass
+            oneWirePersistRequested = true;
+            sendJSON(client, "{\"status\":\"persist_scheduled\"}");
         } else if (path == "/terminal/command") {
             handlePOSTTerminalCommand(client, body);
         } else if (path == "/terminal/start-watch") {
             // Start watching bus traffic
             StaticJsonDocument<128> doc;
             deserializeJson(doc, body);
+            TerminalLogLock lock;
             watchedPin = doc["pin"].as<String>();
             watchedProtocol = doc["protocol"].as<String>();
             terminalWatchActive = true;
@@ -4104,14 +6329,165 @@ void routeRequest(WiFiClient& client, String method, String path, String body) {
         } else {
             send404(client);
         }
+
+        if (parkSensorCore) resumeSensorCore();
     } else {
         send404(client);
     }
 }
 
+// Embedded copy of a web file, NULL when it is only on LittleFS
+const WebAsset* findWebAsset(const char* path) {
+    for (int i = 0; i < WEB_ASSET_COUNT; i++) {
+        if (strcmp(WEB_ASSETS[i].path, path) == 0) return &WEB_ASSETS[i];
+    }
+    return NULL;
+}
+
+// Embedded asset straight from flash: 304 when the client's copy matches the ETag,
+// otherwise headers here and the body queued for pollHttpServer() to send without copying
+void sendWebAsset(WiFiClient& client, const WebAsset& asset) {
+    if (asset.gzip && !httpExchange.acceptGzip) {
+        serveFileFromFS(client, asset.file, asset.contentType);
+        return;
+    }
+    
+    const char* cacheControl = asset.immutable ? "public, max-age=31536000, immutable" : "no-cache";
+    const char* ifNoneMatch = httpExchange.ifNoneMatch;
+    if (ifNoneMatch && (strcmp(ifNoneMatch, "*") == 0 || strstr(ifNoneMatch, asset.etag))) {
+        client.printf("HTTP/1.1 304 Not Modified\r\nETag: %s\r\nCache-Control: %s\r\nVary: Accept-Encoding\r\n%s\r\n\r\n",
+                      asset.etag, cacheControl, httpConnectionHeader());
+        return;
+    }
+    
+    client.printf("HTTP/1.1 200 OK\r\nContent-Type: %s\r\n%sContent-Length: %lu\r\n"
+                  "ETag: %s\r\nCache-Control: %s\r\nVary: Accept-Encoding\r\n%s\r\n\r\n",
+                  asset.contentType, asset.gzip ? "Content-Encoding: gzip\r\n" : "", (unsigned long)asset.length,
+                  asset.etag, cacheControl, httpConnectionHeader());
+    httpExchange.pendingData = asset.data;
+    httpExchange.pendingLength = asset.length;
+}
+
 // Delegate file serving to sys_init.h helper
 void sendFile(WiFiClient& client, String filename, String contentType) {
-    serveFileFromFS(client, filename, contentType);
+    const WebAsset* asset = findWebAsset(filename.c_str());
+    if (asset) {
+        sendWebAsset(client, *asset);
+    } else {
+        serveFileFromFS(client, filename, contentType);
+    }
+}
+
+// Live values of one sensor; the rest of an /iostatus entry only changes with the configuration
+void fillSensorReadings(JsonObject sensor, int i, const SensorValues& values) {
+    // Actual sensor readings
+    sensor["raw_value"] = values.rawValue;
+    sensor["raw_i2c_data"] = values.rawDataString;
+    
+    // Calibrated output (applying calibration equation)
+    sensor["calibrated_value"] = values.calibratedValue;
+    
+    // Modbus register value (what gets sent to Modbus)
+    sensor["modbus_value"] = values.modbusValue;
+    
+    // Multi-output sensor support (for SHT30 humidity, BME280 pressure, LIS3DH Y/Z, etc.)
+    if (strcmp(configuredSensors[i].type, "SHT30") == 0 && values.rawValueB != 0) {
+        sensor["raw_value_b"] = values.rawValueB;        // Humidity raw
+        sensor["calibrated_value_b"] = values.calibratedValueB;  // Humidity calibrated
+        sensor["modbus_value_b"] = values.modbusValueB;  // Humidity modbus (register+1)
+        sensor["modbus_register_b"] = registerAddressFor(i, RegisterSource::VALUE_B);
+    }
+    else if (strcmp(configuredSensors[i].type, "LIS3DH") == 0 || strcmp(configuredSensors[i].type, "LIS3DH_SPI") == 0) {
+        // LIS3DH: Y-axis (register+1)
+        if (values.rawValueB != 0) {
+            sensor["raw_value_b"] = values.rawValueB;        // Y-axis raw
+            sensor["calibrated_value_b"] = values.calibratedValueB;  // Y-axis calibrated
+            sensor["modbus_value_b"] = values.modbusValueB;  // Y-axis modbus (register+1)
+            sensor["modbus_register_b"] = registerAddressFor(i, RegisterSource::VALUE_B);
+        }
+        // LIS3DH: Z-axis (register+2)
+        if (values.rawValueC != 0) {
+            sensor["raw_value_c"] = values.rawValueC;        // Z-axis raw
+            sensor["calibrated_value_c"] = values.calibratedValueC;  // Z-axis calibrated
+            sensor["modbus_value_c"] = values.modbusValueC;  // Z-axis modbus (register+2)
+            sensor["modbus_register_c"] = registerAddressFor(i, RegisterSource::VALUE_C);
+        }
+        // Vibration features over the last window (9 registers after X/Y/Z)
+        if (strcmp(configuredSensors[i].type, "LIS3DH") == 0) {
+            JsonObject vibration = sensor.createNestedObject("vibration");
+            const char* axes[] = {"x", "y", "z"};
+            for (int axis = 0; axis < 3; axis++) {
+                JsonObject a = vibration.createNestedObject(axes[axis]);
+                a["rms_mg"] = values.vibrationRegisters[axis];
+                a["peak_mg"] = values.vibrationRegisters[3 + axis];
+                a["crest"] = values.vibrationRegisters[6 + axis] / 100.0;
+            }
+            vibration["modbus_register"] = registerAddressFor(i, RegisterSource::VIBRATION, 0);
+        }
+    }
+    else if (strcmp(configuredSensors[i].type, "BME280") == 0) {
+        // BME280: Humidity (register+1), Pressure (register+2)
+        if (values.rawValueB != 0) {
+            sensor["raw_value_b"] = values.rawValueB;        // Humidity raw
+            sensor["calibrated_value_b"] = values.calibratedValueB;  // Humidity calibrated
+            sensor["modbus_value_b"] = values.modbusValueB;  // Humidity modbus (register+1)
+            sensor["modbus_register_b"] = registerAddressFor(i, RegisterSource::VALUE_B);
+        }
+        if (values.rawValueC != 0) {
+            sensor["raw_value_c"] = values.rawValueC;        // Pressure raw
+            sensor["calibrated_value_c"] = values.calibratedValueC;  // Pressure calibrated
+            sensor["modbus_value_c"] = values.modbusValueC;  // Pressure modbus (register+2)
+            sensor["modbus_register_c"] = registerAddressFor(i, RegisterSource::VALUE_C);
+        }
+    }
+    
+    // Include last read time for status
+    sensor["last_read_time"] = values.lastReadTime;
+}
+
+// One configured_sensors entry of /iostatus (also the first /events "sensor" event after a reset)
+void fillIOStatusSensor(JsonObject sensor, int i, const SensorValues& values) {
+    sensor["name"] = configuredSensors[i].name;
+    sensor["type"] = configuredSensors[i].type;
+    sensor["protocol"] = configuredSensors[i].protocol;
+    sensor["i2c_address"] = configuredSensors[i].i2cAddress;
+    sensor["modbus_register"] = configuredSensors[i].modbusRegister;
+    
+    fillSensorReadings(sensor, i, values);
+    
+    // Include calibration info for dataflow display
+    sensor["calibration_offset"] = configuredSensors[i].calibrationOffset;
+    sensor["calibration_slope"] = configuredSensors[i].calibrationSlope;
+    if (strlen(configuredSensors[i].calibrationExpression) > 0) {
+        sensor["calibration_expression"] = configuredSensors[i].calibrationExpression;
+    }
+    
+    // Multi-output calibration info
+    if (configuredSensors[i].calibrationSlopeB != 1.0 || configuredSensors[i].calibrationOffsetB != 0.0) {
+        sensor["calibration_offset_b"] = configuredSensors[i].calibrationOffsetB;
+        sensor["calibration_slope_b"] = configuredSensors[i].calibrationSlopeB;
+    }
+    if (strlen(configuredSensors[i].calibrationExpressionB) > 0) {
+        sensor["calibration_expression_b"] = configuredSensors[i].calibrationExpressionB;
+    }
+    if (strlen(configuredSensors[i].calibrationExpressionC) > 0) {
+        sensor["calibration_expression_c"] = configuredSensors[i].calibrationExpressionC;
+    }
+    
+    // Include pin assignments for reference
+    if (String(configuredSensors[i].protocol).equalsIgnoreCase("I2C")) {
+        sensor["sda_pin"] = configuredSensors[i].sdaPin;
+        sensor["scl_pin"] = configuredSensors[i].sclPin;
+    } else if (String(configuredSensors[i].protocol).equalsIgnoreCase("Analog Voltage")) {
+        sensor["analog_pin"] = configuredSensors[i].analogPin;
+    } else if (String(configuredSensors[i].protocol).equalsIgnoreCase("Digital Counter")) {
+        sensor["digital_pin"] = configuredSensors[i].digitalPin;
+    } else if (String(configuredSensors[i].protocol).equalsIgnoreCase("One-Wire")) {
+        sensor["onewire_pin"] = configuredSensors[i].oneWirePin;
+    } else if (String(configuredSensors[i].protocol).equalsIgnoreCase("UART")) {
+        sensor["uart_tx_pin"] = configuredSensors[i].uartTxPin;
+        sensor["uart_rx_pin"] = configuredSensors[i].uartRxPin;
+    }
 }
 
 void sendJSONIOStatus(WiFiClient& client) {
@@ -4138,130 +6514,322 @@ void sendJSONIOStatus(WiFiClient& client) {
         return;
     }
     
-    StaticJsonDocument<2048> doc;
-    
-    JsonArray dInArray = doc.createNestedArray("dIn");
-    for (int i = 0; i < 8; i++) {
-        dInArray.add(ioStatus.dIn[i]);
-    }
+    // ?since=N&boot=B: only what changed after sequence N of boot B, 304 when nothing did
+    trackIOChanges();
+    const char* since = queryParam(httpExchange.query, "since");
+    const char* boot = queryParam(httpExchange.query, "boot");
+    if (since && boot) {
+        char* sinceEnd;
+        char* bootEnd;
+        uint32_t sequence = strtoul(since, &sinceEnd, 10);
+        uint32_t bootId = strtoul(boot, &bootEnd, 16);
+        // Another boot, or before the last sensor reload: the full snapshot below
+        if (sinceEnd != since && bootEnd != boot && bootId == ioChanges.boot &&
+            sequence >= ioChanges.resetSequence && sequence <= ioChanges.sequence) {
+            sendJSONIOStatusDelta(client, sequence);
+            return;
+        }
+    }
+    
+    // Streamed: one sensor at a time is built in sensorDoc and serialised into the socket
+    ChunkedResponse out(client);
+    out.begin("application/json");
+    
+    out.printf("{\"boot\":\"%08lx\",\"sequence\":%lu,", (unsigned long)ioChanges.boot, (unsigned long)ioChanges.sequence);
+    printIOBits(out, "dIn", ioStatus.dIn);
+    out.write(',');
+    printIOBits(out, "dOut", ioStatus.dOut);
+    out.write(',');
+    printIOBits(out, "dInLatched", ioStatus.dInLatched);
+    out.write(',');
+    out.printf("\"aIn\":[%u,%u,%u],", ioStatus.aIn[0], ioStatus.aIn[1], ioStatus.aIn[2]);
+    
+    // Add sensor data for sensor dataflow
+    out.print("\"configured_sensors\":[");
+    int written = 0;
+    for (int i = 0; i < numConfiguredSensors; i++) {
+        if (configuredSensors[i].enabled) {
+            SensorValues values;
+            readSensorValues(i, values);
+            StaticJsonDocument<2048> sensorDoc;
+            JsonObject sensor = sensorDoc.to<JsonObject>();
+            fillIOStatusSensor(sensor, i, values);
+            sensor["index"] = i;
+            sensor["seq"] = ioChanges.sensorSequence[i];
+            
+            if (sensorDoc.overflowed()) sensor["truncated"] = true;
+            if (written++ > 0) out.write(',');
+            serializeJson(sensorDoc, out);
+        }
+    }
+    out.print("]}");
+    endJSONStream(client, out);
+}
+
+// Value of name=value in a query string (ends at '&' or '\0'), NULL when absent
+const char* queryParam(const char* query, const char* name) {
+    size_t length = strlen(name);
+    const char* p = query;
+    while (p && *p) {
+        if (strncmp(p, name, length) == 0 && p[length] == '=') return p + length + 1;
+        p = strchr(p, '&');
+        if (p) p++;
+    }
+    return NULL;
+}
+
+// Stamp every /iostatus value that differs from the previous pass with the next sequence.
+// Runs when /iostatus is requested; values that changed and changed back in between
+// keep their old stamp, which is what a client holding that value needs.
+void trackIOChanges() {
+    IOChangeTracker& t = ioChanges;
+    uint32_t stamp = t.sequence + 1;
+    bool reset = !t.primed || t.sensorGeneration != sensorConfigGeneration;
+    bool changed = reset;
+    if (reset) {
+        if (!t.primed) t.boot = rp2040.hwrand32();
+        t.primed = true;
+        t.sensorGeneration = sensorConfigGeneration;
+        t.resetSequence = stamp;
+    }
+    
+    uint8_t dIn = ioStatus.dIn;
+    uint8_t dOut = ioStatus.dOut;
+    uint8_t dInLatched = ioStatus.dInLatched;
+    for (int ch = 0; ch < 8; ch++) {
+        if (reset || ioBit(dIn ^ t.dIn, ch)) { t.dInSequence[ch] = stamp; changed = true; }
+        if (reset || ioBit(dOut ^ t.dOut, ch)) { t.dOutSequence[ch] = stamp; changed = true; }
+        if (reset || ioBit(dInLatched ^ t.dInLatched, ch)) { t.dInLatchedSequence[ch] = stamp; changed = true; }
+    }
+    t.dIn = dIn;
+    t.dOut = dOut;
+    t.dInLatched = dInLatched;
+    for (int ch = 0; ch < 3; ch++) {
+        uint16_t value = ioStatus.aIn[ch];
+        if (reset || value != t.aIn[ch]) {
+            t.aIn[ch] = value;
+            t.aInSequence[ch] = stamp;
+            changed = true;
+        }
+    }
+    
+    for (int i = 0; i < numConfiguredSensors; i++) {
+        uint32_t snapshot = sensorSnapshots[i].sequence;
+        if (reset || snapshot != t.sensorSnapshot[i]) {
+            t.sensorSnapshot[i] = snapshot;
+            t.sensorSequence[i] = stamp;
+            changed = true;
+        }
+    }
+    
+    if (changed) t.sequence = stamp;
+}
+
+// "name":[{"channel":c,"value":v,"seq":s},...] for the channels stamped after since
+void printIOBitChanges(Print& out, const char* name, uint8_t bits, const uint32_t* sequences, uint32_t since) {
+    out.printf(",\"%s\":[", name);
+    bool first = true;
+    for (int ch = 0; ch < 8; ch++) {
+        if (sequences[ch] <= since) continue;
+        out.printf("%s{\"channel\":%d,\"value\":%s,\"seq\":%lu}", first ? "" : ",", ch,
+                   ioBit(bits, ch) ? "true" : "false", (unsigned long)sequences[ch]);
+        first = false;
+    }
+    out.write(']');
+}
+
+// GET /iostatus?since=N once trackIOChanges() has run: the values stamped after N, sensors
+// with their readings only (names, calibration and pins are unchanged since the last reset)
+void sendJSONIOStatusDelta(WiFiClient& client, uint32_t since) {
+    if (since == ioChanges.sequence) {
+        client.printf("HTTP/1.1 304 Not Modified\r\nAccess-Control-Allow-Origin: *\r\n%s\r\n\r\n",
+                      httpConnectionHeader());
+        return;
+    }
+    
+    ChunkedResponse out(client);
+    out.begin("application/json");
+    out.printf("{\"boot\":\"%08lx\",\"sequence\":%lu,\"since\":%lu", (unsigned long)ioChanges.boot,
+               (unsigned long)ioChanges.sequence, (unsigned long)since);
+    printIOBitChanges(out, "dIn", ioChanges.dIn, ioChanges.dInSequence, since);
+    printIOBitChanges(out, "dOut", ioChanges.dOut, ioChanges.dOutSequence, since);
+    printIOBitChanges(out, "dInLatched", ioChanges.dInLatched, ioChanges.dInLatchedSequence, since);
+    
+    out.print(",\"aIn\":[");
+    bool first = true;
+    for (int ch = 0; ch < 3; ch++) {
+        if (ioChanges.aInSequence[ch] <= since) continue;
+        out.printf("%s{\"channel\":%d,\"value\":%u,\"seq\":%lu}", first ? "" : ",", ch,
+                   ioChanges.aIn[ch], (unsigned long)ioChanges.aInSequence[ch]);
+        first = false;
+    }
+    
+    out.print("],\"configured_sensors\":[");
+    first = true;
+    for (int i = 0; i < numConfiguredSensors; i++) {
+        if (!configuredSensors[i].enabled || ioChanges.sensorSequence[i] <= since) continue;
+        SensorValues values;
+        readSensorValues(i, values);
+        StaticJsonDocument<1024> sensorDoc;
+        JsonObject sensor = sensorDoc.to<JsonObject>();
+        sensor["index"] = i;
+        sensor["seq"] = ioChanges.sensorSequence[i];
+        fillSensorReadings(sensor, i, values);
+        
+        if (sensorDoc.overflowed()) sensor["truncated"] = true;
+        if (!first) out.write(',');
+        serializeJson(sensorDoc, out);
+        first = false;
+    }
+    out.print("]}");
+    endJSONStream(client, out);
+}
+
+// "name":[b0,...,b7] for one channel bitfield
+void printIOBits(Print& out, const char* name, uint8_t bits) {
+    out.printf("\"%s\":[", name);
+    for (int i = 0; i < 8; i++) {
+        if (i > 0) out.write(',');
+        out.print(ioBit(bits, i) ? "true" : "false");
+    }
+    out.write(']');
+}
+
+// GET /events: Server-Sent Events. The headers go out here; pollHttpServer() then keeps
+// the connection in EVENTS and pushes changes every config.eventInterval ms.
+void startEventStream(WiFiClient& client) {
+    int streams = 0;
+    for (int i = 0; i < MAX_HTTP_CONNECTIONS; i++) {
+        if (httpConnections[i].state == HttpConnectionState::EVENTS) streams++;
+    }
+    if (streams >= MAX_EVENT_STREAMS) {
+        client.println("HTTP/1.1 503 Service Unavailable");
+        client.println("Content-Type: application/json");
+        client.println("Connection: close");
+        client.println();
+        client.println("{\"success\":false,\"message\":\"Too many event streams\"}");
+        return;
+    }
+    
+    client.print("HTTP/1.1 200 OK\r\n"
+                 "Content-Type: text/event-stream\r\n"
+                 "Cache-Control: no-cache\r\n"
+                 "Access-Control-Allow-Origin: *\r\n"
+                 "\r\n"
+                 "retry: 2000\n\n");
+    httpExchange.eventStream = true;
+}
+
+// Send what changed since the last push: "io" with the changed channel groups,
+// one "sensor" per sensor with a new reading, one "log" per new terminal line.
+// "reset" (and everything) after the sensor list was reloaded. Nothing is composed
+// while the socket still holds the previous push, so a slow client gets fewer,
+// larger updates instead of backing up the loop.
+void pumpEventStream(int slot) {
+    HttpConnection& conn = httpConnections[slot];
+    EventStreamState& ev = conn.events;
+    unsigned long now = millis();
+    if (now - ev.lastPush < config.eventInterval) return;
+    
+    size_t space = conn.client.availableForWrite();
+    if (space < HTTP_CHUNK_SIZE) {
+        if (now - ev.lastWrite >= HTTP_KEEPALIVE_TIMEOUT_MS) {
+            httpServerStats.timeouts++;
+            finishHttpConnection(slot);
+        }
+        return;
+    }
+    ev.lastPush = now;
+    
+    ChunkedResponse out(conn.client);  // Unframed: the stream ends with the connection
     
-    JsonArray dOutArray = doc.createNestedArray("dOut");
-    for (int i = 0; i < 8; i++) {
-        dOutArray.add(ioStatus.dOut[i]);
+    if (ev.sensorGeneration != sensorConfigGeneration) {
+        ev.sensorGeneration = sensorConfigGeneration;
+        for (int i = 0; i < MAX_SENSORS; i++) ev.sensorSequence[i] = UINT32_MAX;  // Never a published (even) sequence
+        out.print("event: reset\ndata: {}\n\n");
     }
     
-    JsonArray aInArray = doc.createNestedArray("aIn");
-    for (int i = 0; i < 3; i++) {
-        aInArray.add(ioStatus.aIn[i]);
+    uint8_t dIn = ioStatus.dIn;
+    uint8_t dOut = ioStatus.dOut;
+    uint8_t dInLatched = ioStatus.dInLatched;
+    bool aInChanged = memcmp(ev.aIn, ioStatus.aIn, sizeof(ev.aIn)) != 0;
+    if (!ev.primed || dIn != ev.dIn || dOut != ev.dOut || dInLatched != ev.dInLatched || aInChanged) {
+        out.print("event: io\ndata: {");
+        bool first = true;
+        if (!ev.primed || dIn != ev.dIn) {
+            printIOBits(out, "dIn", dIn);
+            first = false;
+        }
+        if (!ev.primed || dOut != ev.dOut) {
+            if (!first) out.write(',');
+            printIOBits(out, "dOut", dOut);
+            first = false;
+        }
+        if (!ev.primed || dInLatched != ev.dInLatched) {
+            if (!first) out.write(',');
+            printIOBits(out, "dInLatched", dInLatched);
+            first = false;
+        }
+        if (!ev.primed || aInChanged) {
+            if (!first) out.write(',');
+            out.printf("\"aIn\":[%u,%u,%u]", ioStatus.aIn[0], ioStatus.aIn[1], ioStatus.aIn[2]);
+            memcpy(ev.aIn, ioStatus.aIn, sizeof(ev.aIn));
+        }
+        out.print("}\n\n");
+        ev.dIn = dIn;
+        ev.dOut = dOut;
+        ev.dInLatched = dInLatched;
+        ev.primed = true;
     }
     
-    JsonArray dInLatchedArray = doc.createNestedArray("dInLatched");
-    for (int i = 0; i < 8; i++) {
-        dInLatchedArray.add(ioStatus.dInLatched[i]);
+    // Sensors and log lines that do not fit this push stay pending for the next one
+    for (int i = 0; i < numConfiguredSensors; i++) {
+        uint32_t sequence = sensorSnapshots[i].sequence;
+        if (!configuredSensors[i].enabled || sequence == ev.sensorSequence[i]) continue;
+        if (out.total + out.length + HTTP_CHUNK_SIZE / 2 > space) break;
+        
+        SensorValues values;
+        readSensorValues(i, values);
+        StaticJsonDocument<2048> sensorDoc;
+        JsonObject sensor = sensorDoc.to<JsonObject>();
+        sensor["index"] = i;
+        // The whole entry once after a reset, then only the readings
+        if (ev.sensorSequence[i] == UINT32_MAX) {
+            fillIOStatusSensor(sensor, i, values);
+        } else {
+            fillSensorReadings(sensor, i, values);
+        }
+        if (sensorDoc.overflowed()) sensor["truncated"] = true;
+        
+        out.print("event: sensor\ndata: ");
+        serializeJson(sensorDoc, out);
+        out.print("\n\n");
+        ev.sensorSequence[i] = sequence;
     }
     
-    // Add sensor data for sensor dataflow
-    JsonArray sensorsArray = doc.createNestedArray("configured_sensors");
-    for (int i = 0; i < numConfiguredSensors; i++) {
-        if (configuredSensors[i].enabled) {
-            JsonObject sensor = sensorsArray.createNestedObject();
-            sensor["name"] = configuredSensors[i].name;
-            sensor["type"] = configuredSensors[i].type;
-            sensor["protocol"] = configuredSensors[i].protocol;
-            sensor["i2c_address"] = configuredSensors[i].i2cAddress;
-            sensor["modbus_register"] = configuredSensors[i].modbusRegister;
-            
-            // Actual sensor readings
-            sensor["raw_value"] = configuredSensors[i].rawValue;
-            sensor["raw_i2c_data"] = configuredSensors[i].rawDataString;
-            
-            // Calibrated output (applying calibration equation)
-            sensor["calibrated_value"] = configuredSensors[i].calibratedValue;
-            
-            // Modbus register value (what gets sent to Modbus)
-            sensor["modbus_value"] = configuredSensors[i].modbusValue;
-            
-            // Multi-output sensor support (for SHT30 humidity, BME280 pressure, LIS3DH Y/Z, etc.)
-            if (strcmp(configuredSensors[i].type, "SHT30") == 0 && configuredSensors[i].rawValueB != 0) {
-                sensor["raw_value_b"] = configuredSensors[i].rawValueB;        // Humidity raw
-                sensor["calibrated_value_b"] = configuredSensors[i].calibratedValueB;  // Humidity calibrated
-                sensor["modbus_value_b"] = configuredSensors[i].modbusValueB;  // Humidity modbus (register+1)
-                sensor["modbus_register_b"] = configuredSensors[i].modbusRegister + 1;
-            }
-            else if (strcmp(configuredSensors[i].type, "LIS3DH") == 0 || strcmp(configuredSensors[i].type, "LIS3DH_SPI") == 0) {
-                // LIS3DH: Y-axis (register+1)
-                if (configuredSensors[i].rawValueB != 0) {
-                    sensor["raw_value_b"] = configuredSensors[i].rawValueB;        // Y-axis raw
-                    sensor["calibrated_value_b"] = configuredSensors[i].calibratedValueB;  // Y-axis calibrated
-                    sensor["modbus_value_b"] = configuredSensors[i].modbusValueB;  // Y-axis modbus (register+1)
-                    sensor["modbus_register_b"] = configuredSensors[i].modbusRegister + 1;
-                }
-                // LIS3DH: Z-axis (register+2)
-                if (configuredSensors[i].rawValueC != 0) {
-                    sensor["raw_value_c"] = configuredSensors[i].rawValueC;        // Z-axis raw
-                    sensor["calibrated_value_c"] = configuredSensors[i].calibratedValueC;  // Z-axis calibrated
-                    sensor["modbus_value_c"] = configuredSensors[i].modbusValueC;  // Z-axis modbus (register+2)
-                    sensor["modbus_register_c"] = configuredSensors[i].modbusRegister + 2;
-                }
-            }
-            else if (strcmp(configuredSensors[i].type, "BME280") == 0) {
-                // BME280: Humidity (register+1), Pressure (register+2)
-                if (configuredSensors[i].rawValueB != 0) {
-                    sensor["raw_value_b"] = configuredSensors[i].rawValueB;        // Humidity raw
-                    sensor["calibrated_value_b"] = configuredSensors[i].calibratedValueB;  // Humidity calibrated
-                    sensor["modbus_value_b"] = configuredSensors[i].modbusValueB;  // Humidity modbus (register+1)
-                    sensor["modbus_register_b"] = configuredSensors[i].modbusRegister + 1;
-                }
-                if (configuredSensors[i].rawValueC != 0) {
-                    sensor["raw_value_c"] = configuredSensors[i].rawValueC;        // Pressure raw
-                    sensor["calibrated_value_c"] = configuredSensors[i].calibratedValueC;  // Pressure calibrated
-                    sensor["modbus_value_c"] = configuredSensors[i].modbusValueC;  // Pressure modbus (register+2)
-                    sensor["modbus_register_c"] = configuredSensors[i].modbusRegister + 2;
-                }
-            }
-            
-            // Include calibration info for dataflow display
-            sensor["calibration_offset"] = configuredSensors[i].calibrationOffset;
-            sensor["calibration_slope"] = configuredSensors[i].calibrationSlope;
-            if (strlen(configuredSensors[i].calibrationExpression) > 0) {
-                sensor["calibration_expression"] = configuredSensors[i].calibrationExpression;
-            }
-            
-            // Multi-output calibration info
-            if (configuredSensors[i].calibrationSlopeB != 1.0 || configuredSensors[i].calibrationOffsetB != 0.0) {
-                sensor["calibration_offset_b"] = configuredSensors[i].calibrationOffsetB;
-                sensor["calibration_slope_b"] = configuredSensors[i].calibrationSlopeB;
-            }
-            if (strlen(configuredSensors[i].calibrationExpressionB) > 0) {
-                sensor["calibration_expression_b"] = configuredSensors[i].calibrationExpressionB;
-            }
-            if (strlen(configuredSensors[i].calibrationExpressionC) > 0) {
-                sensor["calibration_expression_c"] = configuredSensors[i].calibrationExpressionC;
-            }
-            
-            // Include last read time for status
-            sensor["last_read_time"] = configuredSensors[i].lastReadTime;
-            
-            // Include pin assignments for reference
-            if (String(configuredSensors[i].protocol).equalsIgnoreCase("I2C")) {
-                sensor["sda_pin"] = configuredSensors[i].sdaPin;
-                sensor["scl_pin"] = configuredSensors[i].sclPin;
-            } else if (String(configuredSensors[i].protocol).equalsIgnoreCase("Analog Voltage")) {
-                sensor["analog_pin"] = configuredSensors[i].analogPin;
-            } else if (String(configuredSensors[i].protocol).equalsIgnoreCase("Digital Counter")) {
-                sensor["digital_pin"] = configuredSensors[i].digitalPin;
-            } else if (String(configuredSensors[i].protocol).equalsIgnoreCase("One-Wire")) {
-                sensor["onewire_pin"] = configuredSensors[i].oneWirePin;
-            } else if (String(configuredSensors[i].protocol).equalsIgnoreCase("UART")) {
-                sensor["uart_tx_pin"] = configuredSensors[i].uartTxPin;
-                sensor["uart_rx_pin"] = configuredSensors[i].uartRxPin;
-            }
+    char entry[256];
+    while (out.total + out.length + sizeof(entry) + 16 <= space) {
+        {
+            TerminalLogLock lock;
+            uint32_t pending = terminalLogSequence - ev.logSequence;
+            if (pending > terminalBuffer.size()) pending = terminalBuffer.size();  // Older lines already dropped
+            if (pending == 0) break;
+            formatTerminalLogLine(terminalBuffer[terminalBuffer.size() - pending], entry, sizeof(entry));
+            ev.logSequence = terminalLogSequence - pending + 1;
         }
+        out.print("event: log\ndata: ");
+        out.printJsonString(entry);
+        out.print("\n\n");
     }
     
-    String jsonBuffer;
-    serializeJson(doc, jsonBuffer);
-    sendJSON(client, jsonBuffer);
+    if (out.total + out.length == 0 && now - ev.lastWrite >= HTTP_EVENT_PING_MS) {
+        out.print(": ping\n\n");
+    }
+    if (out.total + out.length > 0) {
+        out.end();
+        ev.lastWrite = now;
+        conn.lastActivity = now;
+    }
 }
 
 void sendJSONIOConfig(WiFiClient& client) {
@@ -4277,8 +6845,8 @@ void sendJSONIOConfig(WiFiClient& client) {
         diPullupArray.add(config.diPullup[i]);
         diInvertArray.add(config.diInvert[i]);
         diLatchArray.add(config.diLatch[i]);
-        diStateArray.add(ioStatus.dInRaw[i]);        // Actual pin state (HIGH/LOW)
-        diLatchedArray.add(ioStatus.dInLatched[i]);  // Latched state (true/false)
+        diStateArray.add(ioBit(ioStatus.dInRaw, i));        // Actual pin state (HIGH/LOW)
+        diLatchedArray.add(ioBit(ioStatus.dInLatched, i));  // Latched state (true/false)
     }
 
     JsonArray doInvertArray = doc.createNestedArray("doInvert");
@@ -4288,7 +6856,7 @@ void sendJSONIOConfig(WiFiClient& client) {
     for (int i = 0; i < 8; i++) {
         doInvertArray.add(config.doInvert[i]);
         doInitialStateArray.add(config.doInitialState[i]);
-        doStateArray.add(ioStatus.dOut[i]);          // Actual output state (HIGH/LOW)
+        doStateArray.add(ioBit(ioStatus.dOut, i));          // Actual output state (HIGH/LOW)
     }
 
     String response;
@@ -4708,17 +7276,20 @@ float parseSensorData(const char* rawData, const SensorConfig& sensor) {
 }
 
 void sendJSONSensorConfig(WiFiClient& client) {
-    StaticJsonDocument<2048> doc;
-    JsonArray sensorsArray = doc.createNestedArray("sensors");
+    ChunkedResponse out(client);
+    out.begin("application/json");
+    out.print("{\"sensors\":[");
     
     for (int i = 0; i < numConfiguredSensors; i++) {
-        JsonObject sensor = sensorsArray.createNestedObject();
+        StaticJsonDocument<2048> sensorDoc;
+        JsonObject sensor = sensorDoc.to<JsonObject>();
         sensor["enabled"] = configuredSensors[i].enabled;
         sensor["name"] = configuredSensors[i].name;
         sensor["type"] = configuredSensors[i].type;
         sensor["protocol"] = configuredSensors[i].protocol;
         sensor["i2cAddress"] = configuredSensors[i].i2cAddress;
         sensor["modbusRegister"] = configuredSensors[i].modbusRegister;
+        writeModbusEncoding(sensor, configuredSensors[i]);
         
         // Critical polling configuration - THESE WERE MISSING!
         sensor["command"] = configuredSensors[i].command;
@@ -4726,9 +7297,11 @@ void sendJSONSensorConfig(WiFiClient& client) {
         sensor["delayBeforeRead"] = configuredSensors[i].delayBeforeRead;
         
         // Clean response field to prevent JSON corruption from binary data
+        SensorValues values;
+        readSensorValues(i, values);
         String cleanResponse = "";
-        for (int j = 0; j < strlen(configuredSensors[i].response); j++) {
-            char c = configuredSensors[i].response[j];
+        for (int j = 0; j < strlen(values.response); j++) {
+            char c = values.response[j];
             if (c >= 32 && c <= 126) { // Only printable ASCII
                 cleanResponse += c;
             }
@@ -4741,8 +7314,11 @@ void sendJSONSensorConfig(WiFiClient& client) {
         sensor["dataPin"] = configuredSensors[i].dataPin;
         sensor["uartTxPin"] = configuredSensors[i].uartTxPin;
         sensor["uartRxPin"] = configuredSensors[i].uartRxPin;
+        sensor["uartBaud"] = configuredSensors[i].uartBaud;
+        sensor["uartFraming"] = configuredSensors[i].uartFraming;
         sensor["analogPin"] = configuredSensors[i].analogPin;
         sensor["oneWirePin"] = configuredSensors[i].oneWirePin;
+        sensor["oneWireRom"] = configuredSensors[i].oneWireRom;
         sensor["digitalPin"] = configuredSensors[i].digitalPin;
         
         // One-Wire specific configuration
@@ -4755,7 +7331,13 @@ void sendJSONSensorConfig(WiFiClient& client) {
         if (configuredSensors[i].oneWireConversionTime > 0) {
             sensor["oneWireConversionTime"] = configuredSensors[i].oneWireConversionTime;
         }
+        sensor["oneWireResolution"] = configuredSensors[i].oneWireResolution;
         sensor["oneWireAutoMode"] = configuredSensors[i].oneWireAutoMode;
+        if (strcmp(configuredSensors[i].type, "LIS3DH") == 0) {
+            sensor["lis3dhOdr"] = configuredSensors[i].lis3dhOdr;
+            sensor["lis3dhRange"] = configuredSensors[i].lis3dhRange;
+            sensor["lis3dhIntPin"] = configuredSensors[i].lis3dhIntPin;
+        }
         
         // Always include calibration data
         JsonObject calibration = sensor.createNestedObject("calibration");
@@ -4806,34 +7388,42 @@ void sendJSONSensorConfig(WiFiClient& client) {
                 }
             }
         }
+        
+        if (sensorDoc.overflowed()) sensor["truncated"] = true;
+        if (i > 0) out.write(',');
+        serializeJson(sensorDoc, out);
     }
-    
-    String response;
-    serializeJson(doc, response);
-    sendJSON(client, response);
+    out.print("]}");
+    endJSONStream(client, out);
 }
 
 void sendJSONSensorData(WiFiClient& client) {
-    StaticJsonDocument<4096> doc;
-    JsonArray sensorsArray = doc.createNestedArray("sensors");
+    ChunkedResponse out(client);
+    out.begin("application/json");
+    out.print("{\"sensors\":[");
     
+    int written = 0;
     for (int i = 0; i < numConfiguredSensors; i++) {
         if (configuredSensors[i].enabled) {
-            JsonObject sensor = sensorsArray.createNestedObject();
+            SensorValues values;
+            readSensorValues(i, values);
+            StaticJsonDocument<1536> sensorDoc;
+            JsonObject sensor = sensorDoc.to<JsonObject>();
             sensor["name"] = configuredSensors[i].name;
             sensor["type"] = configuredSensors[i].type;
             sensor["protocol"] = configuredSensors[i].protocol;
             sensor["i2c_address"] = configuredSensors[i].i2cAddress;
             sensor["modbus_register"] = configuredSensors[i].modbusRegister;
+            sensor["modbus_encoding"] = registerEncodingName(configuredSensors[i].modbusEncoding[0]);
             
             // Raw sensor data
-            sensor["raw_value"] = configuredSensors[i].rawValue;
-            sensor["raw_data_string"] = configuredSensors[i].rawDataString;
+            sensor["raw_value"] = values.rawValue;
+            sensor["raw_data_string"] = values.rawDataString;
             
             // Clean response field to prevent JSON corruption from binary data
             String cleanResponse = "";
-            for (int j = 0; j < strlen(configuredSensors[i].response); j++) {
-                char c = configuredSensors[i].response[j];
+            for (int j = 0; j < strlen(values.response); j++) {
+                char c = values.response[j];
                 if (c >= 32 && c <= 126) { // Only printable ASCII
                     cleanResponse += c;
                 }
@@ -4841,28 +7431,38 @@ void sendJSONSensorData(WiFiClient& client) {
             sensor["response"] = cleanResponse;
             
             // Calibrated values
-            sensor["calibrated_value"] = configuredSensors[i].calibratedValue;
-            sensor["modbus_value"] = configuredSensors[i].modbusValue;
+            sensor["calibrated_value"] = values.calibratedValue;
+            sensor["modbus_value"] = values.modbusValue;
             
             // Multi-output sensor support (SHT30, BME280, etc.)
-            if (configuredSensors[i].rawValueB != 0) {
-                sensor["raw_value_b"] = configuredSensors[i].rawValueB;
-                sensor["calibrated_value_b"] = configuredSensors[i].calibratedValueB;
-                sensor["modbus_value_b"] = configuredSensors[i].modbusValueB;
-                sensor["modbus_register_b"] = configuredSensors[i].modbusRegister + 1;
+            if (values.rawValueB != 0) {
+                sensor["raw_value_b"] = values.rawValueB;
+                sensor["calibrated_value_b"] = values.calibratedValueB;
+                sensor["modbus_value_b"] = values.modbusValueB;
+                sensor["modbus_register_b"] = registerAddressFor(i, RegisterSource::VALUE_B);
             }
             
-            if (configuredSensors[i].rawValueC != 0) {
-                sensor["raw_value_c"] = configuredSensors[i].rawValueC;
-                sensor["calibrated_value_c"] = configuredSensors[i].calibratedValueC;
-                sensor["modbus_value_c"] = configuredSensors[i].modbusValueC;
-                sensor["modbus_register_c"] = configuredSensors[i].modbusRegister + 2;
+            if (values.rawValueC != 0) {
+                sensor["raw_value_c"] = values.rawValueC;
+                sensor["calibrated_value_c"] = values.calibratedValueC;
+                sensor["modbus_value_c"] = values.modbusValueC;
+                sensor["modbus_register_c"] = registerAddressFor(i, RegisterSource::VALUE_C);
             }
             
             // Timing information
-            sensor["last_read_time"] = configuredSensors[i].lastReadTime;
+            sensor["last_read_time"] = values.lastReadTime;
             sensor["update_interval"] = configuredSensors[i].updateInterval;
             
+            // Measured vs configured read rate (shows bus contention/backlog)
+            sensor["read_count"] = values.readCount;
+            sensor["measured_interval_ms"] = values.measuredIntervalMs;
+            if (configuredSensors[i].updateInterval > 0) {
+                sensor["configured_rate_hz"] = 1000.0f / configuredSensors[i].updateInterval;
+            }
+            if (values.measuredIntervalMs > 0) {
+                sensor["measured_rate_hz"] = 1000.0f / values.measuredIntervalMs;
+            }
+            
             // Calibration settings
             sensor["calibration_offset"] = configuredSensors[i].calibrationOffset;
             sensor["calibration_slope"] = configuredSensors[i].calibrationSlope;
@@ -4885,19 +7485,18 @@ void sendJSONSensorData(WiFiClient& client) {
             if (strlen(configuredSensors[i].calibrationExpressionC) > 0) {
                 sensor["calibration_expression_c"] = configuredSensors[i].calibrationExpressionC;
             }
+            
+            if (sensorDoc.overflowed()) sensor["truncated"] = true;
+            if (written++ > 0) out.write(',');
+            serializeJson(sensorDoc, out);
         }
     }
     
     // Add system information
-    doc["system_time"] = millis();
-    doc["num_configured_sensors"] = numConfiguredSensors;
-    doc["queue_sizes"]["i2c"] = i2cQueueSize;
-    doc["queue_sizes"]["uart"] = uartQueueSize;
-    doc["queue_sizes"]["onewire"] = oneWireQueueSize;
-    
-    String response;
-    serializeJson(doc, response);
-    sendJSON(client, response);
+    out.printf("],\"system_time\":%lu,\"num_configured_sensors\":%d,", millis(), numConfiguredSensors);
+    out.printf("\"queue_sizes\":{\"i2c\":%u,\"uart\":%u,\"onewire\":%u}}",
+               (unsigned)i2cQueue.count, (unsigned)uartQueue.count, (unsigned)oneWireQueue.count);
+    endJSONStream(client, out);
 }
 
 // POST handler functions
@@ -5005,6 +7604,137 @@ void handlePOSTConfig(WiFiClient& client, String body) {
         }
     }
     
+    // Update packed sensor register block; only the register map is rebuilt
+    bool packedChanged = false;
+    bool previousPackedEnabled = config.modbusPackedEnabled;
+    uint16_t previousPackedBase = config.modbusPackedBase;
+    if (doc.containsKey("modbusPackedEnabled")) {
+        bool newEnabled = doc["modbusPackedEnabled"];
+        if (newEnabled != config.modbusPackedEnabled) {
+            config.modbusPackedEnabled = newEnabled;
+            packedChanged = true;
+        }
+    }
+    if (doc.containsKey("modbusPackedBase")) {
+        long newBase = doc["modbusPackedBase"];
+        if (newBase < MODBUS_INPUT_REGISTERS || newBase > MODBUS_PACKED_MAX_BASE) {
+            client.println("HTTP/1.1 400 Bad Request");
+            client.println("Content-Type: application/json");
+            client.println("Connection: close");
+            client.println();
+            client.println("{\"success\":false,\"message\":\"Packed block base must be between 32 and 8000\"}");
+            client.stop();
+            return;
+        }
+        if (newBase != config.modbusPackedBase) {
+            config.modbusPackedBase = newBase;
+            packedChanged = true;
+        }
+    }
+    if (packedChanged) {
+        Serial.printf("Packed register block %s at %d\n", config.modbusPackedEnabled ? "enabled" : "disabled", config.modbusPackedBase);
+        const char* packedError = compileRegisterMap();
+        if (packedError) {
+            // Roll back to the block that was running
+            config.modbusPackedEnabled = previousPackedEnabled;
+            config.modbusPackedBase = previousPackedBase;
+            compileRegisterMap();
+            client.println("HTTP/1.1 400 Bad Request");
+            client.println("Content-Type: application/json");
+            client.println("Connection: close");
+            client.println();
+            client.println(String("{\"success\":false,\"message\":\"") + packedError + "\"}");
+            client.stop();
+            return;
+        }
+    }
+    
+    // Update connection pool; applies to the next accept and idle check, no restart needed
+    bool poolChanged = false;
+    if (doc.containsKey("modbusMaxClients")) {
+        uint8_t newMax = constrain(doc["modbusMaxClients"].as<int>(), 1, MAX_MODBUS_CLIENTS);
+        if (newMax != config.modbusMaxClients) {
+            config.modbusMaxClients = newMax;
+            poolChanged = true;
+        }
+    }
+    if (doc.containsKey("modbusIdleTimeout")) {
+        uint16_t newTimeout = doc["modbusIdleTimeout"];
+        if (newTimeout != config.modbusIdleTimeout) {
+            config.modbusIdleTimeout = newTimeout;
+            poolChanged = true;
+        }
+    }
+    if (poolChanged) {
+        Serial.printf("Modbus pool: %d connections, idle timeout %ds\n", config.modbusMaxClients, config.modbusIdleTimeout);
+    }
+    
+    // Update Modbus RTU server; validated as a whole, then the UART is reopened
+    bool rtuChanged = false;
+    if (doc.containsKey("modbusRtuEnabled") || doc.containsKey("modbusRtuUnitId") || doc.containsKey("modbusRtuBaud") ||
+        doc.containsKey("modbusRtuFraming") || doc.containsKey("modbusRtuTxPin") || doc.containsKey("modbusRtuRxPin") ||
+        doc.containsKey("modbusRtuDePin") || doc.containsKey("modbusRtuGateway")) {
+        bool enabled = doc["modbusRtuEnabled"] | config.modbusRtuEnabled;
+        int unitId = doc["modbusRtuUnitId"] | (int)config.modbusRtuUnitId;
+        uint32_t baud = doc["modbusRtuBaud"] | config.modbusRtuBaud;
+        const char* framing = doc["modbusRtuFraming"] | (const char*)config.modbusRtuFraming;
+        int txPin = doc["modbusRtuTxPin"] | (int)config.modbusRtuTxPin;
+        int rxPin = doc["modbusRtuRxPin"] | (int)config.modbusRtuRxPin;
+        int dePin = doc["modbusRtuDePin"] | (int)config.modbusRtuDePin;
+        bool gateway = doc["modbusRtuGateway"] | config.modbusRtuGateway;
+        uint dataBits, stopBits;
+        uart_parity_t parity;
+        const char* rtuError = NULL;
+        if (unitId < 1 || unitId > 247) rtuError = "RTU unit ID must be between 1 and 247";
+        else if (baud < 1200 || baud > 921600) rtuError = "RTU baud rate must be between 1200 and 921600";
+        else if (!parseModbusRTUFraming(framing, dataBits, parity, stopBits)) rtuError = "RTU framing must be data bits, parity and stop bits (e.g. 8E1)";
+        else if (uartPortForPins(txPin, rxPin) < 0) rtuError = "RTU TX/RX pins must be a hardware UART pair (e.g. 12/13)";
+        else if (!modbusRTUPinsUsable(txPin, rxPin, dePin)) rtuError = "RTU pins must be header GPIOs not used by the W5500 or the LED, DE -1 or a free GPIO";
+        if (rtuError) {
+            client.println("HTTP/1.1 400 Bad Request");
+            client.println("Content-Type: application/json");
+            client.println("Connection: close");
+            client.println();
+            client.println(String("{\"success\":false,\"message\":\"") + rtuError + "\"}");
+            client.stop();
+            return;
+        }
+        rtuChanged = enabled != config.modbusRtuEnabled || unitId != config.modbusRtuUnitId ||
+                     baud != config.modbusRtuBaud || strcasecmp(framing, config.modbusRtuFraming) != 0 ||
+                     txPin != config.modbusRtuTxPin || rxPin != config.modbusRtuRxPin || dePin != config.modbusRtuDePin ||
+                     gateway != config.modbusRtuGateway;
+        if (rtuChanged) {
+            config.modbusRtuEnabled = enabled;
+            config.modbusRtuUnitId = unitId;
+            config.modbusRtuBaud = baud;
+            snprintf(config.modbusRtuFraming, sizeof(config.modbusRtuFraming), "%c%c%c",
+                     framing[0], toupper(framing[1]), framing[2]);
+            config.modbusRtuTxPin = txPin;
+            config.modbusRtuRxPin = rxPin;
+            config.modbusRtuDePin = dePin;
+            config.modbusRtuGateway = gateway;
+            openModbusRTU();
+            resizeModbusImage();  // Gateway window appears or goes away with the role
+            compileRegisterMap();
+        }
+    }
+    
+    // Update /events coalescing interval; streams pick it up on their next push
+    bool eventsChanged = false;
+    if (doc.containsKey("eventInterval")) {
+        uint16_t newInterval = constrain(doc["eventInterval"].as<int>(), HTTP_EVENT_MIN_INTERVAL_MS, HTTP_EVENT_MAX_INTERVAL_MS);
+        if (newInterval != config.eventInterval) {
+            config.eventInterval = newInterval;
+            eventsChanged = true;
+            Serial.printf("Live update interval: %dms\n", config.eventInterval);
+        }
+    }
+    
+    bool modbusChanged = packedChanged || poolChanged || rtuChanged;
+    if ((modbusChanged || eventsChanged) && !configChanged) {
+        saveConfig();
+    }
+    
     // Update hostname
     if (doc.containsKey("hostname")) {
         const char* newHostname = doc["hostname"];
@@ -5029,6 +7759,20 @@ void handlePOSTConfig(WiFiClient& client, String body) {
         client.println();
         client.println("{\"success\":true,\"message\":\"Network configuration saved and applied immediately.\",\"reboot\":false}");
         client.stop();
+    } else if (modbusChanged) {
+        client.println("HTTP/1.1 200 OK");
+        client.println("Content-Type: application/json");
+        client.println("Connection: close");
+        client.println();
+        client.println("{\"success\":true,\"message\":\"Modbus settings saved and applied.\",\"reboot\":false}");
+        client.stop();
+    } else if (eventsChanged) {
+        client.println("HTTP/1.1 200 OK");
+        client.println("Content-Type: application/json");
+        client.println("Connection: close");
+        client.println();
+        client.println("{\"success\":true,\"message\":\"Live update interval saved and applied.\",\"reboot\":false}");
+        client.stop();
     } else {
         client.println("HTTP/1.1 200 OK");
         client.println("Content-Type: application/json");
@@ -5055,8 +7799,8 @@ void handlePOSTSetOutput(WiFiClient& client, String body) {
     }
     
     if (outputIndex >= 0 && outputIndex < 8 && (state == 0 || state == 1)) {
-        ioStatus.dOut[outputIndex] = state;
-        digitalWrite(DIGITAL_OUTPUTS[outputIndex], config.doInvert[outputIndex] ? !state : state);
+        setDigitalOutput(outputIndex, state);
+        modbusImage.coilWrite(outputIndex, state);
         
         client.println("HTTP/1.1 200 OK");
         client.println("Content-Type: application/json");
@@ -5093,11 +7837,7 @@ void handlePOSTIOConfig(WiFiClient& client, String body) {
 }
 
 void handlePOSTResetLatches(WiFiClient& client) {
-    for (int i = 0; i < 8; i++) {
-        if (config.diLatch[i]) {
-            ioStatus.dInLatched[i] = false;
-        }
-    }
+    ioStatus.dInLatched &= ~ioMasks.diLatch;
     
     client.println("HTTP/1.1 200 OK");
     client.println("Content-Type: application/json");
@@ -5111,7 +7851,7 @@ void handlePOSTResetSingleLatch(WiFiClient& client, String body) {
     if (!deserializeJson(doc, body) && doc.containsKey("input")) {
         int input = doc["input"];
         if (input >= 0 && input < 8 && config.diLatch[input]) {
-            ioStatus.dInLatched[input] = false;
+            setIoBit(ioStatus.dInLatched, input, false);
         }
     }
     
@@ -5154,9 +7894,9 @@ void handlePOSTSensorConfig(WiFiClient& client, String body) {
     struct PinUsage { int pin; const char* type; } usedPins[32];
     int usedCount = 0;
     
-    // Array to track used Modbus registers
-    int usedModbusRegisters[MAX_SENSORS * 2]; // Allow for multi-output sensors
-    int usedRegisterCount = 0;
+    // Register ranges [start, end) already claimed, sized by type and encoding
+    struct RegisterSpan { int start; int end; } usedSpans[MAX_SENSORS];
+    int usedSpanCount = 0;
 
     // Helper: fill defaults for known sensor types
     auto fillDefaults = [](JsonObject& sensor) {
@@ -5165,12 +7905,12 @@ void handlePOSTSensorConfig(WiFiClient& client, String body) {
             if (!sensor.containsKey("i2cAddress") || (int)sensor["i2cAddress"] == 0) {
                 sensor["i2cAddress"] = 0x76;
             }
-            sensor["modbusRegister"] = 3;
+            if (!sensor.containsKey("modbusRegister")) sensor["modbusRegister"] = 3;
         } else if (strcmp(type, "EZO-PH") == 0 || strcmp(type, "EZO_PH") == 0) {
             if (!sensor.containsKey("i2cAddress") || (int)sensor["i2cAddress"] == 0) {
                 sensor["i2cAddress"] = 0x63;
             }
-            sensor["modbusRegister"] = 4;
+            if (!sensor.containsKey("modbusRegister")) sensor["modbusRegister"] = 4;
             if (!sensor.containsKey("command") || String(sensor["command"] | "").length() == 0) {
                 sensor["command"] = "R";
             }
@@ -5178,7 +7918,7 @@ void handlePOSTSensorConfig(WiFiClient& client, String body) {
             if (!sensor.containsKey("i2cAddress") || (int)sensor["i2cAddress"] == 0) {
                 sensor["i2cAddress"] = 0x64;
             }
-            sensor["modbusRegister"] = 5;
+            if (!sensor.containsKey("modbusRegister")) sensor["modbusRegister"] = 5;
             if (!sensor.containsKey("command") || String(sensor["command"] | "").length() == 0) {
                 sensor["command"] = "R";
             }
@@ -5186,7 +7926,7 @@ void handlePOSTSensorConfig(WiFiClient& client, String body) {
             if (!sensor.containsKey("i2cAddress") || (int)sensor["i2cAddress"] == 0) {
                 sensor["i2cAddress"] = 0x61;
             }
-            sensor["modbusRegister"] = 6;
+            if (!sensor.containsKey("modbusRegister")) sensor["modbusRegister"] = 6;
             if (!sensor.containsKey("command") || String(sensor["command"] | "").length() == 0) {
                 sensor["command"] = "R";
             }
@@ -5194,7 +7934,7 @@ void handlePOSTSensorConfig(WiFiClient& client, String body) {
             if (!sensor.containsKey("i2cAddress") || (int)sensor["i2cAddress"] == 0) {
                 sensor["i2cAddress"] = 0x66;
             }
-            sensor["modbusRegister"] = 7;
+            if (!sensor.containsKey("modbusRegister")) sensor["modbusRegister"] = 7;
             if (!sensor.containsKey("command") || String(sensor["command"] | "").length() == 0) {
                 sensor["command"] = "R";
             }
@@ -5224,44 +7964,36 @@ void handlePOSTSensorConfig(WiFiClient& client, String body) {
             usedPins[usedCount++] = {i2cAddr, "I2C"};
         }
         
-        // Check for Modbus register conflicts
+        // Check for Modbus register conflicts over every register the sensor takes
         int modbusReg = sensor["modbusRegister"] | -1;
         Serial.printf("Checking sensor '%s' Modbus register: %d\n", sensorName, modbusReg);
-        if (modbusReg >= 0) {
-            // Check if this register is already used
-            for (int i = 0; i < usedRegisterCount; i++) {
-                if (usedModbusRegisters[i] == modbusReg) {
-                    Serial.printf("Modbus register conflict detected: %d already used\n", modbusReg);
+        if (modbusReg >= 0 && usedSpanCount < MAX_SENSORS) {
+            RegisterEncoding encodings[3];
+            readModbusEncodings(sensor, encodings);
+            int end = modbusReg + sensorRegisterSpan(sensor["type"] | "", encodings);
+            if (end > MODBUS_INPUT_REGISTERS) {
+                Serial.printf("Modbus registers %d-%d outside the input register window\n", modbusReg, end - 1);
+                client.println("HTTP/1.1 400 Bad Request");
+                client.println("Content-Type: application/json");
+                client.println("Connection: close");
+                client.println();
+                client.printf("{\"success\":false,\"error\":\"Modbus registers %d-%d run past the input register window (0-%d)\"}",
+                              modbusReg, end - 1, MODBUS_INPUT_REGISTERS - 1);
+                return;
+            }
+            for (int i = 0; i < usedSpanCount; i++) {
+                if (modbusReg < usedSpans[i].end && usedSpans[i].start < end) {
+                    Serial.printf("Modbus register conflict detected: %d-%d overlaps %d-%d\n",
+                                  modbusReg, end - 1, usedSpans[i].start, usedSpans[i].end - 1);
                     client.println("HTTP/1.1 400 Bad Request");
                     client.println("Content-Type: application/json");
                     client.println("Connection: close");
                     client.println();
-                    client.printf("{\"success\":false,\"error\":\"Modbus register conflict at %d\"}", modbusReg);
+                    client.printf("{\"success\":false,\"error\":\"Modbus register conflict at %d-%d\"}", modbusReg, end - 1);
                     return;
                 }
             }
-            
-            // Add this register to used list
-            usedModbusRegisters[usedRegisterCount++] = modbusReg;
-            
-            // For multi-output sensors like SHT30, also reserve the next register
-            const char* sensorType = sensor["type"] | "";
-            if (strcmp(sensorType, "SHT30") == 0 || strcmp(sensorType, "BME280") == 0) {
-                // Check if next register is already used
-                int nextReg = modbusReg + 1;
-                for (int i = 0; i < usedRegisterCount; i++) {
-                    if (usedModbusRegisters[i] == nextReg) {
-                        client.println("HTTP/1.1 400 Bad Request");
-                        client.println("Content-Type: application/json");
-                        client.println("Connection: close");
-                        client.println();
-                        client.println("{\"success\":false,\"error\":\"Modbus register conflict (multi-output sensor)\"}");
-                        return;
-                    }
-                }
-                // Reserve the next register for multi-output sensor
-                usedModbusRegisters[usedRegisterCount++] = nextReg;
-            }
+            usedSpans[usedSpanCount++] = {modbusReg, end};
         }
         
         // TODO: check analog/digital pin conflicts similarly
@@ -5285,6 +8017,7 @@ void handlePOSTSensorConfig(WiFiClient& client, String body) {
         configuredSensors[numConfiguredSensors].protocol[sizeof(configuredSensors[numConfiguredSensors].protocol) - 1] = '\0';
         configuredSensors[numConfiguredSensors].i2cAddress = sensor["i2cAddress"] | 0;
         configuredSensors[numConfiguredSensors].modbusRegister = sensor["modbusRegister"] | 0;
+        readModbusEncoding(sensor, configuredSensors[numConfiguredSensors]);
         
         // Critical polling configuration - accept both pollingFrequency and updateInterval
         // Handle command - can be string or nested object from web UI
@@ -5318,8 +8051,13 @@ void handlePOSTSensorConfig(WiFiClient& client, String body) {
         configuredSensors[numConfiguredSensors].dataPin = sensor["dataPin"] | -1;
         configuredSensors[numConfiguredSensors].uartTxPin = sensor["uartTxPin"] | -1;
         configuredSensors[numConfiguredSensors].uartRxPin = sensor["uartRxPin"] | -1;
+        configuredSensors[numConfiguredSensors].uartBaud = readUartBaud(sensor);
+        strncpy(configuredSensors[numConfiguredSensors].uartFraming, sensor["uartFraming"] | "8N1", 
+                sizeof(configuredSensors[numConfiguredSensors].uartFraming)-1);
+        configuredSensors[numConfiguredSensors].uartFraming[sizeof(configuredSensors[numConfiguredSensors].uartFraming)-1] = '\0';
         configuredSensors[numConfiguredSensors].analogPin = sensor["analogPin"] | -1;
         configuredSensors[numConfiguredSensors].oneWirePin = sensor["oneWirePin"] | -1;
+        normalizeOneWireRom(sensor["oneWireRom"] | "", configuredSensors[numConfiguredSensors].oneWireRom);
         configuredSensors[numConfiguredSensors].digitalPin = sensor["digitalPin"] | -1;
         
         // One-Wire specific configuration with defaults
@@ -5330,9 +8068,14 @@ void handlePOSTSensorConfig(WiFiClient& client, String body) {
         
         configuredSensors[numConfiguredSensors].oneWireInterval = sensor["oneWireInterval"] | 5; // Default 5 seconds
         configuredSensors[numConfiguredSensors].oneWireConversionTime = sensor["oneWireConversionTime"] | 750; // Default 750ms
+        configuredSensors[numConfiguredSensors].oneWireResolution = constrain((int)(sensor["oneWireResolution"] | 12), 9, 12); // Default 12-bit
         configuredSensors[numConfiguredSensors].oneWireAutoMode = sensor["oneWireAutoMode"] | true; // Default auto mode on
         configuredSensors[numConfiguredSensors].lastOneWireCmd = 0; // Initialize timing
         
+        configuredSensors[numConfiguredSensors].lis3dhOdr = sensor["lis3dhOdr"] | 400; // Default 400 Hz
+        configuredSensors[numConfiguredSensors].lis3dhRange = sensor["lis3dhRange"] | 2; // Default ±2g
+        configuredSensors[numConfiguredSensors].lis3dhIntPin = sensor["lis3dhIntPin"] | -1; // Default: poll FIFO status
+        
         // SPI specific configuration - for LIS3DH_SPI and other SPI sensors
         configuredSensors[numConfiguredSensors].spiChipSelect = sensor["spiChipSelect"] | 22; // Default GP22
         const char* spiBus = sensor["spiBus"] | "hw0"; // Default hardware SPI0
@@ -5445,9 +8188,6 @@ void handlePOSTSensorConfig(WiFiClient& client, String body) {
     // Immediately apply sensor changes without requiring reboot
     reapplySensorConfig();
     
-    // Small delay to ensure file save completes before response
-    delay(100);
-    
     client.println("HTTP/1.1 200 OK");
     client.println("Content-Type: application/json");
     client.println("Access-Control-Allow-Origin: *");
@@ -5493,7 +8233,7 @@ void handlePOSTSensorCommand(WiFiClient& client, String body) {
             } else if (pin.startsWith("DO")) {
                 int pinNum = pin.substring(2).toInt();
                 if (pinNum >= 0 && pinNum < 8) {
-                    bool state = ioStatus.dOut[pinNum];
+                    bool state = ioBit(ioStatus.dOut, pinNum);
                     response = pin + " = " + (state ? "HIGH" : "LOW");
                 } else {
                     success = false;
@@ -5506,8 +8246,8 @@ void handlePOSTSensorCommand(WiFiClient& client, String body) {
                 int pinNum = pin.substring(2).toInt();
                 if (pinNum >= 0 && pinNum < 8) {
                     bool state = (value == "1" || value.equalsIgnoreCase("HIGH"));
-                    ioStatus.dOut[pinNum] = state;
-                    digitalWrite(DIGITAL_OUTPUTS[pinNum], config.doInvert[pinNum] ? !state : state);
+                    setDigitalOutput(pinNum, state);
+                    modbusImage.coilWrite(pinNum, state);
                     response = pin + " set to " + (state ? "HIGH" : "LOW");
                 } else {
                     success = false;
@@ -5602,9 +8342,13 @@ void handlePOSTSensorCommand(WiFiClient& client, String body) {
         } else if (command == "clients") {
             response = "Modbus Clients:\\n";
             response += "Connected: " + String(connectedClients) + "\\n";
+            response += "Pool: " + String(config.modbusMaxClients) + ", evicted: " + String(modbusPoolStats.evicted) +
+                        ", idle closed: " + String(modbusPoolStats.idleClosed) + ", rejected: " + String(modbusPoolStats.rejected) + "\\n";
             for (int i = 0; i < MAX_MODBUS_CLIENTS; i++) {
                 if (modbusClients[i].connected) {
-                    response += "Slot " + String(i) + ": " + modbusClients[i].clientIP.toString() + "\\n";
+                    response += "Slot " + String(i) + ": " + modbusClients[i].clientIP.toString() +
+                                " age " + String((millis() - modbusClients[i].connectionTime) / 1000) + "s, idle " +
+                                String((millis() - modbusClients[i].lastActivity) / 1000) + "s\\n";
                 }
             }
         } else {
@@ -5654,6 +8398,7 @@ void handlePOSTSensorPoll(WiFiClient& client, String body) {
     
     if (protocol == "I2C") {
         Wire.begin();
+        Wire.setClock(I2C_BUS_CLOCK_HZ);
         
         if (i2cAddress < 1 || i2cAddress > 127) {
             errorMsg = "Invalid I2C address: 0x" + String(i2cAddress, HEX);
@@ -5734,6 +8479,8 @@ void handlePOSTSensorPoll(WiFiClient& client, String body) {
         
         if (txPin < 0 || txPin > 28 || rxPin < 0 || rxPin > 28) {
             errorMsg = "Invalid UART pins. TX and RX must be 0-28";
+        } else if (modbusRtu.port == 0) {
+            errorMsg = "UART0 (Serial1) is in use by the Modbus RTU server";
         } else {
             addTerminalLog("POLL [UART] Testing UART on TX:GP" + String(txPin) + ", RX:GP" + String(rxPin));
             
@@ -5822,114 +8569,27 @@ void handlePOSTSensorPoll(WiFiClient& client, String body) {
 void updateIOpins() {
     // Update Modbus registers with current IO state
     
-    // Update digital inputs - account for invert configuration and latching behavior
-    for (int i = 0; i < 8; i++) {
-        uint16_t rawValue = digitalRead(DIGITAL_INPUTS[i]);
-        
-        // Apply inversion if configured
-        if (config.diInvert[i]) {
-            rawValue = !rawValue;
-        }
-        
-        // Store the raw input state
-        ioStatus.dInRaw[i] = rawValue;
-        
-        // Check if latching is enabled for this input
-        if (config.diLatch[i]) {
-            // If input is active (HIGH) and not already latched, set the latch
-            if (rawValue && !ioStatus.dInLatched[i]) {
-                ioStatus.dInLatched[i] = true;
-                ioStatus.dIn[i] = true; // Set the input state to ON
-            }
-            // If input is latched, keep it ON regardless of the current physical state
-            else if (ioStatus.dInLatched[i]) {
-                ioStatus.dIn[i] = true;
-            }
-            // Otherwise, use the raw value
-            else {
-                ioStatus.dIn[i] = rawValue;
-            }
-        }
-    }
+    // Update digital inputs - one SIO read snapshots all eight pins, then invert and latch as masks
+    uint8_t rawValue = (uint8_t)(gpio_get_all() >> DIGITAL_INPUT_SHIFT) ^ ioMasks.diInvert;
+    ioStatus.dInRaw = rawValue;
     
-    // Update digital outputs - account for inversion
-    for (int i = 0; i < 8; i++) {
-        // Check the coil state for each client and update if any client changed an output
-        bool logicalState = ioStatus.dOut[i];
-        bool stateChanged = false;
-        
-        // First detect if any client has changed the state
-        for (int j = 0; j < MAX_MODBUS_CLIENTS; j++) {
-            if (modbusClients[j].connected) {
-                bool clientCoilState = modbusClients[j].server.coilRead(i);
-                if (clientCoilState != logicalState) {
-                    // A client has changed this output's state, update our logical state
-                    logicalState = clientCoilState;
-                    ioStatus.dOut[i] = logicalState;
-                    stateChanged = true;
-                    break;  // We found a change, no need to check other clients
-                }
-            }
-        }
-        
-        // If state changed, synchronize all clients to the new state
-        if (stateChanged) {
-            Serial.printf("Output %d state changed to %d, synchronizing all clients\n", i, logicalState);
-            for (int j = 0; j < MAX_MODBUS_CLIENTS; j++) {
-                if (modbusClients[j].connected) {
-                    modbusClients[j].server.coilWrite(i, logicalState);
-                }
-            }
-        }
-        
-        // Apply inversion only to the physical pin, not to the logical state
-        bool physicalState = logicalState;
-        if (config.doInvert[i]) {
-            physicalState = !logicalState;
-        }
-        
-        // Set the physical pin state
-        digitalWrite(DIGITAL_OUTPUTS[i], physicalState);
-    }
+    // Latching inputs stay ON once active until reset; the rest follow the raw value
+    ioStatus.dInLatched = (ioStatus.dInLatched | rawValue) & ioMasks.diLatch;
+    ioStatus.dIn = rawValue | ioStatus.dInLatched;
+    
+    // Reassert digital outputs - Modbus coil writes are applied immediately by applyModbusCoilWrite()
+    // The shared coils hold the last state written by any client
+    ioStatus.dOut = modbusImage.readCoilBits(0, 8);
+    writeDigitalOutputs(ioStatus.dOut);
     
-    // Update analog inputs, using millivolts format
+    // Update analog inputs, using millivolts format (ADC is shared with core1's analog sensors)
+    mutex_enter_blocking(&adcMutex);
     for (int i = 0; i < 3; i++) {
         uint32_t rawValue = analogRead(ANALOG_INPUTS[i]);
         uint16_t valueToWrite = (rawValue * 3300UL) / 4095UL;
         ioStatus.aIn[i] = valueToWrite;
     }
-    
-    // Read ANALOG_CUSTOM sensors - handle analog voltage sensors directly here
-    for (int i = 0; i < numConfiguredSensors; i++) {
-        if (!configuredSensors[i].enabled) continue;
-        
-        // Check if sensor should be read based on updateInterval
-        unsigned long currentTime = millis();
-        if (currentTime - configuredSensors[i].lastReadTime >= configuredSensors[i].updateInterval) {
-            
-            if (strncmp(configuredSensors[i].protocol, "Analog", 6) == 0) {
-                // Read analog voltage sensor
-                int pin = configuredSensors[i].analogPin;
-                if (pin >= 0 && pin < 32) {
-                    uint32_t rawADC = analogRead(pin);
-                    float voltage = (rawADC * 3.3) / 4095.0;
-                    
-                    // Store raw and calibrated values to BOTH configuredSensors AND ioStatus
-                    // This ensures data flows to web UI and Modbus
-                    configuredSensors[i].rawValue = voltage;
-                    float calibrated = applyCalibration(voltage, configuredSensors[i]);
-                    configuredSensors[i].calibratedValue = calibrated;
-                    configuredSensors[i].modbusValue = (int)(calibrated * 100);
-                    configuredSensors[i].lastReadTime = currentTime;
-                    
-                    // Also store to ioStatus for web UI compatibility
-                    if (i < 3) {
-                        ioStatus.aIn[i] = (uint16_t)(calibrated * 1000); // mV format
-                    }
-                }
-            }
-        }
-    }
+    mutex_exit(&adcMutex);
     
     // I2C Sensor Reading - Dynamic sensor configuration
     static uint32_t sensorReadTime = 0;
@@ -5954,59 +8614,385 @@ void updateIOpins() {
     }
 }
 
-void updateIOForClient(int clientIndex) {
-    // Update Modbus registers with current IO state, actual pin states measured in updateIOpins()
+const char* const REGISTER_ENCODING_NAMES[] = {"int16", "uint16", "int32", "uint32", "float32", "raw16"};
+
+const char* registerEncodingName(RegisterEncoding encoding) {
+    return REGISTER_ENCODING_NAMES[(uint8_t)encoding];
+}
+
+RegisterEncoding registerEncodingFromName(const char* name) {
+    // raw16 is internal to the LIS3DH feature registers and cannot be configured
+    for (uint8_t i = 0; i <= (uint8_t)RegisterEncoding::FLOAT32; i++) {
+        if (strcasecmp(name, REGISTER_ENCODING_NAMES[i]) == 0) return (RegisterEncoding)i;
+    }
+    return RegisterEncoding::INT16;
+}
+
+uint8_t registerEncodingWidth(RegisterEncoding encoding) {
+    return (encoding == RegisterEncoding::INT32 || encoding == RegisterEncoding::UINT32 ||
+            encoding == RegisterEncoding::FLOAT32) ? 2 : 1;
+}
+
+// Outputs (A, B, C) a sensor type maps to Modbus registers
+uint8_t sensorOutputCount(const char* type) {
+    if (strcmp(type, "SHT30") == 0) return 2;                                      // Temperature, humidity
+    // BME280 stays at 1: nothing decodes its humidity or pressure yet, so B/C would read 0
+    if (strcmp(type, "LIS3DH") == 0 || strcmp(type, "LIS3DH_SPI") == 0) return 3;  // X, Y, Z mean
+    return 1;
+}
+
+// Registers a sensor takes in the input register window: each output at the
+// width of its encoding, then the LIS3DH vibration features
+int sensorRegisterSpan(const char* type, const RegisterEncoding encodings[3]) {
+    int span = 0;
+    for (int output = 0; output < sensorOutputCount(type); output++) {
+        span += registerEncodingWidth(encodings[output]);
+    }
+    if (strcmp(type, "LIS3DH") == 0) span += LIS3DH_FEATURE_REGISTERS;
+    return span;
+}
+
+// Per-output encodings of a sensors.json / POST entry (int16 when absent)
+void readModbusEncodings(JsonObject sensor, RegisterEncoding encodings[3]) {
+    const char* encodingKeys[] = {"modbusEncoding", "modbusEncodingB", "modbusEncodingC"};
+    for (int output = 0; output < 3; output++) {
+        encodings[output] = registerEncodingFromName(sensor[encodingKeys[output]] | "int16");
+    }
+}
+
+// Read the per-output Modbus encoding of a sensors.json / POST entry
+void readModbusEncoding(JsonObject sensor, SensorConfig& cfg) {
+    const char* scaleKeys[] = {"modbusScale", "modbusScaleB", "modbusScaleC"};
+    readModbusEncodings(sensor, cfg.modbusEncoding);
+    for (int output = 0; output < 3; output++) {
+        cfg.modbusScale[output] = sensor[scaleKeys[output]] | 100.0f;
+    }
+    cfg.modbusWordSwap = sensor["modbusWordSwap"] | false;
+    cfg.modbusByteSwap = sensor["modbusByteSwap"] | false;
+}
+
+// Write the encoding back, omitting defaults to keep the documents small
+void writeModbusEncoding(JsonObject sensor, const SensorConfig& cfg) {
+    const char* encodingKeys[] = {"modbusEncoding", "modbusEncodingB", "modbusEncodingC"};
+    const char* scaleKeys[] = {"modbusScale", "modbusScaleB", "modbusScaleC"};
+    for (int output = 0; output < 3; output++) {
+        if (cfg.modbusEncoding[output] != RegisterEncoding::INT16) sensor[encodingKeys[output]] = registerEncodingName(cfg.modbusEncoding[output]);
+        if (cfg.modbusScale[output] != 100.0f) sensor[scaleKeys[output]] = cfg.modbusScale[output];
+    }
+    if (cfg.modbusWordSwap) sensor["modbusWordSwap"] = true;
+    if (cfg.modbusByteSwap) sensor["modbusByteSwap"] = true;
+}
+
+// Append one output at `address`, which then advances past the registers it takes
+void addRegisterMapEntry(int sensorIndex, int& count, int& address, RegisterSource source, uint8_t feature = 0, bool packed = false) {
+    const SensorConfig& sensor = configuredSensors[sensorIndex];
+    RegisterEncoding encoding;
+    float scale = 1.0f;
+    switch (source) {
+        case RegisterSource::VIBRATION: encoding = RegisterEncoding::RAW16; break;
+        case RegisterSource::QUALITY:   encoding = RegisterEncoding::UINT16; break;
+        case RegisterSource::TIMESTAMP: encoding = RegisterEncoding::UINT32; break;
+        default:
+            encoding = sensor.modbusEncoding[(uint8_t)source];
+            scale = sensor.modbusScale[(uint8_t)source];
+            break;
+    }
+    // layoutRegisterMap() has checked the whole span against the window and other sensors
+    RegisterMapEntry& entry = registerMap[count++];
+    entry.address = address;
+    entry.source = source;
+    entry.feature = feature;
+    entry.encoding = encoding;
+    entry.wordSwap = sensor.modbusWordSwap;
+    entry.byteSwap = sensor.modbusByteSwap;
+    entry.packed = packed;
+    entry.scale = scale;
+    address += registerEncodingWidth(encoding);
+}
+
+// Add a sensor's outputs from `address` in order; 32-bit encodings take two registers.
+// Takes sensorRegisterSpan() registers.
+void addSensorOutputs(int sensorIndex, int& count, int& address, bool packed) {
+    const SensorConfig& sensor = configuredSensors[sensorIndex];
+    for (int output = 0; output < sensorOutputCount(sensor.type); output++) {
+        addRegisterMapEntry(sensorIndex, count, address, (RegisterSource)output, 0, packed);
+    }
+    if (strcmp(sensor.type, "LIS3DH") == 0) {
+        // RMS, peak and crest factor per axis from the FIFO stream
+        for (int f = 0; f < LIS3DH_FEATURE_REGISTERS; f++) {
+            addRegisterMapEntry(sensorIndex, count, address, RegisterSource::VIBRATION, f, packed);
+        }
+    }
+}
+
+// Fill registerMap for every enabled sensor; returns the end of the packed block
+int layoutRegisterMap(bool packed, int& count) {
+    int packedAddress = config.modbusPackedBase + MODBUS_PACKED_HEADER_REGISTERS;
+    bool windowUsed[MODBUS_INPUT_REGISTERS] = {};
+    count = 0;
+    packedSensorCount = 0;
+    registerMapConflictCount = 0;
+    for (int i = 0; i < MAX_SENSORS; i++) {
+        registerMapStart[i] = count;
+        registerMapCount[i] = 0;
+        registerMapConflict[i] = NULL;
+        if (i >= numConfiguredSensors) continue;
+        SensorConfig& sensor = configuredSensors[i];
+        if (!sensor.enabled) continue;
+        
+        // A sensor whose span leaves the window or overlaps an earlier sensor is not mapped at all
+        if (sensor.modbusRegister >= 0) {
+            int address = sensor.modbusRegister;
+            int end = address + sensorRegisterSpan(sensor.type, sensor.modbusEncoding);
+            if (end > MODBUS_INPUT_REGISTERS) {
+                registerMapConflict[i] = "runs past the input register window";
+            } else {
+                for (int r = address; r < end && !registerMapConflict[i]; r++) {
+                    if (windowUsed[r]) registerMapConflict[i] = "overlaps another sensor";
+                }
+            }
+            if (registerMapConflict[i]) {
+                registerMapConflictCount++;
+            } else {
+                for (int r = address; r < end; r++) windowUsed[r] = true;
+                addSensorOutputs(i, count, address, false);
+            }
+        }
+        // Packed record: outputs, quality word, timestamp
+        if (packed) {
+            addSensorOutputs(i, count, packedAddress, true);
+            addRegisterMapEntry(i, count, packedAddress, RegisterSource::QUALITY, 0, true);
+            addRegisterMapEntry(i, count, packedAddress, RegisterSource::TIMESTAMP, 0, true);
+            packedSensorCount++;
+        }
+        registerMapCount[i] = count - registerMapStart[i];
+    }
+    return packedAddress;
+}
+
+// Lay out every enabled sensor's output registers once per config change.
+// Returns NULL, or why the packed block could not be laid out as configured.
+const char* compileRegisterMap() {
+    const char* error = NULL;
+    int count = 0;
+    bool packed = config.modbusPackedEnabled;
+    if (packed && config.modbusPackedBase < MODBUS_INPUT_REGISTERS) {
+        Serial.printf("[Modbus] Packed block base %d overlaps the sensor window (0-%d), block disabled\n",
+                      config.modbusPackedBase, MODBUS_INPUT_REGISTERS - 1);
+        packed = false;
+    }
+    
+    int packedAddress = layoutRegisterMap(packed, count);
+    if (packed && config.modbusPackedBase < MODBUS_DIAG_BASE + MODBUS_DIAG_REGISTERS && packedAddress > MODBUS_DIAG_BASE) {
+        Serial.printf("[Modbus] Packed block %d-%d overlaps the statistics registers (%d-%d), block disabled\n",
+                      config.modbusPackedBase, packedAddress - 1, MODBUS_DIAG_BASE, MODBUS_DIAG_BASE + MODBUS_DIAG_REGISTERS - 1);
+        error = "Packed block overlaps the statistics registers (500-531)";
+        packed = false;
+        packedAddress = layoutRegisterMap(packed, count);
+    }
+    
+    int gatewayEnd = gatewayTableEnd(MODBUS_FC_READ_INPUT_REGISTERS);
+    if (packed && config.modbusPackedBase < gatewayEnd && packedAddress > MODBUS_GATEWAY_BASE) {
+        Serial.printf("[Modbus] Packed block %d-%d overlaps the gateway registers (%d-%d), block disabled\n",
+                      config.modbusPackedBase, packedAddress - 1, MODBUS_GATEWAY_BASE, gatewayEnd - 1);
+        error = "Packed block overlaps the gateway registers";
+        packed = false;
+        packedAddress = layoutRegisterMap(packed, count);
+    }
+    
+    packedRegisterCount = packed ? packedAddress - config.modbusPackedBase : 0;
+    int inputRegisters = max(packed ? packedAddress : MODBUS_INPUT_REGISTERS, MODBUS_DIAG_BASE + MODBUS_DIAG_REGISTERS);
+    inputRegisters = max(inputRegisters, gatewayEnd);
+    if (inputRegisters != modbusInputRegisterCount && !modbusImage.configureInputRegisters(0x00, inputRegisters)) {
+        // The previous table is still allocated and served
+        Serial.printf("[Modbus] No memory for %d input registers\n", inputRegisters);
+        if (packed) {
+            error = "Packed block does not fit in memory at this base";
+            packed = false;
+            packedRegisterCount = 0;
+            layoutRegisterMap(packed, count);
+            inputRegisters = max(MODBUS_DIAG_BASE + MODBUS_DIAG_REGISTERS, gatewayEnd);
+            if (inputRegisters != modbusInputRegisterCount && !modbusImage.configureInputRegisters(0x00, inputRegisters)) {
+                inputRegisters = modbusInputRegisterCount;
+            }
+        } else {
+            inputRegisters = modbusInputRegisterCount;
+        }
+    }
+    modbusInputRegisterCount = inputRegisters;
+    registerImageStale = true;
+    for (int i = 0; i < numConfiguredSensors; i++) {
+        if (!registerMapConflict[i]) continue;
+        const SensorConfig& sensor = configuredSensors[i];
+        Serial.printf("[Modbus] %s: registers %d-%d %s, not mapped\n", sensor.name, sensor.modbusRegister,
+                      sensor.modbusRegister + sensorRegisterSpan(sensor.type, sensor.modbusEncoding) - 1, registerMapConflict[i]);
+    }
+    Serial.printf("[Modbus] Register map compiled: %d entries, %d input registers", count, modbusInputRegisterCount);
+    if (packed) {
+        Serial.printf(", packed block %d-%d", config.modbusPackedBase, packedAddress - 1);
+    }
+    if (registerMapConflictCount > 0) {
+        Serial.printf(", %d sensor(s) not mapped", registerMapConflictCount);
+    }
+    Serial.println();
+    return error;
+}
+
+// Register address of a sensor output in the compiled map, -1 if unmapped
+int registerAddressFor(int sensorIndex, RegisterSource source, uint8_t feature) {
+    for (int e = registerMapStart[sensorIndex]; e < registerMapStart[sensorIndex] + registerMapCount[sensorIndex]; e++) {
+        if (!registerMap[e].packed && registerMap[e].source == source && registerMap[e].feature == feature) return registerMap[e].address;
+    }
+    return -1;
+}
+
+double clampRegisterValue(double value, double low, double high) {
+    if (isnan(value)) return 0;
+    return value < low ? low : (value > high ? high : value);
+}
+
+// What a master reads for output 0-2 (A/B/C) of a sensor, as an integer: the same
+// rounding and clamping as encodeRegisterValue(), so the web UI's modbus_value matches
+int32_t sensorModbusValue(const SensorConfig& sensor, int output, float value) {
+    double scaled = round((double)value * sensor.modbusScale[output]);
+    switch (sensor.modbusEncoding[output]) {
+        case RegisterEncoding::INT16:   return (int32_t)clampRegisterValue(scaled, INT16_MIN, INT16_MAX);
+        case RegisterEncoding::UINT16:  return (int32_t)clampRegisterValue(scaled, 0, UINT16_MAX);
+        case RegisterEncoding::UINT32:  return (int32_t)clampRegisterValue(scaled, 0, INT32_MAX);  // int field
+        case RegisterEncoding::FLOAT32: return (int32_t)clampRegisterValue(round(value), INT32_MIN, INT32_MAX);
+        default:                        return (int32_t)clampRegisterValue(scaled, INT32_MIN, INT32_MAX);
+    }
+}
+
+uint16_t sensorQualityWord(int sensorIndex, const SensorValues& values, uint32_t now) {
+    if (values.readCount == 0) return SENSOR_QUALITY_NO_DATA;
+    uint32_t staleAfter = max((uint32_t)configuredSensors[sensorIndex].updateInterval * 3, (uint32_t)3000);
+    return (now - values.lastReadTime > staleAfter) ? SENSOR_QUALITY_STALE : 0;
+}
+
+// Encode one output into its register words in wire order; returns the word count
+uint8_t encodeRegisterValue(const RegisterMapEntry& entry, int sensorIndex, const SensorValues& values, uint32_t now, uint16_t words[2]) {
+    uint32_t bits;
+    uint8_t width = registerEncodingWidth(entry.encoding);
+    if (entry.source == RegisterSource::QUALITY) {
+        bits = sensorQualityWord(sensorIndex, values, now);
+    } else if (entry.source == RegisterSource::TIMESTAMP) {
+        bits = values.lastReadTime;
+    } else {
+        float value;
+        switch (entry.source) {
+            case RegisterSource::VALUE_A:   value = values.calibratedValue; break;
+            case RegisterSource::VALUE_B:   value = values.calibratedValueB; break;
+            case RegisterSource::VALUE_C:   value = values.calibratedValueC; break;
+            default:                        value = 0; break;
+        }
+        double scaled = round((double)value * entry.scale);
+        
+        switch (entry.encoding) {
+            case RegisterEncoding::INT16:   bits = (uint16_t)(int16_t)clampRegisterValue(scaled, INT16_MIN, INT16_MAX); break;
+            case RegisterEncoding::UINT16:  bits = (uint16_t)clampRegisterValue(scaled, 0, UINT16_MAX); break;
+            case RegisterEncoding::INT32:   bits = (uint32_t)(int32_t)clampRegisterValue(scaled, INT32_MIN, INT32_MAX); break;
+            case RegisterEncoding::UINT32:  bits = (uint32_t)clampRegisterValue(scaled, 0, UINT32_MAX); break;
+            case RegisterEncoding::FLOAT32: memcpy(&bits, &value, sizeof(bits)); break;
+            default:                        bits = (uint16_t)values.vibrationRegisters[entry.feature]; break;
+        }
+    }
     
-    // Update digital inputs
-    for (int i = 0; i < 8; i++) {
-        modbusClients[clientIndex].server.discreteInputWrite(i, ioStatus.dIn[i]);
+    if (width == 2) {
+        // High word first unless swapped
+        words[0] = entry.wordSwap ? (uint16_t)bits : (uint16_t)(bits >> 16);
+        words[1] = entry.wordSwap ? (uint16_t)(bits >> 16) : (uint16_t)bits;
+    } else {
+        words[0] = (uint16_t)bits;
+    }
+    if (entry.byteSwap) {
+        for (uint8_t w = 0; w < width; w++) words[w] = (uint16_t)((words[w] << 8) | (words[w] >> 8));
     }
+    return width;
+}
+
+void writeRegisterEntry(const RegisterMapEntry& entry, int sensorIndex, const SensorValues& values, uint32_t now) {
+    // Both words of a 32-bit value go in one write; requests are served on this
+    // core between passes, so a client never sees half of an update
+    uint16_t words[2];
+    uint8_t width = encodeRegisterValue(entry, sensorIndex, values, now, words);
+    modbusImage.writeInputRegisters(entry.address, words, width);
+}
+
+void updateModbusImage() {
+    // Update the shared Modbus registers with current IO state, actual pin states measured in updateIOpins()
+    uint32_t now = millis();
+    
+    // Update digital inputs
+    modbusImage.writeDiscreteInputBits(0, ioStatus.dIn, 8);
         
     // Update analog inputs
     for (int i = 0; i < 3; i++) {
-        modbusClients[clientIndex].server.inputRegisterWrite(i, ioStatus.aIn[i]);
+        modbusImage.inputRegisterWrite(i, ioStatus.aIn[i]);
     }
     
-    // I2C Sensor Data Modbus Mapping - Convert float values to 16-bit integers
-    // PLACEHOLDER SENSORS - COMMENTED OUT (only enable when simulation is on or real sensors added)
-    // uint16_t temp_x_100 = (uint16_t)(ioStatus.temperature * 100);
-    // uint16_t hum_x_100 = (uint16_t)(ioStatus.humidity * 100);
-
-    // modbusClients[clientIndex].server.inputRegisterWrite(3, temp_x_100); // Temperature
-    // modbusClients[clientIndex].server.inputRegisterWrite(4, hum_x_100); // Humidity
+    // After a layout change, clear registers a sensor may have moved away from and rewrite all
+    if (registerImageStale) {
+        int gatewayEnd = gatewayTableEnd(MODBUS_FC_READ_INPUT_REGISTERS);
+        for (int reg = 3; reg < modbusInputRegisterCount; reg++) {
+            if (reg >= MODBUS_GATEWAY_BASE && reg < gatewayEnd) continue;  // Owned by the gateway polls
+            modbusImage.inputRegisterWrite(reg, 0);
+        }
+        for (int i = 0; i < MAX_SENSORS; i++) {
+            sensorRegistersDirty[i] = true;
+        }
+        lastPackedRefreshMs = now - MODBUS_PACKED_REFRESH_MS;
+        lastDiagRefreshMs = now - MODBUS_DIAG_REFRESH_MS;
+        registerImageStale = false;
+    }
     
-    // Update Modbus registers with configured sensor values
+    // Push registers of sensors that published new values since the last pass
     for (int i = 0; i < numConfiguredSensors; i++) {
-        if (configuredSensors[i].enabled && configuredSensors[i].modbusRegister >= 0) {
-            // Primary value (temperature for SHT30, X for LIS3DH)
-            modbusClients[clientIndex].server.inputRegisterWrite(configuredSensors[i].modbusRegister, configuredSensors[i].modbusValue);
-
-            // Multi-output sensors (SHT30 humidity, BME280 pressure, LIS3DH Y-axis, etc.)
-            if (strcmp(configuredSensors[i].type, "SHT30") == 0) {
-                // Always write humidity to next register
-                modbusClients[clientIndex].server.inputRegisterWrite(configuredSensors[i].modbusRegister + 1, configuredSensors[i].modbusValueB);
-            } else if (strcmp(configuredSensors[i].type, "LIS3DH") == 0) {
-                // 3-axis accelerometer: X, Y, Z on consecutive registers
-                modbusClients[clientIndex].server.inputRegisterWrite(configuredSensors[i].modbusRegister + 1, configuredSensors[i].modbusValueB);
-                modbusClients[clientIndex].server.inputRegisterWrite(configuredSensors[i].modbusRegister + 2, configuredSensors[i].modbusValueC);
-            }
-            // Future: Add BME280 (temp, hum, pressure) and other multi-output sensors here
+        if (!sensorRegistersDirty[i]) continue;
+        sensorRegistersDirty[i] = false;  // Cleared before reading so a concurrent publish is not lost
+        __sync_synchronize();
+        if (registerMapCount[i] == 0) continue;
+        
+        SensorValues values;
+        readSensorValues(i, values);
+        for (int e = registerMapStart[i]; e < registerMapStart[i] + registerMapCount[i]; e++) {
+            writeRegisterEntry(registerMap[e], i, values, now);
         }
     }
     
-    // Check coils 100-107 for latch reset commands
-    for (int i = 0; i < 8; i++) {
-        if (modbusClients[clientIndex].server.coilRead(100 + i)) {
-            // If coil is set to 1, reset the corresponding latch
-            if (config.diLatch[i] && ioStatus.dInLatched[i]) {
-                ioStatus.dInLatched[i] = false;
-                // Update the input state based on the raw input state
-                ioStatus.dIn[i] = ioStatus.dInRaw[i];
-                Serial.printf("Reset latch for digital input %d via Modbus coil %d\n", i, 100 + i);
+    if (now - lastDiagRefreshMs >= MODBUS_DIAG_REFRESH_MS) {
+        lastDiagRefreshMs = now;
+        writeModbusDiagnosticRegisters();
+    }
+    
+    // Packed block header (uptime, sensor count) and quality words age without a new reading
+    if (packedRegisterCount > 0 && now - lastPackedRefreshMs >= MODBUS_PACKED_REFRESH_MS) {
+        lastPackedRefreshMs = now;
+        uint16_t header[MODBUS_PACKED_HEADER_REGISTERS] = {(uint16_t)(now >> 16), (uint16_t)now, (uint16_t)packedSensorCount};
+        modbusImage.writeInputRegisters(config.modbusPackedBase, header, MODBUS_PACKED_HEADER_REGISTERS);
+        for (int i = 0; i < numConfiguredSensors; i++) {
+            for (int e = registerMapStart[i]; e < registerMapStart[i] + registerMapCount[i]; e++) {
+                if (registerMap[e].source != RegisterSource::QUALITY) continue;
+                SensorValues values;
+                readSensorValues(i, values);
+                writeRegisterEntry(registerMap[e], i, values, now);
             }
-            // Reset the coil back to 0 after processing
-            modbusClients[clientIndex].server.coilWrite(100 + i, false);
         }
     }
+    
+    // Check coils 100-107 for latch reset commands
+    uint8_t latchResets = modbusImage.readCoilBits(100, 8);
+    if (latchResets) {
+        // If a coil is set to 1, reset the corresponding latch
+        uint8_t cleared = latchResets & ioStatus.dInLatched;
+        if (cleared) {
+            ioStatus.dInLatched &= ~cleared;
+            // Update the input state based on the raw input state
+            ioStatus.dIn = ioStatus.dInRaw | ioStatus.dInLatched;
+            Serial.printf("Reset latches 0x%02X via Modbus coils 100-107\n", cleared);
+        }
+        // Reset the coils back to 0 after processing
+        modbusImage.writeCoilBits(100, 0, 8);
+    }
 }
 
@@ -0,0 +1,79 @@
+// On-target tests for the RS485 Modbus RTU server (frame transport, as used by
+// src/main.cpp). Run with: pio test -e pico -f test_modbus_rtu_server
+#include <Arduino.h>
+#include <ArduinoModbus.h>
+#include <unity.h>
+
+// An exception reply must not stall the caller (core0 also runs TCP and HTTP)
+#define MAX_EXCEPTION_REPLY_US 5000
+
+static uint8_t reply[MODBUS_RTU_MAX_ADU_LENGTH];
+static int replyLength;
+
+static int captureReply(void* context, const uint8_t* adu, int length) {
+    (void)context;
+    memcpy(reply, adu, length);
+    replyLength = length;
+    return length;
+}
+
+// Modbus CRC-16, appended low byte first
+static int appendCrc(uint8_t* frame, int length) {
+    uint16_t crc = 0xFFFF;
+    for (int i = 0; i < length; i++) {
+        crc ^= frame[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xA001 : crc >> 1;
+        }
+    }
+    frame[length] = crc & 0xFF;
+    frame[length + 1] = crc >> 8;
+    return length + 2;
+}
+
+// Send one request and return how long handleFrame() took
+static uint32_t exchange(uint8_t* frame, int pduLength) {
+    int length = appendCrc(frame, pduLength);
+    replyLength = 0;
+    uint32_t started = micros();
+    TEST_ASSERT_EQUAL(1, ModbusRTUServer.handleFrame(frame, length, started));
+    return micros() - started;
+}
+
+void setUp() {}
+void tearDown() {}
+
+// FC07 (read exception status) is not supported: ILLEGAL_FUNCTION, immediately
+void test_unsupported_function_replies_without_delay() {
+    uint8_t frame[MODBUS_RTU_MAX_ADU_LENGTH] = {0x01, 0x07};
+    uint32_t elapsed = exchange(frame, 2);
+    
+    TEST_ASSERT_LESS_THAN_UINT32(MAX_EXCEPTION_REPLY_US, elapsed);
+    TEST_ASSERT_EQUAL(5, replyLength);
+    TEST_ASSERT_EQUAL_HEX8(0x01, reply[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x87, reply[1]);
+    TEST_ASSERT_EQUAL_HEX8(MODBUS_EXCEPTION_ILLEGAL_FUNCTION, reply[2]);
+}
+
+// FC03 with a quantity of 0: ILLEGAL_DATA_VALUE, immediately
+void test_illegal_quantity_replies_without_delay() {
+    uint8_t frame[MODBUS_RTU_MAX_ADU_LENGTH] = {0x01, 0x03, 0x00, 0x00, 0x00, 0x00};
+    uint32_t elapsed = exchange(frame, 6);
+    
+    TEST_ASSERT_LESS_THAN_UINT32(MAX_EXCEPTION_REPLY_US, elapsed);
+    TEST_ASSERT_EQUAL(5, replyLength);
+    TEST_ASSERT_EQUAL_HEX8(0x83, reply[1]);
+    TEST_ASSERT_EQUAL_HEX8(MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE, reply[2]);
+}
+
+void setup() {
+    delay(2000);  // Let the test runner attach to USB serial
+    UNITY_BEGIN();
+    TEST_ASSERT_EQUAL(1, ModbusRTUServer.begin(1, captureReply, NULL));
+    ModbusRTUServer.configureHoldingRegisters(0, 16);
+    RUN_TEST(test_unsupported_function_replies_without_delay);
+    RUN_TEST(test_illegal_quantity_replies_without_delay);
+    UNITY_END();
+}
+
+void loop() {}